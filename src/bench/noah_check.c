@@ -0,0 +1,238 @@
+#include "pihm.h"
+#include "optparse.h"
+
+// Check of the batched Noah soil moisture solver (SmFlxVec) of VEC=on builds against the scalar solver (SmFlx). A
+// project is read and initialized as in a normal Flux-PIHM simulation. In each trial, soil moisture profiles,
+// groundwater levels, and infiltration, evaporation, transpiration, and lateral runoff of all elements are randomized,
+// and soil moisture is solved by both solvers from the same state. The first ntrial trials have no soil ice. The next
+// ntrial trials add random ice contents to random layers, so that the frozen soil correction of the batched solver is
+// checked. The program exits with an error if the maximum relative error exceeds NOAH_TOL.
+//
+// Usage: noah-check [-n trials] project
+//   e.g., ./noah-check -n 100 ShaleHills
+
+// Global variables
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             resume_mode;
+int             corr_mode;
+int             spinup_mode;
+int             fixed_length;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;               // Default value
+#endif
+
+#if defined(_VEC_)
+# define NOAH_TOL       1E-10               // tolerance of relative errors of the batched soil moisture solver
+
+int             CheckNoah(int, pihm_struct);
+double          RelErr(double, double);
+double          RandFlux(double);
+void            RandSoilState(int, elem_struct *);
+#endif
+
+int main(int argc, char *argv[])
+{
+    int             ntrial = 100;
+    pihm_struct     pihm;
+    N_Vector        CV_Y;
+    void           *cvode_mem;
+    int             option;
+    struct optparse options;
+    struct optparse_long longopts[] = {
+        {"trials", 'n', OPTPARSE_REQUIRED},
+        {0, 0, 0}
+    };
+
+    optparse_init(&options, argv);
+
+    while ((option = optparse_long(&options, longopts, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                ntrial = atoi(options.optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-n trials] project\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.optind >= argc || ntrial <= 0)
+    {
+        fprintf(stderr, "Usage: %s [-n trials] project\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    strcpy(project, argv[options.optind]);
+    verbose_mode = VL_SILENT;
+
+    pihm = (pihm_struct)calloc(1, sizeof(*pihm));
+
+    ReadAlloc(pihm);
+
+    CV_Y = N_VNew(NumStateVar());
+
+    Initialize(pihm, CV_Y, &cvode_mem);
+
+    N_VDestroy(CV_Y);
+    CVodeFree(&cvode_mem);
+
+#if defined(_VEC_)
+    return CheckNoah(ntrial, pihm);
+#else
+    fprintf(stderr, "Error: The batched soil moisture solver can only be checked when compiled with VEC=on.\n");
+    exit(EXIT_FAILURE);
+#endif
+}
+
+#if defined(_VEC_)
+// Compare the batched soil moisture solver with the scalar solver. Soil moisture, fluxes between soil layers, runoff
+// within soil layers, and the frozen ground factor are compared for all elements
+int CheckNoah(int ntrial, pihm_struct pihm)
+{
+    const double    dt = (double)pihm->ctrl.stepsize;
+    elem_struct    *elem_ref;
+    double          err_swc = 0.0;
+    double          err_smc = 0.0;
+    double          err_smflx = 0.0;
+    double          err_runoff3 = 0.0;
+    double          err_fcr = 0.0;
+    double          err_max;
+    int             i, k, kz;
+
+    // Floating-point exceptions are trapped as in model simulations
+#if defined(unix) || defined(__unix__) || defined(__unix)
+    feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+    elem_ref = (elem_struct *)malloc(nelem * sizeof(elem_struct));
+
+    srand(1);
+
+    for (k = 0; k < 2 * ntrial; k++)
+    {
+        for (i = 0; i < nelem; i++)
+        {
+            RandSoilState(k >= ntrial, &pihm->elem[i]);
+        }
+
+        memcpy(elem_ref, pihm->elem, nelem * sizeof(elem_struct));
+
+        for (i = 0; i < nelem; i++)
+        {
+            SmFlx(dt, &elem_ref[i].soil, &elem_ref[i].ps, &elem_ref[i].ws, &elem_ref[i].wf);
+        }
+
+        SmFlxVec(dt, pihm->elem);
+
+        for (i = 0; i < nelem; i++)
+        {
+            const elem_struct *elem = &pihm->elem[i];
+            double          flux_scale;
+
+            // Fluxes between layers are often much smaller than the fluxes through the soil column, thus their errors
+            // are relative to the largest flux of the element
+            flux_scale = fabs(elem_ref[i].wf.eqv_infil) + fabs(elem_ref[i].wf.edir);
+            for (kz = 0; kz < elem->ps.nlayers; kz++)
+            {
+                flux_scale = MAX(flux_scale, fabs(elem_ref[i].wf.smflx[kz]));
+            }
+
+            for (kz = 0; kz < elem->ps.nlayers; kz++)
+            {
+                err_swc = MAX(err_swc, RelErr(elem->ws.swc[kz], elem_ref[i].ws.swc[kz]));
+                err_smc = MAX(err_smc, RelErr(elem->ws.smc[kz], elem_ref[i].ws.smc[kz]));
+
+                if (elem->ps.nwtbl != 0 && flux_scale > 0.0)
+                {
+                    err_smflx = MAX(err_smflx, fabs(elem->wf.smflx[kz] - elem_ref[i].wf.smflx[kz]) / flux_scale);
+                }
+            }
+
+            if (elem->ps.nwtbl != 0)
+            {
+                err_runoff3 = MAX(err_runoff3, (flux_scale > 0.0) ?
+                    fabs(elem->wf.runoff3 - elem_ref[i].wf.runoff3) / flux_scale : 0.0);
+                err_fcr = MAX(err_fcr, RelErr(elem->ps.fcr, elem_ref[i].ps.fcr));
+            }
+        }
+    }
+
+    free(elem_ref);
+
+    printf("Project: %s, %d elements, %d trials without and %d with soil ice\n", project, nelem, ntrial, ntrial);
+    printf("Maximum relative errors of batched soil moisture solver:\n");
+    printf("  %-32s %.3le\n", "soil water content", err_swc);
+    printf("  %-32s %.3le\n", "total soil moisture", err_smc);
+    printf("  %-32s %.3le\n", "soil moisture flux", err_smflx);
+    printf("  %-32s %.3le\n", "runoff within soil layers", err_runoff3);
+    printf("  %-32s %.3le\n", "frozen ground factor", err_fcr);
+
+    err_max = MAX(MAX(MAX(err_swc, err_smc), MAX(err_smflx, err_runoff3)), err_fcr);
+
+    if (err_max > NOAH_TOL)
+    {
+        printf("Error: Relative error exceeds tolerance (%.1le).\n", NOAH_TOL);
+        return EXIT_FAILURE;
+    }
+
+    printf("All errors are within tolerance (%.1le).\n", NOAH_TOL);
+
+    return EXIT_SUCCESS;
+}
+
+// Relative error of x against reference value ref. Both being zero is no error
+double RelErr(double x, double ref)
+{
+    return (x == ref) ? 0.0 : fabs(x - ref) / MAX(fabs(ref), DBL_MIN);
+}
+
+// Random flux: zero, or log-uniformly distributed between 1e-6 of the maximum flux and the maximum flux
+double RandFlux(double max_flux)
+{
+    double          u = (double)rand() / (double)RAND_MAX;
+
+    return (u < 0.1) ? 0.0 : max_flux * pow(10.0, -6.0 * (u - 0.1) / 0.9);
+}
+
+// Random soil moisture state of an element. Unfrozen soil water content of each layer is uniformly distributed between
+// its minimum and saturation. With ice, each layer is frozen with a probability of one half, and its ice content is
+// uniformly distributed between zero and the remaining pore space. Groundwater is uniformly distributed within the
+// soil column, or above the soil column (i.e., all layers are saturated) with a probability of 0.1
+void RandSoilState(int ice, elem_struct *elem)
+{
+    const soil_struct *soil = &elem->soil;
+    double          u = (double)rand() / (double)RAND_MAX;
+    int             kz;
+
+    elem->ws.gw = (u < 0.1) ? 1.1 * soil->depth : soil->depth * (u - 0.1) / 0.9;
+    elem->ps.nwtbl = FindWaterTable(elem->ps.nlayers, elem->ws.gw, elem->ps.soil_depth, elem->ps.satdpth);
+
+    elem->wf.eqv_infil = RandFlux(1.0E-5);
+    elem->wf.edir = RandFlux(1.0E-7);
+
+    for (kz = 0; kz < elem->ps.nlayers; kz++)
+    {
+        double          sice = 0.0;
+
+        elem->ws.swc[kz] = soil->smcmin + SH2OMIN +
+            (soil->smcmax - soil->smcmin - SH2OMIN) * (double)rand() / (double)RAND_MAX;
+
+        if (ice && rand() % 2 == 0)
+        {
+            sice = (soil->smcmax - elem->ws.swc[kz]) * (double)rand() / (double)RAND_MAX;
+        }
+
+        elem->ws.smc[kz] = elem->ws.swc[kz] + sice;
+
+        elem->wf.et[kz] = RandFlux(1.0E-8);
+        elem->wf.runoff2_lyr[kz] = RandFlux(1.0E-8);
+    }
+}
+#endif
@@ -0,0 +1,337 @@
+#include "pihm.h"
+#include "optparse.h"
+
+// Microbenchmark of hydrology right-hand side (RHS) evaluations. A project is read and initialized as in a normal
+// simulation, and Ode() is evaluated repeatedly at the initial state using different numbers of OpenMP threads.
+// Renumbering of elements and river segments can be set using the -r option, which overrides the RENUMBER keyword in
+// the .para file, so that RHS performance can be compared before and after renumbering. Similarly, the -s option
+// overrides the SOIL_TABLE keyword to compare tabulated and closed-form soil hydraulic functions.
+//
+// When compiled with the VEC=on make option, the -c option checks the vectorized overland and channel flow kernels
+// against the scalar functions at the given number of random surface water depths and river stages, instead of running
+// the benchmark. The program exits with an error if the maximum relative error exceeds VEC_TOL.
+//
+// Usage: rhs-bench [-n number_of_evaluations] [-t thread_list] [-r renumber] [-s soil_table] [-c trials] project
+//   e.g., ./rhs-bench -n 2000 -t 1,8,32 -r 1 -s 64 ShaleHills
+
+// Global variables
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             resume_mode;
+int             corr_mode;
+int             spinup_mode;
+int             fixed_length;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;               // Default value
+#endif
+
+#if defined(_VEC_)
+# define VEC_TOL        1E-12               // tolerance of relative errors of vectorized kernels
+
+int             CheckVec(int, pihm_struct);
+double          RelErr(double, double);
+double          RandDepth(double);
+#endif
+
+int main(int argc, char *argv[])
+{
+    const int       NWARMUP = 10;
+    int             neval = 1000;
+    int             renumber = -1;
+    int             soil_table = -1;
+    int             ntrial = 0;
+    char            thread_list[MAXSTRING] = "1,8,32";
+    int             nthread;
+    char           *token;
+    pihm_struct     pihm;
+    N_Vector        CV_Y;
+    N_Vector        CV_Ydot;
+    void           *cvode_mem;
+    double          t0, t1;
+    double          checksum;
+    int             option;
+    struct optparse options;
+    struct optparse_long longopts[] = {
+        {"evaluations", 'n', OPTPARSE_REQUIRED},
+        {"threads",     't', OPTPARSE_REQUIRED},
+        {"renumber",    'r', OPTPARSE_REQUIRED},
+        {"soil-table",  's', OPTPARSE_REQUIRED},
+        {"check",       'c', OPTPARSE_REQUIRED},
+        {0, 0, 0}
+    };
+    int             i, k;
+
+    optparse_init(&options, argv);
+
+    while ((option = optparse_long(&options, longopts, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                neval = atoi(options.optarg);
+                break;
+            case 't':
+                strcpy(thread_list, options.optarg);
+                break;
+            case 'r':
+                renumber = atoi(options.optarg);
+                break;
+            case 's':
+                soil_table = atoi(options.optarg);
+                break;
+            case 'c':
+                ntrial = atoi(options.optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-n number_of_evaluations] [-t thread_list] [-r renumber] [-s soil_table] "
+                    "[-c trials] project\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.optind >= argc || neval <= 0)
+    {
+        fprintf(stderr, "Usage: %s [-n number_of_evaluations] [-t thread_list] [-r renumber] [-s soil_table] "
+            "[-c trials] project\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    strcpy(project, argv[options.optind]);
+    verbose_mode = VL_SILENT;
+
+    pihm = (pihm_struct)calloc(1, sizeof(*pihm));
+
+    ReadAlloc(pihm);
+
+    if (renumber >= 0)
+    {
+        pihm->ctrl.renumber = (renumber > NO_RENUMBER) ? RCM_RENUMBER : NO_RENUMBER;
+    }
+
+    if (soil_table >= 0)
+    {
+        pihm->ctrl.soil_table = soil_table;
+    }
+
+    CV_Y = N_VNew(NumStateVar());
+    CV_Ydot = N_VNew(NumStateVar());
+
+    Initialize(pihm, CV_Y, &cvode_mem);
+
+    // Apply forcing and land surface fluxes at model start time so that RHS contains all flux terms
+    ApplyBc(pihm->ctrl.starttime, &pihm->forc, pihm->elem, pihm->river);
+    ApplyForcing(pihm->ctrl.starttime, &pihm->forc, pihm->elem);
+    IntcpSnowEt(pihm->ctrl.starttime, (double)pihm->ctrl.etstep, &pihm->calib, pihm->elem);
+
+    if (ntrial > 0)
+    {
+#if defined(_VEC_)
+        return CheckVec(ntrial, pihm);
+#else
+        fprintf(stderr, "Error: Vectorized kernels can only be checked when compiled with VEC=on.\n");
+        exit(EXIT_FAILURE);
+#endif
+    }
+
+    printf("Project: %s, %d elements, %d river segments, %d state variables, renumbering %s\n", project, nelem, nriver,
+        NumStateVar(), (pihm->ctrl.renumber == RCM_RENUMBER) ? "RCM" : "none");
+    printf("%8s %12s %14s %14s %22s\n", "threads", "evaluations", "time (s)", "evals/s", "checksum");
+
+    for (token = strtok(thread_list, ","); token != NULL; token = strtok(NULL, ","))
+    {
+        nthread = atoi(token);
+#if defined(_OPENMP)
+        omp_set_num_threads(nthread);
+        nthreads = nthread;
+#else
+        if (nthread != 1)
+        {
+            continue;
+        }
+#endif
+
+        for (i = 0; i < NWARMUP; i++)
+        {
+            Ode(0.0, CV_Y, CV_Ydot, pihm);
+        }
+
+#if defined(_OPENMP)
+        t0 = omp_get_wtime();
+#else
+        t0 = (double)clock() / CLOCKS_PER_SEC;
+#endif
+        for (i = 0; i < neval; i++)
+        {
+            Ode(0.0, CV_Y, CV_Ydot, pihm);
+        }
+#if defined(_OPENMP)
+        t1 = omp_get_wtime();
+#else
+        t1 = (double)clock() / CLOCKS_PER_SEC;
+#endif
+
+        // Checksum of RHS to verify that different layouts and thread counts give the same results
+        checksum = 0.0;
+        for (k = 0; k < NumStateVar(); k++)
+        {
+            checksum += fabs(NV_Ith(CV_Ydot, k));
+        }
+
+        printf("%8d %12d %14.4f %14.1f %22.15e\n", nthread, neval, t1 - t0, (double)neval / (t1 - t0), checksum);
+    }
+
+    N_VDestroy(CV_Y);
+    N_VDestroy(CV_Ydot);
+    CVodeFree(&cvode_mem);
+
+    return EXIT_SUCCESS;
+}
+
+#if defined(_VEC_)
+// Compare vectorized kernels with the scalar functions. Surface water depths and river stages are randomized in each
+// trial, so that all flow regimes (zero flow, free-flowing and submerged weirs, etc.) are covered. The first ntrial
+// trials use the channel shapes of the mesh. The next ntrial trials replace them with synthetic shapes, so that every
+// channel shape is checked at stages below and above bank height, whichever shapes the mesh contains. River shapes
+// are not restored afterwards
+int CheckVec(int ntrial, pihm_struct pihm)
+{
+    hydro_struct   *hydro = &pihm->hydro;
+    river_struct   *river = pihm->river;
+    double          err_ovl = 0.0;
+    double          err_area = 0.0;
+    double          err_perim = 0.0;
+    double          err_chan = 0.0;
+    double          err_bank = 0.0;
+    double          err_max;
+    double          flux[2];
+    int             synthetic;
+    int             i, k;
+
+    // Floating-point exceptions are trapped as in model simulations, so that exceptions raised by either side of
+    // conditional expressions in vectorized kernels are detected
+#if defined(unix) || defined(__unix__) || defined(__unix)
+    feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
+#endif
+
+    srand(1);
+
+    for (k = 0; k < 2 * ntrial; k++)
+    {
+        synthetic = (k >= ntrial);
+
+        for (i = 0; i < nelem; i++)
+        {
+            hydro->surfh[i] = RandDepth(0.5);
+        }
+
+        for (i = 0; i < nriver; i++)
+        {
+            if (synthetic)
+            {
+                // Cycle through all shapes, and alternate stages between below and above bank height for each shape
+                river[i].shp.intrpl_ord = RECTANGLE + (i + k) % (CUBIC - RECTANGLE + 1);
+                hydro->river_order[i] = river[i].shp.intrpl_ord;
+
+                river[i].ws.stage = (((i + k) / (CUBIC - RECTANGLE + 1)) % 2 == 0) ?
+                    RandDepth(river[i].shp.depth) :
+                    river[i].shp.depth * (1.0 + (double)rand() / (double)RAND_MAX);
+            }
+            else
+            {
+                river[i].ws.stage = RandDepth(2.0 * river[i].shp.depth);
+            }
+            hydro->river_stage[i] = river[i].ws.stage;
+            hydro->river_head[i] = (river[i].ws.stage > river[i].shp.depth) ?
+                river[i].topo.zbed + river[i].ws.stage : river[i].topo.zmax;
+        }
+
+        FrictionSlope(hydro);
+        OvlFlowVec(hydro);
+        RiverFlowVec(hydro);
+
+        for (i = 0; i < hydro->nedge_ovl; i++)
+        {
+            OvlFlowEdge(i, hydro, flux);
+            err_ovl = MAX(err_ovl, RelErr(hydro->ovl_flux[2 * i], flux[0]));
+            err_ovl = MAX(err_ovl, RelErr(hydro->ovl_flux[2 * i + 1], flux[1]));
+        }
+
+        for (i = 0; i < nriver; i++)
+        {
+            err_area = MAX(err_area, RelErr(hydro->river_area[i],
+                RiverCrossSectArea(river[i].shp.intrpl_ord, river[i].ws.stage, river[i].shp.coeff)));
+            err_perim = MAX(err_perim, RelErr(hydro->river_perim[i],
+                RiverPerim(river[i].shp.intrpl_ord, river[i].ws.stage, river[i].shp.coeff)));
+
+            if (river[i].down > 0)
+            {
+                err_chan = MAX(err_chan, RelErr(hydro->river_flux[i],
+                    ChannelFlowRiverToRiver(&river[i], &river[river[i].down - 1])));
+            }
+
+            if (river[i].left > 0)
+            {
+                err_bank = MAX(err_bank, RelErr(hydro->bank_flux[2 * i],
+                    OvlFlowElemToRiver(river[i].left - 1, hydro, &river[i])));
+            }
+
+            if (river[i].right > 0)
+            {
+                err_bank = MAX(err_bank, RelErr(hydro->bank_flux[2 * i + 1],
+                    OvlFlowElemToRiver(river[i].right - 1, hydro, &river[i])));
+            }
+        }
+    }
+
+    printf("Project: %s, %d elements, %d river segments, %d trials with mesh and %d with synthetic channel shapes\n",
+        project, nelem, nriver, ntrial, ntrial);
+    printf("Maximum relative errors of vectorized kernels:\n");
+    printf("  %-32s %.3le\n", "overland flow between elements", err_ovl);
+    printf("  %-32s %.3le\n", "river cross-sectional area", err_area);
+    printf("  %-32s %.3le\n", "river wetted perimeter", err_perim);
+    printf("  %-32s %.3le\n", "channel flow between segments", err_chan);
+    printf("  %-32s %.3le\n", "overland flow to river banks", err_bank);
+
+    err_max = MAX(MAX(MAX(err_ovl, err_area), MAX(err_perim, err_chan)), err_bank);
+
+    if (err_max > VEC_TOL)
+    {
+        printf("Error: Relative error exceeds tolerance (%.1le).\n", VEC_TOL);
+        return EXIT_FAILURE;
+    }
+
+    printf("All errors are within tolerance (%.1le).\n", VEC_TOL);
+
+    return EXIT_SUCCESS;
+}
+
+// Relative error of x against reference value ref. Both being zero is no error
+double RelErr(double x, double ref)
+{
+    return (x == ref) ? 0.0 : fabs(x - ref) / MAX(fabs(ref), DBL_MIN);
+}
+
+// Random water depth: negative (as in trial states of the solver), zero, or log-uniformly distributed between 1e-6 of
+// the maximum depth and the maximum depth
+double RandDepth(double max_depth)
+{
+    double          u = (double)rand() / (double)RAND_MAX;
+
+    if (u < 0.05)
+    {
+        return -0.01 * max_depth * u;
+    }
+    else if (u < 0.1)
+    {
+        return 0.0;
+    }
+    else
+    {
+        return max_depth * pow(10.0, -6.0 * (u - 0.1) / 0.9);
+    }
+}
+#endif
@@ -0,0 +1,80 @@
+#!/bin/sh
+# Benchmark driver of MM-PIHM models using synthetic watersheds. Synthetic watersheds of the given sizes are generated
+# using synth-shed, and each model is compiled and run at each thread count. Startup time, model time per simulated
+# day, and right-hand side (RHS) evaluation time are taken from the timing summary (<project>.timing.csv) of each run,
+# and are appended to the result file, so that results of different versions can be compared.
+#
+# Usage: make bench, or sh src/bench/run_bench.sh from the MM-PIHM directory. Settings can be changed using
+# environment variables, e.g.,
+#   BENCH_SIZES="1000 100000" BENCH_THREADS="1 16" make bench
+#
+#   BENCH_SIZES     numbers of elements of synthetic watersheds (default "1000 10000")
+#   BENCH_THREADS   numbers of OpenMP threads (default "1 2 4 8")
+#   BENCH_MODELS    models to be benchmarked (default "pihm flux-pihm rt-flux-pihm flux-pihm-bgc")
+#   BENCH_DAYS      number of simulated days (default 1)
+#   BENCH_CFLAGS    compiler flags (default "-O2 -fopenmp -fcommon")
+#   BENCH_OUT       result file (default output/bench/bench.csv)
+#
+# Result file columns:
+#   version,commit,model,nelem,nriver,threads,days,startup_s,model_s_per_day,rhs_calls,rhs_ms_per_call
+
+SIZES=${BENCH_SIZES:-"1000 10000"}
+THREADS=${BENCH_THREADS:-"1 2 4 8"}
+MODELS=${BENCH_MODELS:-"pihm flux-pihm rt-flux-pihm flux-pihm-bgc"}
+DAYS=${BENCH_DAYS:-1}
+BENCH_CFLAGS=${BENCH_CFLAGS:-"-O2 -fopenmp -fcommon"}
+OUT=${BENCH_OUT:-output/bench/bench.csv}
+
+VERSION=$(grep "VERSION" src/include/pihm.h | awk '{print $3}' | tr -d '"')
+COMMIT=$(git rev-parse --short HEAD 2> /dev/null || echo unknown)
+
+mkdir -p output/bench "$(dirname "$OUT")"
+
+if [ ! -f "$OUT" ]; then
+    echo "version,commit,model,nelem,nriver,threads,days,startup_s,model_s_per_day,rhs_calls,rhs_ms_per_call" > "$OUT"
+fi
+
+# Generate synthetic watersheds. Land cover type 4 (deciduous broadleaf forest) is used so that all models can run
+make clean > /dev/null
+CFLAGS="$BENCH_CFLAGS" make -e synth-shed > /dev/null || exit 1
+
+for size in $SIZES; do
+    ./synth-shed -n "$size" -d "$DAYS" -l 4 "Bench$size" || exit 1
+done
+
+for model in $MODELS; do
+    make clean > /dev/null
+    if ! CFLAGS="$BENCH_CFLAGS" make -e "$model" > /dev/null; then
+        echo "Error compiling $model." >&2
+        continue
+    fi
+
+    for size in $SIZES; do
+        nelem=$(awk 'NR == 1 {print $2}' "input/Bench$size/Bench$size.mesh")
+        nriver=$(awk 'NR == 1 {print $2}' "input/Bench$size/Bench$size.riv")
+
+        for nthread in $THREADS; do
+            outdir="bench/$model.Bench$size.t$nthread"
+            rm -rf "output/$outdir"
+
+            echo "Running $model with $nelem elements using $nthread thread(s) ..."
+            if ! OMP_NUM_THREADS=$nthread "./$model" -o "$outdir" "Bench$size" > "output/bench/$model.Bench$size.t$nthread.log" 2>&1; then
+                echo "Error running $model. See output/bench/$model.Bench$size.t$nthread.log." >&2
+                continue
+            fi
+
+            awk -F, -v prefix="$VERSION,$COMMIT,$model,$nelem,$nriver,$nthread,$DAYS" -v days="$DAYS" '
+                $1 == "step" {step = $4}
+                $1 == "rhs" {rhs_calls = $3; rhs = $4}
+                $1 == "startup" {startup = $4}
+                END {
+                    printf "%s,%.3f,%.3f,%d,%.4f\n", prefix, startup, step / days, rhs_calls,
+                        (rhs_calls > 0) ? 1000.0 * rhs / rhs_calls : 0.0
+                }' "output/$outdir/Bench$size.timing.csv" >> "$OUT"
+        done
+    done
+done
+
+make clean > /dev/null
+
+echo "Benchmark results are written to $OUT."
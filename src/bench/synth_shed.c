@@ -0,0 +1,643 @@
+#include "pihm.h"
+#include "optparse.h"
+
+// Generator of synthetic watersheds for benchmarks. The domain is a V-shaped valley on a structured grid of nx by ny
+// cells, each of which is split into two triangular elements. The main channel runs along the valley bottom, and
+// tributaries run along every TRIB_SPACING-th grid row and drain into the main channel. Element and river segment
+// geometry files (.mesh, .att, .riv, and .cini and .bedrock if they exist in the template project) are generated, in
+// which soil, geology, and land cover types are taken from template elements in turn. All other input files are copied
+// from the template project, and the .para file is modified to simulate the given number of days without ASCII output.
+// Element indices can be shuffled using a random seed, so that element order is similar to that of mesh generators.
+// The land cover type of all elements can be set using the -l option, e.g., to use a land cover type that is defined
+// in Flux-PIHM-BGC.
+//
+// Usage: synth-shed [-n number_of_elements] [-d number_of_days] [-t template] [-s seed] [-l land_cover] project
+//   e.g., ./synth-shed -n 100000 -d 1 Synth100k
+//   writes input/Synth100k/
+
+#define TRIB_SPACING    16                  // number of grid rows between tributaries
+#define CELL_SIZE       20.0                // grid cell size (m)
+#define SOIL_DEPTH      2.0                 // soil depth (m)
+#define BEDROCK_DEPTH   20.0                // depth of bedrock below soil (m)
+#define VALLEY_SLOPE    0.02                // slope along the valley (-)
+#define HILL_SLOPE      0.1                 // slope of hillslopes towards the valley (-)
+#define BASE_ELEV       100.0               // elevation at the outlet (m)
+
+// Global variables
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             resume_mode;
+int             corr_mode;
+int             spinup_mode;
+int             fixed_length;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;               // Default value
+#endif
+
+typedef struct shed_struct
+{
+    int             nx;                     // number of grid columns
+    int             ny;                     // number of grid rows
+    int             nnode;                  // number of nodes
+    int             (*node)[NUM_EDGE];      // element nodes
+    int             (*nabr)[NUM_EDGE];      // element neighbors
+    int            *ind;                    // element indices in input files
+    int             (*seg)[5];              // river segment from and to nodes, down segment, left and right banks
+    int            *trib;                   // flag that indicates a tributary segment
+} shed_struct;
+
+void            BuildShed(int, int, int, shed_struct *);
+void            CopyFile(const char [], const char []);
+void            CopyRest(FILE *, FILE *);
+int             GridElem(int, int, int, int);
+int             GridNode(int, int, int);
+double          NodeElev(int, int, const shed_struct *);
+void            SkipLines(FILE *, int);
+void            WriteAtt(const char [], const char [], int, int);
+void            WriteBedrock(const char [], const char [], int, int, const shed_struct *);
+void            WriteCini(const char [], const char [], int);
+void            WriteMesh(const char [], const shed_struct *);
+void            WritePara(const char [], const char [], int);
+void            WriteRiv(const char [], const char [], int, const shed_struct *);
+
+int main(int argc, char *argv[])
+{
+    const char     *COPY_EXT[] = {"soil", "geol", "meteo", "lai", "calib", "bc", "lsm", "rad", "chem", "cdbs", "prep",
+        "bgc"};
+    int             target = 1000;
+    int             ndays = 1;
+    int             seed = 0;
+    int             lc = 0;
+    int             nelem_tmpl;
+    int             numnode_tmpl;
+    int             nriver_tmpl;
+    int             lno = 0;
+    char            tmpl[MAXSTRING] = "ShaleHills";
+    char            dir[MAXSTRING];
+    char            fn[MAXSTRING];
+    char            tmpl_fn[MAXSTRING];
+    char            cmdstr[MAXSTRING];
+    FILE           *fp;
+    shed_struct     shed;
+    int             option;
+    struct optparse options;
+    struct optparse_long longopts[] = {
+        {"elements",  'n', OPTPARSE_REQUIRED},
+        {"days",      'd', OPTPARSE_REQUIRED},
+        {"template",  't', OPTPARSE_REQUIRED},
+        {"seed",      's', OPTPARSE_REQUIRED},
+        {"landcover", 'l', OPTPARSE_REQUIRED},
+        {0, 0, 0}
+    };
+    int             nx, ny;
+    int             k;
+
+    optparse_init(&options, argv);
+
+    while ((option = optparse_long(&options, longopts, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                target = atoi(options.optarg);
+                break;
+            case 'd':
+                ndays = atoi(options.optarg);
+                break;
+            case 't':
+                strcpy(tmpl, options.optarg);
+                break;
+            case 's':
+                seed = atoi(options.optarg);
+                break;
+            case 'l':
+                lc = atoi(options.optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-n number_of_elements] [-d number_of_days] [-t template] [-s seed] "
+                    "[-l land_cover] project\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.optind >= argc || target < 8 || ndays <= 0)
+    {
+        fprintf(stderr, "Usage: %s [-n number_of_elements] [-d number_of_days] [-t template] [-s seed] "
+            "[-l land_cover] project\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    strcpy(project, argv[options.optind]);
+    verbose_mode = VL_NORMAL;
+
+    // Read template dimensions
+    sprintf(tmpl_fn, "input/%s/%s.mesh", tmpl, tmpl);
+    fp = pihm_fopen(tmpl_fn, "r");
+    NextLine(fp, cmdstr, &lno);
+    ReadKeyword(cmdstr, "NUMELE", 'i', tmpl_fn, lno, &nelem_tmpl);
+    SkipLines(fp, nelem_tmpl + 1);
+    NextLine(fp, cmdstr, &lno);
+    ReadKeyword(cmdstr, "NUMNODE", 'i', tmpl_fn, lno, &numnode_tmpl);
+    fclose(fp);
+
+    sprintf(tmpl_fn, "input/%s/%s.riv", tmpl, tmpl);
+    fp = pihm_fopen(tmpl_fn, "r");
+    lno = 0;
+    NextLine(fp, cmdstr, &lno);
+    ReadKeyword(cmdstr, "NUMRIV", 'i', tmpl_fn, lno, &nriver_tmpl);
+    fclose(fp);
+
+    // Grid dimensions. The main channel requires at least two grid columns
+    nx = MAX((int)ceil(sqrt(0.5 * target)), 2);
+    ny = MAX((int)ceil(0.5 * target / nx), 1);
+
+    BuildShed(nx, ny, seed, &shed);
+
+    sprintf(dir, "input/%s", project);
+    if (pihm_mkdir(dir) != 0 && errno != EEXIST)
+    {
+        pihm_printf(VL_ERROR, "Error creating input directory %s.\n", dir);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    sprintf(fn, "%s/%s.mesh", dir, project);
+    WriteMesh(fn, &shed);
+
+    sprintf(fn, "%s/%s.att", dir, project);
+    sprintf(tmpl_fn, "input/%s/%s.att", tmpl, tmpl);
+    WriteAtt(fn, tmpl_fn, nelem_tmpl, lc);
+
+    sprintf(fn, "%s/%s.riv", dir, project);
+    sprintf(tmpl_fn, "input/%s/%s.riv", tmpl, tmpl);
+    WriteRiv(fn, tmpl_fn, nriver_tmpl, &shed);
+
+    sprintf(fn, "%s/%s.para", dir, project);
+    sprintf(tmpl_fn, "input/%s/%s.para", tmpl, tmpl);
+    WritePara(fn, tmpl_fn, ndays);
+
+    sprintf(tmpl_fn, "input/%s/%s.cini", tmpl, tmpl);
+    if (pihm_access(tmpl_fn, F_OK) != -1)
+    {
+        sprintf(fn, "%s/%s.cini", dir, project);
+        WriteCini(fn, tmpl_fn, nelem_tmpl);
+    }
+
+    sprintf(tmpl_fn, "input/%s/%s.bedrock", tmpl, tmpl);
+    if (pihm_access(tmpl_fn, F_OK) != -1)
+    {
+        sprintf(fn, "%s/%s.bedrock", dir, project);
+        WriteBedrock(fn, tmpl_fn, nelem_tmpl, numnode_tmpl, &shed);
+    }
+
+    for (k = 0; k < (int)(sizeof(COPY_EXT) / sizeof(COPY_EXT[0])); k++)
+    {
+        sprintf(tmpl_fn, "input/%s/%s.%s", tmpl, tmpl, COPY_EXT[k]);
+        if (pihm_access(tmpl_fn, F_OK) != -1)
+        {
+            sprintf(fn, "%s/%s.%s", dir, project, COPY_EXT[k]);
+            CopyFile(fn, tmpl_fn);
+        }
+    }
+
+    pihm_printf(VL_NORMAL, "%s: %d elements, %d river segments, %d simulation day(s).\n", dir, nelem, nriver, ndays);
+
+    free(shed.node);
+    free(shed.nabr);
+    free(shed.ind);
+    free(shed.seg);
+    free(shed.trib);
+
+    return EXIT_SUCCESS;
+}
+
+// Nodes are numbered row by row from the outlet row. Cell (i, j) is split along its diagonal into a lower triangle
+// (element 2 * cell) and an upper triangle (element 2 * cell + 1), both with nodes in counterclockwise order
+int GridNode(int i, int j, int nx)
+{
+    return j * (nx + 1) + i;
+}
+
+// Grid element index of the lower (upper = 0) or upper (upper = 1) triangle of a cell
+int GridElem(int i, int j, int upper, int nx)
+{
+    return 2 * (j * nx + i) + upper;
+}
+
+void BuildShed(int nx, int ny, int seed, shed_struct *shed)
+{
+    int             ic = nx / 2;            // grid column of the main channel
+    int             maxriv;
+    int             i, j, k;
+
+    shed->nx = nx;
+    shed->ny = ny;
+    shed->nnode = (nx + 1) * (ny + 1);
+
+    nelem = 2 * nx * ny;
+
+    shed->node = (int (*)[NUM_EDGE])malloc(nelem * sizeof(int [NUM_EDGE]));
+    shed->nabr = (int (*)[NUM_EDGE])malloc(nelem * sizeof(int [NUM_EDGE]));
+    shed->ind = (int *)malloc(nelem * sizeof(int));
+
+    // Neighbor k is across the edge opposite to node k. Grid element indices are used here, and are converted to
+    // element indices in input files when written
+    for (j = 0; j < ny; j++)
+    {
+        for (i = 0; i < nx; i++)
+        {
+            int             lower = GridElem(i, j, 0, nx);
+            int             upper = GridElem(i, j, 1, nx);
+
+            shed->node[lower][0] = GridNode(i, j, nx);
+            shed->node[lower][1] = GridNode(i + 1, j, nx);
+            shed->node[lower][2] = GridNode(i + 1, j + 1, nx);
+            shed->nabr[lower][0] = (i < nx - 1) ? GridElem(i + 1, j, 1, nx) : -1;
+            shed->nabr[lower][1] = upper;
+            shed->nabr[lower][2] = (j > 0) ? GridElem(i, j - 1, 1, nx) : -1;
+
+            shed->node[upper][0] = GridNode(i, j, nx);
+            shed->node[upper][1] = GridNode(i + 1, j + 1, nx);
+            shed->node[upper][2] = GridNode(i, j + 1, nx);
+            shed->nabr[upper][0] = (j < ny - 1) ? GridElem(i, j + 1, 0, nx) : -1;
+            shed->nabr[upper][1] = (i > 0) ? GridElem(i - 1, j, 0, nx) : -1;
+            shed->nabr[upper][2] = lower;
+        }
+    }
+
+    // Element indices in input files
+    for (k = 0; k < nelem; k++)
+    {
+        shed->ind[k] = k;
+    }
+
+    if (seed != 0)
+    {
+        srand((unsigned int)seed);
+        for (k = nelem - 1; k > 0; k--)
+        {
+            int             swap = rand() % (k + 1);
+            int             temp = shed->ind[k];
+
+            shed->ind[k] = shed->ind[swap];
+            shed->ind[swap] = temp;
+        }
+    }
+
+    // River segments. Main channel segments flow from grid row j + 1 to j, and tributary segments flow towards the
+    // main channel. The main channel is numbered first from the outlet, and each tributary is numbered from its mouth
+    maxriv = ny + (ny / TRIB_SPACING) * nx;
+    shed->seg = (int (*)[5])malloc(maxriv * sizeof(int [5]));
+    shed->trib = (int *)malloc(maxriv * sizeof(int));
+
+    nriver = 0;
+    for (j = 0; j < ny; j++)
+    {
+        shed->seg[nriver][0] = GridNode(ic, j + 1, nx);
+        shed->seg[nriver][1] = GridNode(ic, j, nx);
+        shed->seg[nriver][2] = (j > 0) ? nriver - 1 : ZERO_DPTH_GRAD;
+        shed->seg[nriver][3] = GridElem(ic, j, 1, nx);
+        shed->seg[nriver][4] = GridElem(ic - 1, j, 0, nx);
+        shed->trib[nriver] = 0;
+        nriver++;
+    }
+
+    for (j = TRIB_SPACING; j < ny; j += TRIB_SPACING)
+    {
+        int             mouth = j - 1;      // main channel segment starting from the tributary mouth
+
+        // East tributary
+        for (i = ic; i < nx; i++)
+        {
+            shed->seg[nriver][0] = GridNode(i + 1, j, nx);
+            shed->seg[nriver][1] = GridNode(i, j, nx);
+            shed->seg[nriver][2] = (i > ic) ? nriver - 1 : mouth;
+            shed->seg[nriver][3] = GridElem(i, j - 1, 1, nx);
+            shed->seg[nriver][4] = GridElem(i, j, 0, nx);
+            shed->trib[nriver] = 1;
+            nriver++;
+        }
+
+        // West tributary
+        for (i = ic - 1; i >= 0; i--)
+        {
+            shed->seg[nriver][0] = GridNode(i, j, nx);
+            shed->seg[nriver][1] = GridNode(i + 1, j, nx);
+            shed->seg[nriver][2] = (i < ic - 1) ? nriver - 1 : mouth;
+            shed->seg[nriver][3] = GridElem(i, j, 0, nx);
+            shed->seg[nriver][4] = GridElem(i, j - 1, 1, nx);
+            shed->trib[nriver] = 1;
+            nriver++;
+        }
+    }
+}
+
+// Surface elevation of a V-shaped valley
+double NodeElev(int i, int j, const shed_struct *shed)
+{
+    return BASE_ELEV + VALLEY_SLOPE * CELL_SIZE * j + HILL_SLOPE * CELL_SIZE * abs(i - shed->nx / 2);
+}
+
+void WriteMesh(const char fn[], const shed_struct *shed)
+{
+    FILE           *fp;
+    int            *elem;
+    int             i, j, k;
+
+    fp = pihm_fopen(fn, "w");
+
+    // Grid element of each element index in the file
+    elem = (int *)malloc(nelem * sizeof(int));
+    for (k = 0; k < nelem; k++)
+    {
+        elem[shed->ind[k]] = k;
+    }
+
+    fprintf(fp, "%-8s%d\n", "NUMELE", nelem);
+    fprintf(fp, "%-8s%-8s%-8s%-8s%-8s%-8s%s\n", "INDEX", "NODE1", "NODE2", "NODE3", "NABR1", "NABR2", "NABR3");
+    for (k = 0; k < nelem; k++)
+    {
+        fprintf(fp, "%-8d", k + 1);
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            fprintf(fp, "%-8d", shed->node[elem[k]][j] + 1);
+        }
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            fprintf(fp, (j < NUM_EDGE - 1) ? "%-8d" : "%d\n",
+                (shed->nabr[elem[k]][j] >= 0) ? shed->ind[shed->nabr[elem[k]][j]] + 1 : 0);
+        }
+    }
+
+    fprintf(fp, "%-8s%d\n", "NUMNODE", shed->nnode);
+    fprintf(fp, "%-8s%-16s%-16s%-16s%s\n", "INDEX", "X", "Y", "ZMIN", "ZMAX");
+    fprintf(fp, "%-8s%-16s%-16s%-16s%s\n", "#-", "m", "m", "m", "m");
+    for (j = 0; j <= shed->ny; j++)
+    {
+        for (i = 0; i <= shed->nx; i++)
+        {
+            fprintf(fp, "%-8d%-16.4lf%-16.4lf%-16.3lf%.3lf\n", GridNode(i, j, shed->nx) + 1, CELL_SIZE * i,
+                CELL_SIZE * j, NodeElev(i, j, shed) - SOIL_DEPTH, NodeElev(i, j, shed));
+        }
+    }
+
+    free(elem);
+    fclose(fp);
+}
+
+// Element attributes. Soil, geology, and land cover types are taken from template elements in turn unless a land cover
+// type is given, and all elements use the first forcing and LAI series and no-flow boundary conditions
+void WriteAtt(const char fn[], const char tmpl_fn[], int nelem_tmpl, int lc)
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+    int           (*type)[3];
+    char            cmdstr[MAXSTRING];
+    int             lno = 0;
+    int             index;
+    int             k;
+
+    type = (int (*)[3])malloc(nelem_tmpl * sizeof(int [3]));
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    NextLine(tmpl_fp, cmdstr, &lno);
+    for (k = 0; k < nelem_tmpl; k++)
+    {
+        NextLine(tmpl_fp, cmdstr, &lno);
+        if (sscanf(cmdstr, "%d %d %d %d", &index, &type[k][0], &type[k][1], &type[k][2]) != 4)
+        {
+            pihm_error(ERROR, ERR_WRONG_FORMAT, tmpl_fn, lno);
+        }
+    }
+
+    fp = pihm_fopen(fn, "w");
+
+    fprintf(fp, "%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%s\n", "INDEX", "SOIL", "GEOL", "LC", "METEO", "LAI", "BC1", "BC2",
+        "BC3");
+    for (k = 0; k < nelem; k++)
+    {
+        fprintf(fp, "%-8d%-8d%-8d%-8d%-8d%-8d%-8d%-8d%d\n", k + 1, type[k % nelem_tmpl][0], type[k % nelem_tmpl][1],
+            (lc > 0) ? lc : type[k % nelem_tmpl][2], 1, 1, 0, 0, 0);
+    }
+
+    CopyRest(tmpl_fp, fp);
+
+    free(type);
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+// River segments. Tributaries use the first river shape and the main channel uses the last river shape of the
+// template. Shape, material, and boundary condition blocks are copied from the template
+void WriteRiv(const char fn[], const char tmpl_fn[], int nriver_tmpl, const shed_struct *shed)
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+    char            cmdstr[MAXSTRING];
+    int             lno = 0;
+    int             nshp;
+    long            pos;
+    int             k;
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    SkipLines(tmpl_fp, nriver_tmpl + 2);
+
+    pos = ftell(tmpl_fp);
+    NextLine(tmpl_fp, cmdstr, &lno);
+    ReadKeyword(cmdstr, "SHAPE", 'i', tmpl_fn, lno, &nshp);
+    fseek(tmpl_fp, pos, SEEK_SET);
+
+    fp = pihm_fopen(fn, "w");
+
+    fprintf(fp, "%-8s%d\n", "NUMRIV", nriver);
+    fprintf(fp, "%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%-8s%s\n", "INDEX", "FROM", "TO", "DOWN", "LEFT", "RIGHT", "SHAPE",
+        "MATL", "BC", "RES");
+    for (k = 0; k < nriver; k++)
+    {
+        fprintf(fp, "%-8d%-8d%-8d%-8d%-8d%-8d%-8d%-8d%-8d%d\n", k + 1, shed->seg[k][0] + 1, shed->seg[k][1] + 1,
+            (shed->seg[k][2] >= 0) ? shed->seg[k][2] + 1 : shed->seg[k][2], shed->ind[shed->seg[k][3]] + 1,
+            shed->ind[shed->seg[k][4]] + 1, shed->trib[k] ? 1 : nshp, 1, 0, 0);
+    }
+
+    CopyRest(tmpl_fp, fp);
+
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+// Reactive transport initial conditions. Conditions are taken from template elements in turn, and condition blocks
+// are copied from the template
+void WriteCini(const char fn[], const char tmpl_fn[], int nelem_tmpl)
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+    char          (*line)[MAXSTRING];
+    char            cmdstr[MAXSTRING];
+    int             lno = 0;
+    int             index;
+    int             k;
+
+    line = (char (*)[MAXSTRING])malloc(nelem_tmpl * sizeof(char [MAXSTRING]));
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    fp = pihm_fopen(fn, "w");
+
+    // Header line
+    NextLine(tmpl_fp, cmdstr, &lno);
+    fprintf(fp, "%s", cmdstr);
+
+    // Element conditions without the index column
+    for (k = 0; k < nelem_tmpl; k++)
+    {
+        int             offset;
+
+        NextLine(tmpl_fp, cmdstr, &lno);
+        if (sscanf(cmdstr, "%d%n", &index, &offset) != 1)
+        {
+            pihm_error(ERROR, ERR_WRONG_FORMAT, tmpl_fn, lno);
+        }
+        strcpy(line[k], cmdstr + offset);
+    }
+
+    for (k = 0; k < nelem; k++)
+    {
+        fprintf(fp, "%-8d%s", k + 1, line[k % nelem_tmpl] + strspn(line[k % nelem_tmpl], " \t"));
+    }
+
+    CopyRest(tmpl_fp, fp);
+
+    free(line);
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+// Deep groundwater boundary conditions and bedrock elevations. Output control lines are copied from the template
+void WriteBedrock(const char fn[], const char tmpl_fn[], int nelem_tmpl, int numnode_tmpl, const shed_struct *shed)
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+    int             i, j, k;
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    SkipLines(tmpl_fp, nelem_tmpl + numnode_tmpl + 2);
+
+    fp = pihm_fopen(fn, "w");
+
+    fprintf(fp, "%-8s%-8s%-8s%s\n", "INDEX", "BC1", "BC2", "BC3");
+    for (k = 0; k < nelem; k++)
+    {
+        fprintf(fp, "%-8d%-8d%-8d%d\n", k + 1, 0, 0, 0);
+    }
+
+    fprintf(fp, "\n%-8s%s\n", "INDEX", "ZBED");
+    fprintf(fp, "%-8s%s\n", "#-", "m");
+    for (j = 0; j <= shed->ny; j++)
+    {
+        for (i = 0; i <= shed->nx; i++)
+        {
+            fprintf(fp, "%-8d%.3lf\n", GridNode(i, j, shed->nx) + 1,
+                NodeElev(i, j, shed) - SOIL_DEPTH - BEDROCK_DEPTH);
+        }
+    }
+
+    CopyRest(tmpl_fp, fp);
+
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+// Copy .para file, in which simulation end time is set to the given number of days after start time, and ASCII
+// output and initial condition output are turned off
+void WritePara(const char fn[], const char tmpl_fn[], int ndays)
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+    char            cmdstr[MAXSTRING];
+    char            keyword[MAXSTRING];
+    char            date[MAXSTRING];
+    char            hour[MAXSTRING];
+    char            timestr[MAXSTRING];
+    int             starttime = BADVAL;
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    fp = pihm_fopen(fn, "w");
+
+    while (fgets(cmdstr, MAXSTRING, tmpl_fp) != NULL)
+    {
+        if (sscanf(cmdstr, "%s", keyword) != 1)
+        {
+            fprintf(fp, "%s", cmdstr);
+        }
+        else if (strcmp(keyword, "START") == 0 && sscanf(cmdstr, "%*s %s %s", date, hour) == 2)
+        {
+            sprintf(timestr, "%s %s", date, hour);
+            starttime = StrTime(timestr);
+            fprintf(fp, "%s", cmdstr);
+        }
+        else if (strcmp(keyword, "END") == 0 && starttime != BADVAL)
+        {
+            fprintf(fp, "%-20s%s\n", "END", PIHMTime(starttime + ndays * DAYINSEC).str);
+        }
+        else if (strcmp(keyword, "ASCII_OUTPUT") == 0 || strcmp(keyword, "WRITE_IC") == 0)
+        {
+            fprintf(fp, "%-20s%d\n", keyword, 0);
+        }
+        else
+        {
+            fprintf(fp, "%s", cmdstr);
+        }
+    }
+
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+void CopyFile(const char fn[], const char tmpl_fn[])
+{
+    FILE           *fp;
+    FILE           *tmpl_fp;
+
+    tmpl_fp = pihm_fopen(tmpl_fn, "r");
+    fp = pihm_fopen(fn, "w");
+
+    CopyRest(tmpl_fp, fp);
+
+    fclose(tmpl_fp);
+    fclose(fp);
+}
+
+// Skip the given number of non-blank lines, including comment lines. Blank and comment lines before the next data
+// line are also skipped
+void SkipLines(FILE *fp, int nline)
+{
+    char            cmdstr[MAXSTRING];
+    int             lno = 0;
+    int             k;
+    long            pos;
+
+    for (k = 0; k < nline; k++)
+    {
+        NextLine(fp, cmdstr, &lno);
+    }
+
+    pos = ftell(fp);
+    while (fgets(cmdstr, MAXSTRING, fp) != NULL && !NonBlank(cmdstr))
+    {
+        pos = ftell(fp);
+    }
+    fseek(fp, pos, SEEK_SET);
+}
+
+void CopyRest(FILE *tmpl_fp, FILE *fp)
+{
+    char            buffer[MAXSTRING];
+    size_t          size;
+
+    while ((size = fread(buffer, 1, MAXSTRING, tmpl_fp)) > 0)
+    {
+        fwrite(buffer, 1, size, fp);
+    }
+}
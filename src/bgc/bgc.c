@@ -7,7 +7,6 @@ void DailyBgc(int t, pihm_struct pihm)
     double          co2lvl;
     double          dayl, prev_dayl;
     double          ndep, nfix;
-    spa_data        spa, prev_spa;
     double         *vwc;
     elem_struct    *elem;
     co2control_struct *co2ctrl;
@@ -69,15 +68,9 @@ void DailyBgc(int t, pihm_struct pihm)
         }
     }
 
-    // Calculate daylengths
-    SunPos(t, siteinfo, &spa);
-    SunPos(t - DAYINSEC, siteinfo, &prev_spa);
-
-    dayl = (spa.sunset - spa.sunrise) * 3600.0;
-    dayl = (dayl < 0.0) ? (dayl + 24.0 * 3600.0) : dayl;
-
-    prev_dayl = (prev_spa.sunset - prev_spa.sunrise) * 3600.0;
-    prev_dayl = (prev_dayl < 0.0) ? (prev_dayl + 24.0 * 3600.0) : prev_dayl;
+    // Get day lengths
+    dayl = DayLength(t, siteinfo, &pihm->sun);
+    prev_dayl = DayLength(t - DAYINSEC, siteinfo, &pihm->sun);
 
     // Calculate average soil water content for all model grids
     vwc = (double *)malloc(nelem * sizeof(double));
@@ -197,10 +197,9 @@ void ReadBgcIc(const char fn[], elem_struct elem[], river_struct river[])
     fclose(fp);
 }
 
-void WriteBgcIc(const char outputdir[], elem_struct elem[],
-    river_struct river[])
+void WriteBgcIc(const char outputdir[], const order_struct *order, elem_struct elem[], river_struct river[])
 {
-    int             i;
+    int             i, k;
     FILE           *fp;
     char            fn[MAXSTRING];
 
@@ -209,8 +208,10 @@ void WriteBgcIc(const char outputdir[], elem_struct elem[],
     fp = pihm_fopen(fn, "wb");
     pihm_printf(VL_VERBOSE, "Writing BGC initial conditions.\n");
 
-    for (i = 0; i < nelem; i++)
+    for (k = 0; k < nelem; k++)
     {
+        i = order->elem[k];
+
         RestartOutput(&elem[i].epv, &elem[i].cs, &elem[i].ns, &elem[i].restart_output);
 
         // If initial conditions are obtained using accelerated spinup, adjust soil C pool sizes if needed
@@ -230,8 +231,10 @@ void WriteBgcIc(const char outputdir[], elem_struct elem[],
         fwrite(&(elem[i].restart_output), sizeof(bgcic_struct), 1, fp);
     }
 
-    for (i = 0; i < nriver; i++)
+    for (k = 0; k < nriver; k++)
     {
+        i = order->river[k];
+
         river[i].restart_output.streamn = river[i].ns.streamn;
 
         fwrite(&(river[i].restart_output), sizeof(river_bgcic_struct), 1, fp);
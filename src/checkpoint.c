@@ -0,0 +1,330 @@
+#include "pihm.h"
+#include "cvode_impl.h"                 // CVODE internal memory block
+#include "cvode_ls_impl.h"              // CVODE linear solver interface memory block
+#include "sunnonlinsol/sunnonlinsol_newton.h"
+
+// Checkpoint files contain the complete model and solver state at the end of a model step, so that a simulation that
+// has been stopped (e.g., a preempted job) can be resumed using the -r option, and continues as if it had never been
+// stopped. Besides CVODE state variables, and element and river segment structures, which contain land surface, BGC,
+// Cycles, and RT states, the CVODE Nordsieck history array, step size, order, and counters, and preconditioner or
+// linear solver data are saved. Output files are truncated to their sizes at the checkpoint, and partially averaged
+// output variables are restored. Checkpoint files are binary, and are only valid for the same executable, input files,
+// and number of MPI processes.
+//
+// Checkpoint files are written and read using the same functions, in which the mode (CKPT_WRITE or CKPT_READ)
+// determines the direction of data transfer, so that the file layouts for writing and reading are always the same.
+void WriteCheckpoint(pihm_struct pihm)
+{
+    FILE           *fp;
+    char            fn[MAXSTRING];
+    char            tmp_fn[MAXSTRING + 4];
+
+    CheckpointFn(pihm, fn);
+    sprintf(tmp_fn, "%s.tmp", fn);
+
+    fp = pihm_fopen(tmp_fn, "wb");
+
+    CheckpointState(CKPT_WRITE, pihm, fn, fp);
+
+    fclose(fp);
+
+    // The previous checkpoint file is only replaced when the new one is complete, so that a valid checkpoint file
+    // always exists if the simulation is stopped while writing
+#if defined(_WIN32) || defined(_WIN64)
+    remove(fn);
+#endif
+    if (rename(tmp_fn, fn) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error writing checkpoint file %s.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    pihm_printf(VL_VERBOSE, " Checkpoint written at %s.\n", PIHMTime(pihm->ctrl.tout[pihm->ctrl.cstep]).str);
+}
+
+// Restore model and solver state from checkpoint file. Must be called after output files are opened and solver
+// parameters are set
+void ReadCheckpoint(pihm_struct pihm)
+{
+    FILE           *fp;
+    char            fn[MAXSTRING];
+
+    CheckpointFn(pihm, fn);
+
+    fp = pihm_fopen(fn, "rb");
+    pihm_printf(VL_VERBOSE, " Reading %s\n", fn);
+
+    CheckpointState(CKPT_READ, pihm, fn, fp);
+
+    fclose(fp);
+
+#if defined(_MPI_)
+    int             cstep[2] = {-pihm->ctrl.cstep, pihm->ctrl.cstep};
+
+    // Checkpoint files of all processes must be written at the same model step
+    MPI_Allreduce(MPI_IN_PLACE, cstep, 2, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (-cstep[0] != cstep[1])
+    {
+        pihm_printf(VL_ERROR, "Error: Checkpoint files of MPI processes are written at different model steps.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    // CVODE integrates state variables owned by this process
+    LocalState(NV_DATA(pihm->ctx.CV_Y), &pihm->mpi, NV_DATA_P(pihm->mpi.CV_Yl));
+#endif
+
+    pihm_printf(VL_NORMAL, "Resume simulation from checkpoint at %s.\n\n",
+        PIHMTime(pihm->ctrl.tout[pihm->ctrl.cstep]).str);
+}
+
+// Check whether a checkpoint file exists in the output directory. In MPI mode, checkpoint files are only used when all
+// processes have one
+int FindCheckpoint(const pihm_struct pihm)
+{
+    char            fn[MAXSTRING];
+    int             found;
+
+    CheckpointFn(pihm, fn);
+
+    found = (pihm_access(fn, F_OK) != -1) ? 1 : 0;
+
+#if defined(_MPI_)
+    MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    if (!found)
+    {
+        pihm_printf(VL_NORMAL, "No checkpoint file found in %srestart/. Simulation starts from the beginning.\n\n",
+            pihm->ctx.outputdir);
+    }
+
+    return found;
+}
+
+void CheckpointFn(const pihm_struct pihm, char fn[])
+{
+#if defined(_MPI_)
+    sprintf(fn, "%srestart/%s.%d.ckpt", pihm->ctx.outputdir, project, pihm->mpi.rank);
+#else
+    sprintf(fn, "%srestart/%s.ckpt", pihm->ctx.outputdir, project);
+#endif
+}
+
+void CheckpointState(int mode, pihm_struct pihm, const char fn[], FILE *fp)
+{
+    CheckpointHeader(mode, pihm, fn, fp);
+
+    CheckpointModel(mode, pihm, fp);
+
+    CheckpointOutput(mode, &pihm->print, fp);
+
+    if (pihm->ctrl.precond == BLOCK_PRECOND)
+    {
+        CheckpointPrec(mode, &pihm->prec, fp);
+    }
+
+#if defined(_MPI_)
+    CheckpointCVode(mode, pihm->ctx.cvode_mem, pihm->mpi.nlocal, fp);
+#else
+    CheckpointCVode(mode, pihm->ctx.cvode_mem, NumStateVar(), fp);
+#endif
+}
+
+// Model dimensions and settings that determine the layout of checkpoint files are stored in the file header, and are
+// checked when reading
+void CheckpointHeader(int mode, const pihm_struct pihm, const char fn[], FILE *fp)
+{
+    char            magic[8];
+    int             header[] = {
+        nelem, nriver, NumStateVar(), (int)sizeof(elem_struct), (int)sizeof(river_struct), pihm->print.nprint,
+        pihm->ctrl.starttime, pihm->ctrl.endtime, pihm->ctrl.stepsize, pihm->ctrl.precond,
+#if defined(_MPI_)
+        pihm->ctrl.renumber, pihm->mpi.nprocs
+#else
+        pihm->ctrl.renumber, 1
+#endif
+    };
+    int             saved[sizeof(header) / sizeof(int)];
+
+    memcpy(magic, CKPT_MAGIC, 8);
+    memcpy(saved, header, sizeof(header));
+
+    CheckpointIo(mode, magic, sizeof(char), 8, fp);
+    if (strncmp(magic, CKPT_MAGIC, 8) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error: %s is not a checkpoint file.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    CheckpointIo(mode, saved, sizeof(int), sizeof(header) / sizeof(int), fp);
+    if (memcmp(saved, header, sizeof(header)) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error: Checkpoint file %s does not match the model configuration.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+}
+
+void CheckpointModel(int mode, pihm_struct pihm, FILE *fp)
+{
+    CheckpointIo(mode, &pihm->ctrl.cstep, sizeof(int), 1, fp);
+    CheckpointIo(mode, &pihm->ctrl.maxstep, sizeof(double), 1, fp);
+
+    CheckpointIo(mode, &pihm->ctx.maxstep_stat, sizeof(cvstat_struct), 1, fp);
+    CheckpointIo(mode, &pihm->ctx.perf_stat, sizeof(cvstat_struct), 1, fp);
+    CheckpointIo(mode, &pihm->ctx.tot_strg_prev, sizeof(double), 1, fp);
+    CheckpointIo(mode, &pihm->ctx.wb_error, sizeof(double), 1, fp);
+#if defined(_BGC_)
+    CheckpointIo(mode, &first_balance, sizeof(int), 1, fp);
+#endif
+
+    // Element and river segment structures are saved as they are. The only pointers they contain are those to the
+    // soil hydraulic function tables, which are restored after reading
+    CheckpointIo(mode, pihm->elem, sizeof(elem_struct), nelem, fp);
+    CheckpointIo(mode, pihm->river, sizeof(river_struct), nriver, fp);
+    if (mode == CKPT_READ)
+    {
+        LinkVgTbl(pihm->nvgtbl, pihm->vgtbl, pihm->elem);
+    }
+
+    CheckpointIo(mode, NV_DATA(pihm->ctx.CV_Y), sizeof(realtype), NumStateVar(), fp);
+}
+
+void CheckpointOutput(int mode, print_struct *print, FILE *fp)
+{
+    int             i;
+
+    if (mode == CKPT_WRITE)
+    {
+        // Binary output records must be written to disk before output file sizes are saved
+        SyncWriter(print->nprint, print->varctrl, &print->writer);
+    }
+
+    for (i = 0; i < print->nprint; i++)
+    {
+        int             nvar = print->varctrl[i].nvar;
+
+        CheckpointIo(mode, &nvar, sizeof(int), 1, fp);
+        if (nvar != print->varctrl[i].nvar)
+        {
+            pihm_printf(VL_ERROR, "Error: Checkpoint file does not match output variable %s.\n",
+                print->varctrl[i].name);
+            pihm_exit(EXIT_FAILURE);
+        }
+
+        CheckpointIo(mode, print->varctrl[i].buffer, sizeof(double), nvar, fp);
+        CheckpointIo(mode, &print->varctrl[i].counter, sizeof(int), 1, fp);
+
+        CheckpointFile(mode, print->varctrl[i].datfile, fp);
+        CheckpointFile(mode, print->varctrl[i].idxfile, fp);
+        CheckpointFile(mode, print->varctrl[i].txtfile, fp);
+    }
+
+    CheckpointFile(mode, print->watbal_file, fp);
+    CheckpointFile(mode, print->cvodeperf_file, fp);
+    CheckpointFile(mode, print->timing_file, fp);
+}
+
+// Save the size of an output file, or truncate the output file to the saved size so that output written after the
+// checkpoint is discarded. Output files that are not open (size -1) are skipped
+void CheckpointFile(int mode, FILE *out, FILE *fp)
+{
+    long            size = -1;
+
+    if (mode == CKPT_WRITE && out != NULL)
+    {
+        fflush(out);
+        size = ftell(out);
+    }
+
+    CheckpointIo(mode, &size, sizeof(long), 1, fp);
+
+    if (mode == CKPT_READ && out != NULL && size >= 0)
+    {
+        fflush(out);
+        if (pihm_ftruncate(out, size) != 0)
+        {
+            pihm_printf(VL_ERROR, "Error truncating output files to checkpoint.\n");
+            pihm_exit(EXIT_FAILURE);
+        }
+        fseek(out, 0, SEEK_END);
+    }
+}
+
+// Save or restore CVODE history, step size and order selection data, and counters. CVODE initializes the linear and
+// nonlinear solvers at its first call (i.e., when no step has been taken). Because restored CVODE memory has taken
+// steps, the initialization is performed here before the history is restored
+void CheckpointCVode(int mode, void *cvode_mem, sunindextype n, FILE *fp)
+{
+    CVodeMem        cv_mem = (CVodeMem)cvode_mem;
+    CVLsMem         cvls_mem = (CVLsMem)cv_mem->cv_lmem;
+    SUNNonlinearSolverContent_Newton nls = (SUNNonlinearSolverContent_Newton)cv_mem->NLS->content;
+    int            *ivar[] = {
+        &cv_mem->cv_q, &cv_mem->cv_qprime, &cv_mem->cv_next_q, &cv_mem->cv_qwait, &cv_mem->cv_L, &cv_mem->cv_nhnil,
+        &cv_mem->cv_qu, &cv_mem->cv_indx_acor, &cv_mem->cv_nscon, &cv_mem->convfail, &cv_mem->cv_tstopset,
+        &cv_mem->cv_jcur, &cvls_mem->jbad
+    };
+    realtype       *rvar[] = {
+        &cv_mem->cv_hin, &cv_mem->cv_h, &cv_mem->cv_hprime, &cv_mem->cv_next_h, &cv_mem->cv_eta, &cv_mem->cv_hscale,
+        &cv_mem->cv_tn, &cv_mem->cv_tretlast, &cv_mem->cv_rl1, &cv_mem->cv_gamma, &cv_mem->cv_gammap,
+        &cv_mem->cv_gamrat, &cv_mem->cv_crate, &cv_mem->cv_delp, &cv_mem->cv_acnrm, &cv_mem->cv_hmax_inv,
+        &cv_mem->cv_etamax, &cv_mem->cv_etaqm1, &cv_mem->cv_etaq, &cv_mem->cv_etaqp1, &cv_mem->cv_h0u, &cv_mem->cv_hu,
+        &cv_mem->cv_saved_tq5, &cv_mem->cv_tolsf, &cv_mem->cv_tstop, &cv_mem->cv_toutc
+    };
+    long int       *lvar[] = {
+        &cv_mem->cv_nst, &cv_mem->cv_nfe, &cv_mem->cv_ncfn, &cv_mem->cv_netf, &cv_mem->cv_nni, &cv_mem->cv_nsetups,
+        &cv_mem->cv_nstlp, &cv_mem->cv_nor, &cvls_mem->nje, &cvls_mem->nfeDQ, &cvls_mem->nstlj, &cvls_mem->npe,
+        &cvls_mem->nli, &cvls_mem->nps, &cvls_mem->ncfl, &cvls_mem->njtsetup, &cvls_mem->njtimes, &nls->niters,
+        &nls->nconvfails
+    };
+    int             i;
+
+    if (mode == CKPT_READ)
+    {
+        cv_mem->cv_e_data = (cv_mem->cv_user_efun) ? cv_mem->cv_user_data : cv_mem;
+
+        if ((cv_mem->cv_linit != NULL && cv_mem->cv_linit(cv_mem) != 0) || cvNlsInit(cv_mem) != CV_SUCCESS)
+        {
+            pihm_printf(VL_ERROR, "Error initializing CVODE solvers from checkpoint.\n");
+            pihm_exit(EXIT_FAILURE);
+        }
+    }
+
+    for (i = 0; i < (int)(sizeof(ivar) / sizeof(ivar[0])); i++)
+    {
+        CheckpointIo(mode, ivar[i], sizeof(int), 1, fp);
+    }
+    for (i = 0; i < (int)(sizeof(rvar) / sizeof(rvar[0])); i++)
+    {
+        CheckpointIo(mode, rvar[i], sizeof(realtype), 1, fp);
+    }
+    for (i = 0; i < (int)(sizeof(lvar) / sizeof(lvar[0])); i++)
+    {
+        CheckpointIo(mode, lvar[i], sizeof(long int), 1, fp);
+    }
+
+    CheckpointIo(mode, cv_mem->cv_tau, sizeof(realtype), L_MAX + 1, fp);
+    CheckpointIo(mode, cv_mem->cv_tq, sizeof(realtype), NUM_TESTS + 1, fp);
+    CheckpointIo(mode, cv_mem->cv_l, sizeof(realtype), L_MAX, fp);
+    CheckpointIo(mode, cv_mem->cv_ssdat, sizeof(realtype), 6 * 4, fp);
+
+    // Nordsieck history array, error weights, and accumulated corrections
+    for (i = 0; i <= cv_mem->cv_qmax; i++)
+    {
+        CheckpointIo(mode, N_VGetArrayPointer(cv_mem->cv_zn[i]), sizeof(realtype), n, fp);
+    }
+    CheckpointIo(mode, N_VGetArrayPointer(cv_mem->cv_ewt), sizeof(realtype), n, fp);
+    CheckpointIo(mode, N_VGetArrayPointer(cv_mem->cv_acor), sizeof(realtype), n, fp);
+}
+
+void CheckpointIo(int mode, void *ptr, size_t size, size_t n, FILE *fp)
+{
+    size_t          nio;
+
+    nio = (mode == CKPT_WRITE) ? fwrite(ptr, size, n, fp) : fread(ptr, size, n, fp);
+
+    if (nio != n)
+    {
+        pihm_printf(VL_ERROR, "Error %s checkpoint file.\n", (mode == CKPT_WRITE) ? "writing" : "reading");
+        pihm_exit(EXIT_FAILURE);
+    }
+}
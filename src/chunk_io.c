@@ -0,0 +1,494 @@
+#include "pihm.h"
+
+// Chunked output format. Records of model output variables are written in frames, each of which holds a batch of
+// records. Within a frame, variables (columns) are grouped into blocks of CHUNK_COLS columns. Each block stores the
+// time series of its columns contiguously (column-major), with bytes of doubles shuffled into byte planes and then
+// compressed using an LZ77 byte compressor. A single time slice or a single column time series can therefore be read
+// by decompressing one block per frame. The offset and time range of each frame are also written to a frame index file
+// (.idx), so that the frame of a time slice is found without reading the frames before it. Layout (native byte order,
+// same as .dat files):
+//
+//   File header:  char magic[8] = CHUNK_MAGIC, int32 nvar, int32 ncol_blk
+//   Frame:        int32 nrec, int32 nblk, double time[nrec], int64 size[nblk], block[nblk]
+//   Block:        uint8 method (CHUNK_RAW or CHUNK_LZ), followed by data of (size - 1) bytes
+//   Index header: char magic[8] = CHUNK_IDX_MAGIC
+//   Index entry:  int64 offset (of frame), double time[2] (of first and last records of frame)
+#define HASH_BITS           12
+#define MIN_MATCH           4
+#define MAX_OFFSET          65535
+
+void WriteChunkHeader(int nvar, FILE *fp)
+{
+    int32_t         ncol[2];
+
+    ncol[0] = nvar;
+    ncol[1] = CHUNK_COLS;
+
+    fwrite(CHUNK_MAGIC, sizeof(char), 8, fp);
+    fwrite(ncol, sizeof(int32_t), 2, fp);
+    fflush(fp);
+}
+
+void WriteChunkIndexHeader(FILE *fp)
+{
+    fwrite(CHUNK_IDX_MAGIC, sizeof(char), 8, fp);
+    fflush(fp);
+}
+
+int ReadChunkHeader(FILE *fp, int *nvar, int *ncol_blk)
+{
+    char            magic[8];
+    int32_t         ncol[2];
+
+    if (fread(magic, sizeof(char), 8, fp) != 8 || strncmp(magic, CHUNK_MAGIC, 8) != 0 ||
+        fread(ncol, sizeof(int32_t), 2, fp) != 2)
+    {
+        return -1;
+    }
+
+    *nvar = ncol[0];
+    *ncol_blk = ncol[1];
+
+    return 0;
+}
+
+int ReadChunkIndexHeader(FILE *fp)
+{
+    char            magic[8];
+
+    if (fread(magic, sizeof(char), 8, fp) != 8 || strncmp(magic, CHUNK_IDX_MAGIC, 8) != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Write a frame of nrec records, and its entry in the frame index. Each record contains model time followed by nvar
+// variables, i.e., the .dat layout
+void WriteChunk(int nvar, int nrec, const double recbuf[], FILE *fp, FILE *idx_fp)
+{
+    int             nblk;
+    int             kblk;
+    int32_t         head[2];
+    int64_t         offset;
+    double          trange[2];
+    int64_t        *size;
+    double         *time;
+    double         *col;
+    unsigned char  *plane;
+    unsigned char  *frame;
+    size_t          frame_size = 0;
+    size_t          max_blk;
+
+    nblk = (nvar + CHUNK_COLS - 1) / CHUNK_COLS;
+    max_blk = (size_t)MIN(nvar, CHUNK_COLS) * nrec * sizeof(double);
+
+    time = (double *)malloc(nrec * sizeof(double));
+    size = (int64_t *)malloc(nblk * sizeof(int64_t));
+    col = (double *)malloc(max_blk);
+    plane = (unsigned char *)malloc(max_blk);
+    frame = (unsigned char *)malloc(nblk * (1 + LzBound(max_blk)));
+    if (time == NULL || size == NULL || col == NULL || plane == NULL || frame == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for chunked output.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    for (kblk = 0; kblk < nrec; kblk++)
+    {
+        time[kblk] = recbuf[(size_t)kblk * (nvar + 1)];
+    }
+
+    for (kblk = 0; kblk < nblk; kblk++)
+    {
+        int             j0, j1;
+        int             j, k;
+        size_t          nbytes;
+        size_t          csize;
+
+        j0 = kblk * CHUNK_COLS;
+        j1 = MIN(j0 + CHUNK_COLS, nvar);
+        nbytes = (size_t)(j1 - j0) * nrec * sizeof(double);
+
+        // Transpose records into column time series
+        for (j = j0; j < j1; j++)
+        {
+            for (k = 0; k < nrec; k++)
+            {
+                col[(size_t)(j - j0) * nrec + k] = recbuf[(size_t)k * (nvar + 1) + j + 1];
+            }
+        }
+
+        Shuffle((const unsigned char *)col, nbytes / sizeof(double), plane);
+        csize = LzCompress(plane, nbytes, frame + frame_size + 1);
+
+        if (csize < nbytes)
+        {
+            frame[frame_size] = CHUNK_LZ;
+        }
+        else
+        {
+            // Incompressible blocks are stored as raw column time series
+            frame[frame_size] = CHUNK_RAW;
+            memcpy(frame + frame_size + 1, col, nbytes);
+            csize = nbytes;
+        }
+
+        size[kblk] = (int64_t)(csize + 1);
+        frame_size += csize + 1;
+    }
+
+    head[0] = nrec;
+    head[1] = nblk;
+    offset = (int64_t)ftell(fp);
+    trange[0] = time[0];
+    trange[1] = time[nrec - 1];
+    if (fwrite(head, sizeof(int32_t), 2, fp) != 2 || fwrite(time, sizeof(double), nrec, fp) != (size_t)nrec ||
+        fwrite(size, sizeof(int64_t), nblk, fp) != (size_t)nblk ||
+        fwrite(frame, sizeof(unsigned char), frame_size, fp) != frame_size)
+    {
+        pihm_printf(VL_ERROR, "Error writing chunked output files.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    // The index entry is written after the frame is complete
+    fflush(fp);
+    if (fwrite(&offset, sizeof(int64_t), 1, idx_fp) != 1 || fwrite(trange, sizeof(double), 2, idx_fp) != 2)
+    {
+        pihm_printf(VL_ERROR, "Error writing chunked output frame index files.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+    fflush(idx_fp);
+
+    free(time);
+    free(size);
+    free(col);
+    free(plane);
+    free(frame);
+}
+
+// Read the header of the next frame. Arrays of times and block sizes are reallocated to hold the frame. On return, the
+// file position is at the beginning of the first block. Returns -1 at end of file
+int ReadChunk(FILE *fp, int *nrec, int *nblk, double **time, int64_t **size)
+{
+    int32_t         head[2];
+
+    if (fread(head, sizeof(int32_t), 2, fp) != 2 || head[0] < 1 || head[1] < 1)
+    {
+        return -1;
+    }
+
+    *nrec = head[0];
+    *nblk = head[1];
+    *time = (double *)realloc(*time, *nrec * sizeof(double));
+    *size = (int64_t *)realloc(*size, *nblk * sizeof(int64_t));
+
+    if (*time == NULL || *size == NULL || fread(*time, sizeof(double), *nrec, fp) != (size_t)*nrec ||
+        fread(*size, sizeof(int64_t), *nblk, fp) != (size_t)*nblk)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Find the frame that contains model time t using binary search of the frame index, whose entries are in time order.
+// Returns -1 if no frame contains t
+int FindChunkFrame(FILE *idx_fp, double t, int64_t *offset)
+{
+    const long      entry_size = sizeof(int64_t) + 2 * sizeof(double);
+    long            lo = 0;
+    long            hi;
+    double          trange[2];
+
+    if (fseek(idx_fp, 0, SEEK_END) != 0)
+    {
+        return -1;
+    }
+    hi = (ftell(idx_fp) - 8) / entry_size;
+
+    // Find the first frame whose last record is not earlier than t
+    while (lo < hi)
+    {
+        long            mid = lo + (hi - lo) / 2;
+
+        if (fseek(idx_fp, 8 + mid * entry_size + (long)sizeof(int64_t), SEEK_SET) != 0 ||
+            fread(trange, sizeof(double), 2, idx_fp) != 2)
+        {
+            return -1;
+        }
+
+        if (trange[1] < t)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    if (fseek(idx_fp, 8 + lo * entry_size, SEEK_SET) != 0 || fread(offset, sizeof(int64_t), 1, idx_fp) != 1 ||
+        fread(trange, sizeof(double), 2, idx_fp) != 2 || t < trange[0] || t > trange[1])
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+// Read and decompress one block of a frame into column time series (column-major, ncol by nrec). The file position
+// should be at the beginning of the first block of the frame, and is restored on return
+int ReadChunkBlock(FILE *fp, int nrec, int ncol, int kblk, const int64_t size[], double col[])
+{
+    int             k;
+    long            pos;
+    int64_t         offset = 0;
+    size_t          nbytes;
+    unsigned char  *buf;
+    unsigned char  *plane;
+    int             error = 0;
+
+    pos = ftell(fp);
+    for (k = 0; k < kblk; k++)
+    {
+        offset += size[k];
+    }
+
+    nbytes = (size_t)ncol * nrec * sizeof(double);
+    buf = (unsigned char *)malloc(size[kblk]);
+    plane = (unsigned char *)malloc(nbytes);
+
+    if (buf == NULL || plane == NULL || fseek(fp, pos + (long)offset, SEEK_SET) != 0 ||
+        fread(buf, sizeof(unsigned char), size[kblk], fp) != (size_t)size[kblk])
+    {
+        error = -1;
+    }
+    else if (buf[0] == CHUNK_RAW && (size_t)size[kblk] - 1 == nbytes)
+    {
+        memcpy(col, buf + 1, nbytes);
+    }
+    else if (buf[0] == CHUNK_LZ && LzDecompress(buf + 1, size[kblk] - 1, plane, nbytes) == nbytes)
+    {
+        Unshuffle(plane, nbytes / sizeof(double), (unsigned char *)col);
+    }
+    else
+    {
+        error = -1;
+    }
+
+    fseek(fp, pos, SEEK_SET);
+    free(buf);
+    free(plane);
+
+    return error;
+}
+
+// Move file position from the first block of a frame to the beginning of the next frame
+int SkipChunk(FILE *fp, int nblk, const int64_t size[])
+{
+    int             k;
+    int64_t         offset = 0;
+
+    for (k = 0; k < nblk; k++)
+    {
+        offset += size[k];
+    }
+
+    return fseek(fp, (long)offset, SEEK_CUR);
+}
+
+// Group byte k of all doubles into byte plane k, so that the slowly varying sign, exponent, and leading mantissa bytes
+// form long repeated runs
+void Shuffle(const unsigned char src[], size_t n, unsigned char dst[])
+{
+    size_t          i;
+    size_t          k;
+
+    for (i = 0; i < n; i++)
+    {
+        for (k = 0; k < sizeof(double); k++)
+        {
+            dst[k * n + i] = src[i * sizeof(double) + k];
+        }
+    }
+}
+
+void Unshuffle(const unsigned char src[], size_t n, unsigned char dst[])
+{
+    size_t          i;
+    size_t          k;
+
+    for (i = 0; i < n; i++)
+    {
+        for (k = 0; k < sizeof(double); k++)
+        {
+            dst[i * sizeof(double) + k] = src[k * n + i];
+        }
+    }
+}
+
+// Maximum compressed size of n bytes
+size_t LzBound(size_t n)
+{
+    return n + n / 255 + 16;
+}
+
+void LzLength(size_t len, unsigned char dst[], size_t *op)
+{
+    while (len >= 255)
+    {
+        dst[(*op)++] = 255;
+        len -= 255;
+    }
+    dst[(*op)++] = (unsigned char)len;
+}
+
+// LZ77 compression using LZ4-style sequences. Each sequence is a token (high 4 bits: number of literals, low 4 bits:
+// match length - MIN_MATCH, 15 = extended by following bytes), literals, 2-byte match offset, and extended match
+// length. The last sequence only contains literals. Returns compressed size
+size_t LzCompress(const unsigned char src[], size_t n, unsigned char dst[])
+{
+    int             table[1 << HASH_BITS];
+    size_t          ip = 0;
+    size_t          anchor = 0;
+    size_t          op = 0;
+    size_t          nlit;
+    int             k;
+
+    for (k = 0; k < (1 << HASH_BITS); k++)
+    {
+        table[k] = -1;
+    }
+
+    while (n >= MIN_MATCH && ip <= n - MIN_MATCH)
+    {
+        uint32_t        seq;
+        uint32_t        hash;
+        int             ref;
+
+        memcpy(&seq, src + ip, sizeof(uint32_t));
+        hash = (seq * 2654435761U) >> (32 - HASH_BITS);
+        ref = table[hash];
+        table[hash] = (int)ip;
+
+        if (ref >= 0 && ip - ref <= MAX_OFFSET && memcmp(src + ref, src + ip, MIN_MATCH) == 0)
+        {
+            size_t          len = MIN_MATCH;
+            size_t          offset = ip - ref;
+
+            while (ip + len < n && src[ref + len] == src[ip + len])
+            {
+                len++;
+            }
+
+            nlit = ip - anchor;
+            dst[op++] = (unsigned char)((MIN(nlit, 15) << 4) | MIN(len - MIN_MATCH, 15));
+            if (nlit >= 15)
+            {
+                LzLength(nlit - 15, dst, &op);
+            }
+            memcpy(dst + op, src + anchor, nlit);
+            op += nlit;
+
+            dst[op++] = (unsigned char)(offset & 0xff);
+            dst[op++] = (unsigned char)(offset >> 8);
+            if (len - MIN_MATCH >= 15)
+            {
+                LzLength(len - MIN_MATCH - 15, dst, &op);
+            }
+
+            ip += len;
+            anchor = ip;
+        }
+        else
+        {
+            ip++;
+        }
+    }
+
+    // Last literals
+    nlit = n - anchor;
+    dst[op++] = (unsigned char)(MIN(nlit, 15) << 4);
+    if (nlit >= 15)
+    {
+        LzLength(nlit - 15, dst, &op);
+    }
+    memcpy(dst + op, src + anchor, nlit);
+    op += nlit;
+
+    return op;
+}
+
+// Decompress LzCompress output. Returns decompressed size, or 0 if input is corrupted
+size_t LzDecompress(const unsigned char src[], size_t n, unsigned char dst[], size_t max_size)
+{
+    size_t          ip = 0;
+    size_t          op = 0;
+
+    while (ip < n)
+    {
+        size_t          nlit;
+        size_t          len;
+        size_t          offset;
+        unsigned char   token;
+
+        token = src[ip++];
+
+        nlit = token >> 4;
+        if (nlit == 15)
+        {
+            while (ip < n && src[ip] == 255)
+            {
+                nlit += src[ip++];
+            }
+            nlit += (ip < n) ? src[ip++] : 0;
+        }
+
+        if (ip + nlit > n || op + nlit > max_size)
+        {
+            return 0;
+        }
+        memcpy(dst + op, src + ip, nlit);
+        ip += nlit;
+        op += nlit;
+
+        if (ip == n)
+        {
+            // Last sequence
+            break;
+        }
+
+        if (ip + 2 > n)
+        {
+            return 0;
+        }
+        offset = src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+
+        len = (token & 0x0f) + MIN_MATCH;
+        if ((token & 0x0f) == 15)
+        {
+            while (ip < n && src[ip] == 255)
+            {
+                len += src[ip++];
+            }
+            len += (ip < n) ? src[ip++] : 0;
+        }
+
+        if (offset == 0 || offset > op || op + len > max_size)
+        {
+            return 0;
+        }
+
+        // Byte-by-byte copy because matches may overlap
+        while (len-- > 0)
+        {
+            dst[op] = dst[op - offset];
+            op++;
+        }
+    }
+
+    return op;
+}
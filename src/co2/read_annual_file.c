@@ -14,6 +14,7 @@ void ReadAnnualFile(const char fn[], tsdata_struct *ts)
     ts->length = CountLines(fp, cmdstr, 1, "EOF");
     ts->ftime = (int *)malloc(ts->length * sizeof(int));
     ts->data = (double **)malloc(ts->length * sizeof(double *));
+    ts->cursor = 0;
 
     FindLine(fp, "BOF", &lno, fn);
     for (k = 0; k < ts->length; k++)
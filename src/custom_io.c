@@ -1,5 +1,13 @@
 #include "custom_io.h"
 
+// Function called before exiting with an error, e.g., to write pending model output
+static void     (*exit_hook)(void) = NULL;
+
+void SetExitHook(void (*hook)(void))
+{
+    exit_hook = hook;
+}
+
 void _custom_exit(const char *fn, int lno, const char *func, int debug, int error)
 {
     if (error != EXIT_SUCCESS)
@@ -12,8 +20,26 @@ void _custom_exit(const char *fn, int lno, const char *func, int debug, int erro
         }
         fprintf(stderr, "...\n\n");
         fflush(stderr);
+
+        if (exit_hook != NULL)
+        {
+            void            (*hook)(void) = exit_hook;
+
+            // The hook is removed first so that errors in the hook do not call it again
+            exit_hook = NULL;
+            hook();
+        }
+
+#if defined(_MPI_)
+        // Terminate all processes
+        MPI_Abort(MPI_COMM_WORLD, error);
+#endif
     }
 
+#if defined(_MPI_)
+    MPI_Finalize();
+#endif
+
     exit(error);
 }
 
@@ -115,6 +141,34 @@ int NextLine(FILE *fp, char *cmdstr, int *lno)
     return 0;    // Return 0 if reaches end of file
 }
 
+// Read the next non-blank line into cmdstr if it starts with an optional keyword. Otherwise the file position and line
+// number are restored, so that the line can be read as the next keyword
+int NextOptLine(FILE *fp, const char *token, char *cmdstr, int *lno)
+{
+    char            optstr[MAXSTRING];
+    long            pos = ftell(fp);
+    int             lno0 = *lno;
+
+    if (NextLine(fp, cmdstr, lno) != 0)
+    {
+#if defined(_MSC_VER)
+        sscanf_s(cmdstr, "%s", optstr, (unsigned)_countof(optstr));
+#else
+        sscanf(cmdstr, "%s", optstr);
+#endif
+
+        if (strcasecmp(token, optstr) == 0)
+        {
+            return 1;
+        }
+    }
+
+    fseek(fp, pos, SEEK_SET);
+    *lno = lno0;
+
+    return 0;    // Return 0 if keyword is absent
+}
+
 // Count number of non-blank lines between current location to where token occurs
 int CountLines(FILE *fp, char *cmdstr, int num_arg, ...)
 {
@@ -227,9 +227,9 @@ void InitAgVar(elem_struct elem[], river_struct river[], N_Vector CV_Y)
     }
 }
 
-void WriteCyclesIc(const char outputdir[], const elem_struct elem[])
+void WriteCyclesIc(const char outputdir[], const order_struct *order, const elem_struct elem[])
 {
-    int             i, k;
+    int             i, k, n;
     char            fn[MAXSTRING];
     FILE           *fp;
 
@@ -240,8 +240,10 @@ void WriteCyclesIc(const char outputdir[], const elem_struct elem[])
     fp = pihm_fopen(fn, "wb");
     pihm_printf(VL_VERBOSE, "Writing Cycles initial conditions.\n");
 
-    for (i = 0; i < nelem; i++)
+    for (n = 0; n < nelem; n++)
     {
+        i = order->elem[n];
+
         fwrite(&elem[i].ws.residue_stan, sizeof(double), 1, fp);
         fwrite(&elem[i].ws.residue_flat, sizeof(double), 1, fp);
         fwrite(&elem[i].cs.residue_stan, sizeof(double), 1, fp);
@@ -0,0 +1,541 @@
+#include "pihm.h"
+
+#if defined(_MPI_)
+#if defined(_DGW_)
+# define NUM_ELEM_VAR   5
+#else
+# define NUM_ELEM_VAR   3
+#endif
+
+#if defined(_NOAH_) && defined(_DGW_)
+# define NUM_ELEM_FLUX  (3 * NUM_EDGE + 11)
+#elif defined(_NOAH_)
+# define NUM_ELEM_FLUX  (2 * NUM_EDGE + 9)
+#elif defined(_DGW_)
+# define NUM_ELEM_FLUX  (3 * NUM_EDGE + 10)
+#else
+# define NUM_ELEM_FLUX  (2 * NUM_EDGE + 8)
+#endif
+
+// MPI domain decomposition of the hydrology ODE system. Elements are partitioned into contiguous blocks of element
+// indices, and each river segment is owned by the process that owns its left (or right) bank element, so that
+// river-bank exchanges stay within a process. Every process reads the full input and keeps full model structures, but
+// only owns the CVODE state variables of its elements and river segments. Before each right-hand side evaluation, halo
+// values, i.e., states of elements and river segments that owned fluxes depend on, are exchanged. After each model
+// step, owned states and fluxes are gathered to all processes, so that land surface processes and outputs see the whole
+// domain. Thus the decomposition distributes the solver work, but not the memory of model structures
+void InitDecomp(const elem_struct elem[], const river_struct river[], mpi_struct *mpi)
+{
+    const int       nsv = NumStateVar();
+    int             var[NUM_ELEM_VAR];
+    int            *owner;
+    int            *local_ind;
+    char           *need;
+    char           *need_elem;
+    char           *need_river;
+    int            *ptr;
+    int             i, j, k;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi->rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi->nprocs);
+
+    if (mpi->nprocs > nelem)
+    {
+        pihm_printf(VL_ERROR, "Error: Number of MPI processes (%d) exceeds number of elements (%d).\n", mpi->nprocs,
+            nelem);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    // Partition elements and river segments
+    mpi->elem_rank = (int *)malloc(nelem * sizeof(int));
+    mpi->river_rank = (int *)malloc(nriver * sizeof(int));
+
+    for (i = 0; i < nelem; i++)
+    {
+        mpi->elem_rank[i] = (int)((long long)i * mpi->nprocs / nelem);
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        mpi->river_rank[i] = (river[i].left > 0) ? mpi->elem_rank[river[i].left - 1] :
+            ((river[i].right > 0) ? mpi->elem_rank[river[i].right - 1] : (int)((long long)i * mpi->nprocs / nriver));
+    }
+
+    // Owned state variables, in ascending order of global indices
+    owner = (int *)malloc(nsv * sizeof(int));
+    local_ind = (int *)malloc(nsv * sizeof(int));
+    mpi->own_ind = (int *)malloc(nsv * sizeof(int));
+    mpi->nlocal = 0;
+
+    for (i = 0; i < nelem; i++)
+    {
+        ElemStateVar(i, var);
+        for (k = 0; k < NUM_ELEM_VAR; k++)
+        {
+            owner[var[k]] = mpi->elem_rank[i];
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        owner[RIVER(i)] = mpi->river_rank[i];
+    }
+
+    for (i = 0; i < nsv; i++)
+    {
+        local_ind[i] = (owner[i] == mpi->rank) ? mpi->nlocal : -1;
+        if (owner[i] == mpi->rank)
+        {
+            mpi->own_ind[mpi->nlocal++] = i;
+        }
+    }
+
+    // Elements and river segments that fluxes of owned elements and river segments depend on. Overland flow between
+    // elements uses the friction slopes of neighbors, which depend on the neighbors of neighbors
+    need_elem = (char *)calloc(nelem, sizeof(char));
+    need_river = (char *)calloc(nriver, sizeof(char));
+
+    for (i = 0; i < nelem; i++)
+    {
+        if (mpi->elem_rank[i] != mpi->rank)
+        {
+            continue;
+        }
+
+        need_elem[i] = 1;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            int             nabr = elem[i].nabr[j] - 1;
+
+            if (elem[i].nabr_river[j] > 0)
+            {
+                need_river[elem[i].nabr_river[j] - 1] = 1;
+            }
+
+            if (nabr >= 0)
+            {
+                need_elem[nabr] = 1;
+
+                for (k = 0; k < NUM_EDGE; k++)
+                {
+                    if (elem[nabr].nabr[k] > 0)
+                    {
+                        need_elem[elem[nabr].nabr[k] - 1] = 1;
+                    }
+                    if (elem[nabr].nabr_river[k] > 0)
+                    {
+                        need_river[elem[nabr].nabr_river[k] - 1] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        if (mpi->river_rank[i] == mpi->rank)
+        {
+            need_river[i] = 1;
+            if (river[i].down > 0)
+            {
+                need_river[river[i].down - 1] = 1;
+            }
+            if (river[i].left > 0)
+            {
+                need_elem[river[i].left - 1] = 1;
+            }
+            if (river[i].right > 0)
+            {
+                need_elem[river[i].right - 1] = 1;
+            }
+        }
+        else if (river[i].down > 0 && mpi->river_rank[river[i].down - 1] == mpi->rank)
+        {
+            // Upstream segments contribute inflow to owned segments
+            need_river[i] = 1;
+        }
+    }
+
+    need = (char *)calloc(nsv, sizeof(char));
+    for (i = 0; i < nelem; i++)
+    {
+        if (need_elem[i])
+        {
+            ElemStateVar(i, var);
+            for (k = 0; k < NUM_ELEM_VAR; k++)
+            {
+                need[var[k]] = 1;
+            }
+        }
+    }
+    for (i = 0; i < nriver; i++)
+    {
+        need[RIVER(i)] = need_river[i];
+    }
+
+    // Halo values received, grouped by owner in ascending order of global indices
+    mpi->recv_cnt = (int *)calloc(mpi->nprocs, sizeof(int));
+    mpi->recv_displ = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->send_cnt = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->send_displ = (int *)malloc(mpi->nprocs * sizeof(int));
+    ptr = (int *)malloc(mpi->nprocs * sizeof(int));
+
+    for (i = 0; i < nsv; i++)
+    {
+        if (need[i] && owner[i] != mpi->rank)
+        {
+            mpi->recv_cnt[owner[i]]++;
+        }
+    }
+
+    MPI_Alltoall(mpi->recv_cnt, 1, MPI_INT, mpi->send_cnt, 1, MPI_INT, MPI_COMM_WORLD);
+
+    mpi->nrecv = 0;
+    mpi->nsend = 0;
+    for (k = 0; k < mpi->nprocs; k++)
+    {
+        mpi->recv_displ[k] = mpi->nrecv;
+        mpi->send_displ[k] = mpi->nsend;
+        ptr[k] = mpi->nrecv;
+        mpi->nrecv += mpi->recv_cnt[k];
+        mpi->nsend += mpi->send_cnt[k];
+    }
+
+    mpi->recv_ind = (int *)malloc(MAX(mpi->nrecv, 1) * sizeof(int));
+    mpi->recv_buf = (double *)malloc(MAX(mpi->nrecv, 1) * sizeof(double));
+    mpi->send_ind = (int *)malloc(MAX(mpi->nsend, 1) * sizeof(int));
+    mpi->send_buf = (double *)malloc(MAX(mpi->nsend, 1) * sizeof(double));
+
+    for (i = 0; i < nsv; i++)
+    {
+        if (need[i] && owner[i] != mpi->rank)
+        {
+            mpi->recv_ind[ptr[owner[i]]++] = i;
+        }
+    }
+
+    // Each process sends the values requested by other processes
+    MPI_Alltoallv(mpi->recv_ind, mpi->recv_cnt, mpi->recv_displ, MPI_INT, mpi->send_ind, mpi->send_cnt,
+        mpi->send_displ, MPI_INT, MPI_COMM_WORLD);
+
+    for (k = 0; k < mpi->nsend; k++)
+    {
+        mpi->send_ind[k] = local_ind[mpi->send_ind[k]];
+    }
+
+    // State variables owned by all processes, for gathering states after each model step
+    mpi->all_cnt = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->all_displ = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->all_ind = (int *)malloc(nsv * sizeof(int));
+
+    MPI_Allgather(&mpi->nlocal, 1, MPI_INT, mpi->all_cnt, 1, MPI_INT, MPI_COMM_WORLD);
+    for (k = 0; k < mpi->nprocs; k++)
+    {
+        mpi->all_displ[k] = (k == 0) ? 0 : mpi->all_displ[k - 1] + mpi->all_cnt[k - 1];
+    }
+    MPI_Allgatherv(mpi->own_ind, mpi->nlocal, MPI_INT, mpi->all_ind, mpi->all_cnt, mpi->all_displ, MPI_INT,
+        MPI_COMM_WORLD);
+
+    // Elements and river segments owned by all processes, for gathering fluxes after each model step
+    mpi->elem_cnt = (int *)calloc(mpi->nprocs, sizeof(int));
+    mpi->elem_displ = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->river_cnt = (int *)calloc(mpi->nprocs, sizeof(int));
+    mpi->river_displ = (int *)malloc(mpi->nprocs * sizeof(int));
+    mpi->river_ind = (int *)malloc(MAX(nriver, 1) * sizeof(int));
+
+    for (i = 0; i < nelem; i++)
+    {
+        mpi->elem_cnt[mpi->elem_rank[i]]++;
+    }
+    for (i = 0; i < nriver; i++)
+    {
+        mpi->river_cnt[mpi->river_rank[i]]++;
+    }
+    for (k = 0; k < mpi->nprocs; k++)
+    {
+        mpi->elem_displ[k] = (k == 0) ? 0 : mpi->elem_displ[k - 1] + mpi->elem_cnt[k - 1];
+        mpi->river_displ[k] = (k == 0) ? 0 : mpi->river_displ[k - 1] + mpi->river_cnt[k - 1];
+        ptr[k] = mpi->river_displ[k];
+    }
+    for (i = 0; i < nriver; i++)
+    {
+        mpi->river_ind[ptr[mpi->river_rank[i]]++] = i;
+    }
+
+    mpi->buf = (double *)malloc(MAX(nsv, MAX(NUM_ELEM_FLUX * nelem, NUM_RIVFLX * nriver)) * sizeof(double));
+    mpi->ydot = (double *)malloc(nsv * sizeof(double));
+    mpi->rwork = (double *)malloc(nsv * sizeof(double));
+    mpi->zwork = (double *)malloc(nsv * sizeof(double));
+
+    mpi->CV_Yl = N_VNew_Parallel(MPI_COMM_WORLD, mpi->nlocal, nsv);
+    if (mpi->CV_Yl == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error creating CVODE state variable vector.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    pihm_printf(VL_VERBOSE, " %d MPI processes, %d state variables and %d halo values owned by process 0.\n",
+        mpi->nprocs, mpi->nlocal, mpi->nrecv);
+
+    free(owner);
+    free(local_ind);
+    free(need);
+    free(need_elem);
+    free(need_river);
+    free(ptr);
+}
+
+// Global indices of state variables of an element
+void ElemStateVar(int i, int var[])
+{
+    var[0] = SURF(i);
+    var[1] = UNSAT(i);
+    var[2] = GW(i);
+#if defined(_DGW_)
+    var[3] = UNSAT_GEOL(i);
+    var[4] = GW_GEOL(i);
+#endif
+}
+
+// Only keep edges of owned elements in lateral flux edge lists. Fluxes of other elements are gathered from their
+// owners after each model step
+void LocalEdgeList(const mpi_struct *mpi, hydro_struct *hydro)
+{
+    int             nedge = 0;
+    int             nedge_ovl = 0;
+    int             nbound = 0;
+    int             k;
+
+    for (k = 0; k < hydro->nedge; k++)
+    {
+        if (mpi->elem_rank[hydro->edge_ind[2 * k] / NUM_EDGE] == mpi->rank ||
+            mpi->elem_rank[hydro->edge_ind[2 * k + 1] / NUM_EDGE] == mpi->rank)
+        {
+            hydro->edge_ind[2 * nedge] = hydro->edge_ind[2 * k];
+            hydro->edge_ind[2 * nedge + 1] = hydro->edge_ind[2 * k + 1];
+            nedge++;
+            nedge_ovl += (k < hydro->nedge_ovl) ? 1 : 0;
+        }
+    }
+
+    for (k = 0; k < hydro->nbound; k++)
+    {
+        if (mpi->elem_rank[hydro->bound_ind[k] / NUM_EDGE] == mpi->rank)
+        {
+            hydro->bound_ind[nbound++] = hydro->bound_ind[k];
+        }
+    }
+
+    hydro->nedge = nedge;
+    hydro->nedge_ovl = nedge_ovl;
+    hydro->nbound = nbound;
+}
+
+// Copy owned state variables to the global layout and exchange halo values with other processes
+void ExchangeHalo(const double y_local[], mpi_struct *mpi, double y[])
+{
+    int             k;
+
+    GlobalState(y_local, mpi, y);
+
+    for (k = 0; k < mpi->nsend; k++)
+    {
+        mpi->send_buf[k] = y_local[mpi->send_ind[k]];
+    }
+
+    MPI_Alltoallv(mpi->send_buf, mpi->send_cnt, mpi->send_displ, MPI_DOUBLE, mpi->recv_buf, mpi->recv_cnt,
+        mpi->recv_displ, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    for (k = 0; k < mpi->nrecv; k++)
+    {
+        y[mpi->recv_ind[k]] = mpi->recv_buf[k];
+    }
+}
+
+// Copy owned state variables to the global layout
+void GlobalState(const double y_local[], const mpi_struct *mpi, double y[])
+{
+    int             k;
+
+    for (k = 0; k < mpi->nlocal; k++)
+    {
+        y[mpi->own_ind[k]] = y_local[k];
+    }
+}
+
+// Copy owned state variables from the global layout
+void LocalState(const double y[], const mpi_struct *mpi, double y_local[])
+{
+    int             k;
+
+    for (k = 0; k < mpi->nlocal; k++)
+    {
+        y_local[k] = y[mpi->own_ind[k]];
+    }
+}
+
+// Gather state variables owned by all processes to the global layout
+void GatherState(const double y_local[], mpi_struct *mpi, double y[])
+{
+    int             k;
+
+    MPI_Allgatherv(y_local, mpi->nlocal, MPI_DOUBLE, mpi->buf, mpi->all_cnt, mpi->all_displ, MPI_DOUBLE,
+        MPI_COMM_WORLD);
+
+    for (k = 0; k < NumStateVar(); k++)
+    {
+        y[mpi->all_ind[k]] = mpi->buf[k];
+    }
+}
+
+// Gather hydrology fluxes of elements and river segments from their owners. Fluxes are those calculated in the last
+// right-hand side evaluation, which are only valid for owned elements and river segments
+void GatherFlux(mpi_struct *mpi, elem_struct elem[], river_struct river[])
+{
+    int            *count;
+    int            *displ;
+    int             i, k;
+
+    count = (int *)malloc(mpi->nprocs * sizeof(int));
+    displ = (int *)malloc(mpi->nprocs * sizeof(int));
+
+    // Element fluxes. Elements are owned in contiguous blocks
+    for (k = 0; k < mpi->nprocs; k++)
+    {
+        count[k] = NUM_ELEM_FLUX * mpi->elem_cnt[k];
+        displ[k] = NUM_ELEM_FLUX * mpi->elem_displ[k];
+    }
+
+    for (i = mpi->elem_displ[mpi->rank]; i < mpi->elem_displ[mpi->rank] + mpi->elem_cnt[mpi->rank]; i++)
+    {
+        PackElemFlux(&elem[i], &mpi->buf[NUM_ELEM_FLUX * i]);
+    }
+
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, mpi->buf, count, displ, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    for (i = 0; i < nelem; i++)
+    {
+        if (mpi->elem_rank[i] != mpi->rank)
+        {
+            UnpackElemFlux(&mpi->buf[NUM_ELEM_FLUX * i], &elem[i]);
+        }
+    }
+
+    // River fluxes
+    for (k = 0; k < mpi->nprocs; k++)
+    {
+        count[k] = NUM_RIVFLX * mpi->river_cnt[k];
+        displ[k] = NUM_RIVFLX * mpi->river_displ[k];
+    }
+
+    for (k = mpi->river_displ[mpi->rank]; k < mpi->river_displ[mpi->rank] + mpi->river_cnt[mpi->rank]; k++)
+    {
+        memcpy(&mpi->buf[NUM_RIVFLX * k], river[mpi->river_ind[k]].wf.rivflow, NUM_RIVFLX * sizeof(double));
+    }
+
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, mpi->buf, count, displ, MPI_DOUBLE, MPI_COMM_WORLD);
+
+    for (k = 0; k < nriver; k++)
+    {
+        if (mpi->river_rank[mpi->river_ind[k]] != mpi->rank)
+        {
+            memcpy(river[mpi->river_ind[k]].wf.rivflow, &mpi->buf[NUM_RIVFLX * k], NUM_RIVFLX * sizeof(double));
+        }
+    }
+
+    free(count);
+    free(displ);
+}
+
+// Pack and unpack element variables that are calculated in right-hand side evaluations
+void PackElemFlux(const elem_struct *elem_ptr, double buf[])
+{
+    int             j;
+    int             n = 0;
+
+    buf[n++] = elem_ptr->ws.surfh;
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        buf[n++] = elem_ptr->wf.overland[j];
+        buf[n++] = elem_ptr->wf.subsurf[j];
+    }
+    buf[n++] = elem_ptr->wf.infil;
+    buf[n++] = elem_ptr->wf.recharge;
+    buf[n++] = elem_ptr->wf.edir_surf;
+    buf[n++] = elem_ptr->wf.edir_unsat;
+    buf[n++] = elem_ptr->wf.edir_gw;
+    buf[n++] = elem_ptr->wf.ett_unsat;
+    buf[n++] = elem_ptr->wf.ett_gw;
+#if defined(_NOAH_)
+    buf[n++] = elem_ptr->ps.gwet;
+#endif
+#if defined(_DGW_)
+    buf[n++] = elem_ptr->wf.infil_geol;
+    buf[n++] = elem_ptr->wf.rechg_geol;
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        buf[n++] = elem_ptr->wf.dgw[j];
+    }
+#endif
+}
+
+void UnpackElemFlux(const double buf[], elem_struct *elem_ptr)
+{
+    int             j;
+    int             n = 0;
+
+    elem_ptr->ws.surfh = buf[n++];
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        elem_ptr->wf.overland[j] = buf[n++];
+        elem_ptr->wf.subsurf[j] = buf[n++];
+    }
+    elem_ptr->wf.infil = buf[n++];
+    elem_ptr->wf.recharge = buf[n++];
+    elem_ptr->wf.edir_surf = buf[n++];
+    elem_ptr->wf.edir_unsat = buf[n++];
+    elem_ptr->wf.edir_gw = buf[n++];
+    elem_ptr->wf.ett_unsat = buf[n++];
+    elem_ptr->wf.ett_gw = buf[n++];
+#if defined(_NOAH_)
+    elem_ptr->ps.gwet = buf[n++];
+#endif
+#if defined(_DGW_)
+    elem_ptr->wf.infil_geol = buf[n++];
+    elem_ptr->wf.rechg_geol = buf[n++];
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        elem_ptr->wf.dgw[j] = buf[n++];
+    }
+#endif
+}
+
+void FreeDecomp(mpi_struct *mpi)
+{
+    N_VDestroy(mpi->CV_Yl);
+    free(mpi->elem_rank);
+    free(mpi->river_rank);
+    free(mpi->own_ind);
+    free(mpi->send_cnt);
+    free(mpi->send_displ);
+    free(mpi->send_ind);
+    free(mpi->send_buf);
+    free(mpi->recv_cnt);
+    free(mpi->recv_displ);
+    free(mpi->recv_ind);
+    free(mpi->recv_buf);
+    free(mpi->all_cnt);
+    free(mpi->all_displ);
+    free(mpi->all_ind);
+    free(mpi->elem_cnt);
+    free(mpi->elem_displ);
+    free(mpi->river_cnt);
+    free(mpi->river_displ);
+    free(mpi->river_ind);
+    free(mpi->buf);
+    free(mpi->ydot);
+    free(mpi->rwork);
+    free(mpi->zwork);
+}
+#endif
@@ -0,0 +1,252 @@
+#include "pihm.h"
+
+// Ensemble mode. Input files are read once, and ensemble members that only differ in calibration parameters share
+// input tables and forcing time series. Each member has its own model states, CVODE memory, and output directory.
+// Members are run concurrently with one member per OpenMP thread. The ensemble file lists one calibration file per
+// member, e.g.:
+//   input/ShaleHills/ShaleHills.calib
+//   input/ShaleHills/calib/member2.calib
+// and the output of each member is written to the member_### directory in the output directory
+void RunEnsemble(const char fn[], const char outputdir[])
+{
+#if defined(_RT_) || defined(_BGC_) || defined(_CYCLES_)
+    (void)fn;
+    (void)outputdir;
+
+    pihm_printf(VL_ERROR, "Error: Ensemble mode is not available with RT, BGC, or Cycles modules.\n");
+    pihm_exit(EXIT_FAILURE);
+#else
+    char            ens_dir[MAXSTRING];
+    char          **calib_fn;
+    int             nmember;
+    pihm_struct     base;
+    pihm_struct    *member;
+    double          member_years;
+    double          wall_time;
+    int             i;
+# if defined(_OPENMP)
+    double          start_omp;
+# else
+    clock_t         start;
+# endif
+
+    calib_fn = ReadEnsemble(fn, &nmember);
+
+    // Read PIHM input files once
+    base = (pihm_struct)calloc(1, sizeof(*base));
+    if (base == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for model instance.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+    ReadAlloc(base);
+
+    strcpy(ens_dir, outputdir);
+    CreateOutputDir(ens_dir);
+
+    // Members are created serially because initialization may read and write shared files (e.g., horizon cache)
+    member = (pihm_struct *)malloc(nmember * sizeof(pihm_struct));
+    for (i = 0; i < nmember; i++)
+    {
+        char            member_dir[MAXSTRING];
+
+        pihm_printf(VL_BRIEF, "Initialize ensemble member %d (%s)\n", i + 1, calib_fn[i]);
+
+        if (snprintf(member_dir, sizeof(member_dir), "%smember_%03d/", ens_dir, i + 1) >= (int)sizeof(member_dir))
+        {
+            pihm_printf(VL_ERROR, "Error: Output directory name of ensemble member %d is too long.\n", i + 1);
+            pihm_exit(EXIT_FAILURE);
+        }
+        member[i] = CreateMember(base, calib_fn[i], member_dir);
+    }
+
+    // Progress bars of concurrent members are not printed
+    verbose_mode = MIN(verbose_mode, VL_BRIEF);
+
+# if defined(_OPENMP)
+    // Each member is run by one thread
+    omp_set_max_active_levels(1);
+    start_omp = omp_get_wtime();
+# else
+    start = clock();
+# endif
+
+# if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic)
+# endif
+    for (i = 0; i < nmember; i++)
+    {
+        if (member[i]->ctx.spinup_mode)
+        {
+            SpinupPihm(member[i]);
+        }
+        else
+        {
+            while (StepPihm(member[i]))
+            {
+            }
+        }
+
+        pihm_printf(VL_BRIEF, "Ensemble member %d completed.\n", i + 1);
+    }
+
+# if defined(_OPENMP)
+    wall_time = omp_get_wtime() - start_omp;
+# else
+    wall_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+# endif
+
+    member_years = (double)nmember * (base->ctrl.endtime - base->ctrl.starttime) / DAYINSEC / 365.0;
+# if defined(_OPENMP)
+    pihm_printf(VL_BRIEF, "%d members completed in %.2lf s (%.3lf member-years per core-hour).\n", nmember, wall_time,
+        member_years / (wall_time * MIN(nthreads, nmember) / 3600.0));
+# else
+    pihm_printf(VL_BRIEF, "%d members completed in %.2lf s (%.3lf member-years per core-hour).\n", nmember, wall_time,
+        member_years / (wall_time / 3600.0));
+# endif
+
+    for (i = 0; i < nmember; i++)
+    {
+        DestroyPihm(member[i]);
+    }
+    free(member);
+    for (i = 0; i < nmember; i++)
+    {
+        free(calib_fn[i]);
+    }
+    free(calib_fn);
+
+    FreeInput(base);
+    free(base);
+#endif
+}
+
+char **ReadEnsemble(const char fn[], int *nmember)
+{
+    FILE           *fp;
+    char            cmdstr[MAXSTRING];
+    char          **calib_fn;
+    int             i;
+    int             lno = 0;
+
+    fp = pihm_fopen(fn, "r");
+    pihm_printf(VL_VERBOSE, " Reading %s\n", fn);
+
+    *nmember = CountLines(fp, cmdstr, 0);
+    if (*nmember <= 0)
+    {
+        pihm_printf(VL_ERROR, "Error: No ensemble member is specified in %s.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    calib_fn = (char **)malloc(*nmember * sizeof(char *));
+
+    FindLine(fp, "BOF", &lno, fn);
+    for (i = 0; i < *nmember; i++)
+    {
+        calib_fn[i] = (char *)malloc(MAXSTRING * sizeof(char));
+        NextLine(fp, cmdstr, &lno);
+        if (sscanf(cmdstr, "%s", calib_fn[i]) != 1)
+        {
+            pihm_error(ERROR, ERR_WRONG_FORMAT, fn, lno);
+        }
+    }
+
+    fclose(fp);
+
+    return calib_fn;
+}
+
+// Share forcing time series of the base structure with an ensemble member. Forcing values at model time and search
+// cursors belong to each member. Meteorological forcing values are only copied when the member uses climate
+// scenarios, which modify forcing values
+void ShareForc(const forc_struct *base, const calib_struct *calib, forc_struct *forc, int *own_meteo)
+{
+    int             i, j;
+
+    forc->bc = CopySeries(base->nbc, base->bc);
+    forc->meteo = CopySeries(base->nmeteo, base->meteo);
+    forc->lai = CopySeries(base->nlai, base->lai);
+    forc->source = CopySeries(base->nsource, base->source);
+    forc->riverbc = CopySeries(base->nriverbc, base->riverbc);
+#if defined(_NOAH_)
+    forc->rad = CopySeries(base->nrad, base->rad);
+#endif
+
+    *own_meteo = (calib->prcp != 1.0 || calib->sfctmp != 0.0);
+
+    for (i = 0; i < forc->nmeteo && *own_meteo; i++)
+    {
+        forc->meteo[i].data = (double **)malloc(forc->meteo[i].length * sizeof(double *));
+        forc->meteo[i].data[0] = (double *)malloc(forc->meteo[i].length * NUM_METEO_VAR * sizeof(double));
+        for (j = 0; j < forc->meteo[i].length; j++)
+        {
+            forc->meteo[i].data[j] = forc->meteo[i].data[0] + j * NUM_METEO_VAR;
+            memcpy(forc->meteo[i].data[j], base->meteo[i].data[j], NUM_METEO_VAR * sizeof(double));
+        }
+    }
+}
+
+tsdata_struct *CopySeries(int nts, const tsdata_struct ts[])
+{
+    tsdata_struct  *copy;
+
+    if (nts <= 0)
+    {
+        return NULL;
+    }
+
+    copy = (tsdata_struct *)malloc(nts * sizeof(tsdata_struct));
+    memcpy(copy, ts, nts * sizeof(tsdata_struct));
+
+    return copy;
+}
+
+// Free forcing series owned by an ensemble member
+void FreeMemberForc(int own_meteo, forc_struct *forc)
+{
+    int             i;
+
+    for (i = 0; i < forc->nbc; i++)
+    {
+        free(forc->bc[i].value);
+    }
+    free(forc->bc);
+
+    for (i = 0; i < forc->nmeteo; i++)
+    {
+        if (own_meteo)
+        {
+            free(forc->meteo[i].data[0]);
+            free(forc->meteo[i].data);
+        }
+        free(forc->meteo[i].value);
+    }
+    free(forc->meteo);
+
+    for (i = 0; i < forc->nlai; i++)
+    {
+        free(forc->lai[i].value);
+    }
+    free(forc->lai);
+
+    for (i = 0; i < forc->nsource; i++)
+    {
+        free(forc->source[i].value);
+    }
+    free(forc->source);
+
+    for (i = 0; i < forc->nriverbc; i++)
+    {
+        free(forc->riverbc[i].value);
+    }
+    free(forc->riverbc);
+
+#if defined(_NOAH_)
+    for (i = 0; i < forc->nrad; i++)
+    {
+        free(forc->rad[i].value);
+    }
+    free(forc->rad);
+#endif
+}
@@ -24,19 +24,20 @@ void ApplyBc(int t, forc_struct *forc, elem_struct elem[], river_struct river[])
 }
 
 #if defined(_RT_)
-void ApplyForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, const rttbl_struct *rttbl, forc_struct *forc,
-    elem_struct elem[])
+void ApplyForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, const sun_struct *sun,
+    const rttbl_struct *rttbl, forc_struct *forc, elem_struct elem[])
 #elif defined(_NOAH_)
-void ApplyForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, forc_struct *forc, elem_struct elem[])
+void ApplyForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, const sun_struct *sun, forc_struct *forc,
+    elem_struct elem[])
 #else
 void ApplyForcing(int t, forc_struct *forc, elem_struct elem[])
 #endif
 {
     // Meteorological forcing
 #if defined(_CYCLES_)
-    ApplyDailyMeteoForcing(t, rad_mode, siteinfo, forc, elem);
+    ApplyDailyMeteoForcing(t, rad_mode, siteinfo, sun, forc, elem);
 #elif defined(_NOAH_)
-    ApplyMeteoForcing(t, rad_mode, siteinfo, forc, elem);
+    ApplyMeteoForcing(t, rad_mode, siteinfo, sun, forc, elem);
 #else
     ApplyMeteoForcing(t, forc, elem);
 #endif
@@ -60,19 +61,13 @@ void ApplyElemBc(int t, const rttbl_struct *rttbl, forc_struct *forc, elem_struc
 void ApplyElemBc(int t, forc_struct *forc, elem_struct elem[])
 #endif
 {
-    int             i, k;
+    int             i;
 
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (k = 0; k < forc->nbc; k++)
-    {
 #if defined(_RT_)
-        IntrplForcing(t, 1 + rttbl->num_stc, INTRPL, &forc->bc[k]);
+    IntrplForcingBatch(t, forc->nbc, 1 + rttbl->num_stc, INTRPL, forc->bc);
 #else
-        IntrplForcing(t, 1, INTRPL, &forc->bc[k]);
+    IntrplForcingBatch(t, forc->nbc, 1, INTRPL, forc->bc);
 #endif
-    }
 
 #if defined(_OPENMP)
 # pragma omp parallel for
@@ -142,39 +137,28 @@ void ApplyElemBc(int t, forc_struct *forc, elem_struct elem[])
 }
 
 #if defined(_NOAH_)
-void ApplyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, forc_struct *forc, elem_struct elem[])
+void ApplyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, const sun_struct *sun, forc_struct *forc,
+    elem_struct elem[])
 #else
 void ApplyMeteoForcing(int t, forc_struct *forc, elem_struct elem[])
 #endif
 {
-    int             i, k;
+    int             i;
 #if defined(_NOAH_)
-    spa_data        spa;
+    sunpos_struct   sunpos;
 #endif
 
     // Meteorological forcing for PIHM
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (k = 0; k < forc->nmeteo; k++)
-    {
-        IntrplForcing(t, NUM_METEO_VAR, INTRPL, &forc->meteo[k]);
-    }
+    IntrplForcingBatch(t, forc->nmeteo, NUM_METEO_VAR, INTRPL, forc->meteo);
 
 #if defined(_NOAH_)
     // Topographic radiation for Noah
     if (rad_mode == TOPO_SOL)
     {
-# if defined(_OPENMP)
-#  pragma omp parallel for
-# endif
-        for (k = 0; k < forc->nrad; k++)
-        {
-            IntrplForcing(t, 2, INTRPL, &forc->rad[k]);
-        }
+        IntrplForcingBatch(t, forc->nrad, 2, INTRPL, forc->rad);
 
-        // Calculate Sun position for topographic solar radiation
-        SunPos(t, siteinfo, &spa);
+        // Get Sun position for topographic solar radiation
+        SunPosition(t, siteinfo, sun, &sunpos);
     }
 #endif
 
@@ -199,25 +183,29 @@ void ApplyMeteoForcing(int t, forc_struct *forc, elem_struct elem[])
         elem[i].ps.sfcprs = forc->meteo[ind].value[PRES_TS];
 
 #if defined(_NOAH_)
-        // Calculate solar radiation
         if (rad_mode == TOPO_SOL)
         {
             elem[i].ef.soldir = forc->rad[ind].value[SOLDIR_TS];
             elem[i].ef.soldif = forc->rad[ind].value[SOLDIF_TS];
-
-            elem[i].ef.soldn =
-                TopoRadn(elem[i].ef.soldir, elem[i].ef.soldif, spa.zenith, spa.azimuth180, &elem[i].topo);
-            elem[i].ef.soldn = MAX(elem[i].ef.soldn, 0.0);
         }
 #endif
     }
+
+#if defined(_NOAH_)
+    // Calculate topographic solar radiation
+    if (rad_mode == TOPO_SOL)
+    {
+        TopoRadnBatch(&sunpos, elem);
+    }
+#endif
 }
 
 #if defined(_CYCLES_)
-void ApplyDailyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, forc_struct *forc, elem_struct elem[])
+void ApplyDailyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo, const sun_struct *sun,
+    forc_struct *forc, elem_struct elem[])
 {
-    int             i, k, kt;
-    spa_data        spa;
+    int             i, kt;
+    sunpos_struct   sunpos;
 
 #if defined(_OPENMP)
 #pragma omp parallel for
@@ -239,28 +227,16 @@ void ApplyDailyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo
 
     for (kt = t; kt < t + DAYINSEC; kt += 3600)
     {
-#if defined(_OPENMP)
-#pragma omp parallel for
-#endif
         // Meteorological forcing for PIHM
-        for (k = 0; k < forc->nmeteo; k++)
-        {
-            IntrplForcing(kt, NUM_METEO_VAR, INTRPL, &forc->meteo[k]);
-        }
+        IntrplForcingBatch(kt, forc->nmeteo, NUM_METEO_VAR, INTRPL, forc->meteo);
 
         // Topographic radiation for Noah
         if (rad_mode == TOPO_SOL)
         {
-#if defined(_OPENMP)
-#pragma omp parallel for
-#endif
-            for (k = 0; k < forc->nrad; k++)
-            {
-                IntrplForcing(kt, 2, INTRPL, &forc->rad[k]);
-            }
+            IntrplForcingBatch(kt, forc->nrad, 2, INTRPL, forc->rad);
 
-            // Calculate Sun position for topographic solar radiation
-            SunPos(kt, siteinfo, &spa);
+            // Get Sun position for topographic solar radiation
+            SunPosition(kt, siteinfo, sun, &sunpos);
         }
 
 #if defined(_OPENMP)
@@ -284,8 +260,8 @@ void ApplyDailyMeteoForcing(int t, int rad_mode, const siteinfo_struct *siteinfo
             elem[i].ps.rh += forc->meteo[ind].value[RH_TS] / 24.0;
             elem[i].ps.sfcspd += forc->meteo[ind].value[SFCSPD_TS] / 24.0;
             elem[i].ef.soldn += (rad_mode > 0 && forc->nrad > 0) ?
-                MAX(TopoRadn(elem[i].ef.soldir, elem[i].ef.soldif, spa.zenith, spa.azimuth180, &elem[i].topo), 0.0) /
-                24.0 : MAX(forc->meteo[ind].value[SOLAR_TS], 0.0) / 24.0;
+                MAX(TopoRadn(elem[i].ef.soldir, elem[i].ef.soldif, &sunpos, &elem[i].topo), 0.0) / 24.0 :
+                MAX(forc->meteo[ind].value[SOLAR_TS], 0.0) / 24.0;
             elem[i].ef.longwave += forc->meteo[ind].value[LONGWAVE_TS] / 24.0;
             elem[i].ps.sfcprs += forc->meteo[ind].value[PRES_TS] / 24.0;
 
@@ -339,18 +315,7 @@ void ApplyLai(int t, forc_struct *forc, elem_struct elem[])
     }
 #else
     // Use LAI forcing
-    int             k;
-
-    if (forc->nlai > 0)
-    {
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-        for (k = 0; k < forc->nlai; k++)
-        {
-            IntrplForcing(t, 1, INTRPL, &forc->lai[k]);
-        }
-    }
+    IntrplForcingBatch(t, forc->nlai, 1, INTRPL, forc->lai);
 
 # if defined(_OPENMP)
 #  pragma omp parallel for
@@ -376,17 +341,11 @@ void ApplyLai(int t, forc_struct *forc, elem_struct elem[])
 #if defined(_RT_)
 void ApplyPrcpConc(int t, const rttbl_struct *rttbl, forc_struct *forc, elem_struct elem[])
 {
-    int             i, j;
+    int             i;
 
     if (forc->prcp_flag == 2)
     {
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-        for (j = 0; j < forc->nprcpc; j++)
-        {
-            IntrplForcing(t, rttbl->num_spc, NO_INTRPL, &forc->prcpc[j]);
-        }
+        IntrplForcingBatch(t, forc->nprcpc, rttbl->num_spc, NO_INTRPL, forc->prcpc);
 
 #if defined(_OPENMP)
 # pragma omp parallel for
@@ -424,15 +383,9 @@ void ApplyPrcpConc(int t, const rttbl_struct *rttbl, forc_struct *forc, elem_str
 
 void ApplyRiverBc(int t, forc_struct *forc, river_struct river[])
 {
-    int             i, k;
+    int             i;
 
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (k = 0; k < forc->nriverbc; k++)
-    {
-        IntrplForcing(t, 1, INTRPL, &forc->riverbc[k]);
-    }
+    IntrplForcingBatch(t, forc->nriverbc, 1, INTRPL, forc->riverbc);
 
 #if defined(_OPENMP)
 # pragma omp parallel for
@@ -457,45 +410,155 @@ void ApplyRiverBc(int t, forc_struct *forc, river_struct river[])
 void IntrplForcing(int t, int nvrbl, int intrpl, tsdata_struct *ts)
 {
     int             j;
-    int             first, middle, last;
+    int             k;
 
-    if (t < ts->ftime[0])
+    k = ForcingRecord(t, ts);
+    if (k == 0)
     {
-        pihm_printf(VL_ERROR, "Error finding forcing for current time step.\nPlease check your forcing file.\n");
-        pihm_exit(EXIT_FAILURE);
+        return;
+    }
+
+    if (intrpl)
+    {
+        const double   *data0 = ts->data[k - 1];
+        const double   *data1 = ts->data[k];
+        const double    w0 = (double)(ts->ftime[k] - t);
+        const double    w1 = (double)(t - ts->ftime[k - 1]);
+        const double    dt = (double)(ts->ftime[k] - ts->ftime[k - 1]);
+
+        for (j = 0; j < nvrbl; j++)
+        {
+            ts->value[j] = (w0 * data0[j] + w1 * data1[j]) / dt;
+        }
+    }
+    else
+    {
+        for (j = 0; j < nvrbl; j++)
+        {
+            ts->value[j] = ts->data[k - 1][j];
+        }
+    }
+}
+
+// Interpolate forcing values of a group of series (e.g., all meteorological forcing stations) at model time t
+void IntrplForcingBatch(int t, int nts, int nvrbl, int intrpl, tsdata_struct ts[])
+{
+    int             k;
+
+#if defined(_OPENMP)
+# pragma omp parallel for if (nts > 1)
+#endif
+    for (k = 0; k < nts; k++)
+    {
+        IntrplForcing(t, nvrbl, intrpl, &ts[k]);
     }
-    else if (t > ts->ftime[ts->length - 1])
+}
+
+// Find the forcing record k so that ftime[k - 1] <= t < ftime[k]. Returns 0 if no such record exists
+int ForcingRecord(int t, tsdata_struct *ts)
+{
+    int             k;
+    int             first, middle, last;
+
+    if (t < ts->ftime[0] || t > ts->ftime[ts->length - 1])
     {
         pihm_printf(VL_ERROR, "Error finding forcing for current time step.\nPlease check your forcing file.\n");
         pihm_exit(EXIT_FAILURE);
     }
 
-    first = 1;
-    last = ts->length - 1;
-
-    while (first <= last)
+    // Model time moves forward except for spin-up cycles, thus the search starts from the forcing record used at the
+    // previous look-up. Binary search is only needed when model time moves backward
+    k = ts->cursor;
+    if (k >= 1 && k < ts->length && t >= ts->ftime[k - 1])
     {
-        middle = (first + last) / 2;
-        if (t >= ts->ftime[middle - 1] && t < ts->ftime[middle])
+        while (k < ts->length - 1 && t >= ts->ftime[k])
         {
-            for (j = 0; j < nvrbl; j++)
-            {
-                ts->value[j] = (intrpl) ?
-                    ((double)(ts->ftime[middle] - t) * ts->data[middle - 1][j] +
-                    (double)(t - ts->ftime[middle - 1]) * ts->data[middle][j]) /
-                    (double)(ts->ftime[middle] - ts->ftime[middle - 1]) : ts->data[middle - 1][j];
-            }
-            break;
+            k++;
         }
-        else if (ts->ftime[middle] > t)
-        {
-            last = middle - 1;
-        }
-        else
+    }
+    else
+    {
+        first = 1;
+        last = ts->length - 1;
+        k = 0;
+
+        while (first <= last)
         {
-            first = middle + 1;
+            middle = (first + last) / 2;
+            if (t >= ts->ftime[middle - 1] && t < ts->ftime[middle])
+            {
+                k = middle;
+                break;
+            }
+            else if (ts->ftime[middle] > t)
+            {
+                last = middle - 1;
+            }
+            else
+            {
+                first = middle + 1;
+            }
         }
     }
+
+    if (k >= 1 && t < ts->ftime[k])
+    {
+        ts->cursor = k;
+        return k;
+    }
+
+    return 0;
+}
+
+// Rewind all forcing series to their first records, e.g., at the beginning of each spin-up cycle
+void ResetForcing(forc_struct *forc)
+{
+    int             k;
+
+    for (k = 0; k < forc->nbc; k++)
+    {
+        forc->bc[k].cursor = 0;
+    }
+    for (k = 0; k < forc->nmeteo; k++)
+    {
+        forc->meteo[k].cursor = 0;
+    }
+    for (k = 0; k < forc->nlai; k++)
+    {
+        forc->lai[k].cursor = 0;
+    }
+    for (k = 0; k < forc->nsource; k++)
+    {
+        forc->source[k].cursor = 0;
+    }
+    for (k = 0; k < forc->nriverbc; k++)
+    {
+        forc->riverbc[k].cursor = 0;
+    }
+#if defined(_BGC_) || defined(_CYCLES_)
+    for (k = 0; k < forc->nco2; k++)
+    {
+        forc->co2[k].cursor = 0;
+    }
+#endif
+#if defined(_BGC_)
+    for (k = 0; k < forc->nndep; k++)
+    {
+        forc->ndep[k].cursor = 0;
+    }
+#endif
+#if defined(_NOAH_)
+    for (k = 0; k < forc->nrad; k++)
+    {
+        forc->rad[k].cursor = 0;
+    }
+#endif
+#if defined(_RT_)
+    for (k = 0; k < forc->nprcpc && forc->prcp_flag == 2; k++)
+    {
+        forc->prcpc[k].cursor = 0;
+    }
+#endif
 }
 
 double MonthlyLai(int t, int lc)
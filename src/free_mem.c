@@ -4,37 +4,41 @@ void FreeMem(pihm_struct pihm)
 {
     int             i;
 
-    FreeRivtbl(&pihm->rivtbl);
-
-    FreeShptbl(&pihm->shptbl);
-
-    FreeMatltbl(&pihm->matltbl);
-
-    FreeMeshtbl(&pihm->meshtbl);
-
-    FreeAtttbl(&pihm->atttbl);
-
-    FreeSoiltbl(&pihm->soiltbl);
+    // Input tables and forcing series of ensemble members are shared and are freed with the ensemble
+    if (pihm->ctx.member)
+    {
+        FreeMemberForc(pihm->ctx.own_meteo, &pihm->forc);
+    }
+    else
+    {
+        FreeInput(pihm);
+    }
 
-#if defined(_DGW_)
-    FreeGeoltbl(&pihm->geoltbl);
+#if defined(_RT_)
+    FreeRTWork(pihm->rtwork);
 #endif
 
-    FreeLctbl(&pihm->lctbl);
+    FreeCtrl(&pihm->ctrl);
 
-    FreeForc(&pihm->forc);
+    FreeHydro(&pihm->hydro);
+    FreeOrder(&pihm->order);
+    FreeVgTbl(pihm->nvgtbl, pihm->vgtbl);
 
-#if defined(_BGC_)
-    FreeEpctbl(&pihm->epctbl);
+#if defined(_NOAH_)
+    FreeSun(&pihm->sun);
 #endif
 
-#if defined(_CYCLES_)
-    FreeMgmttbl(pihm->agtbl.noper, pihm->mgmttbl);
-
-    FreeAgtbl(&pihm->agtbl);
+#if defined(_MPI_)
+    FreeDecomp(&pihm->mpi);
 #endif
 
-    FreeCtrl(&pihm->ctrl);
+    if (pihm->ctrl.precond == BLOCK_PRECOND)
+    {
+        FreePrec(&pihm->prec);
+    }
+
+    // Write pending binary outputs
+    FlushWriter(pihm->print.nprint, pihm->print.varctrl, &pihm->print.writer);
 
     // Close files
     if (pihm->ctrl.waterbal)
@@ -45,11 +49,19 @@ void FreeMem(pihm_struct pihm)
     {
         fclose(pihm->print.cvodeperf_file);
     }
+    if (pihm->ctrl.timing)
+    {
+        fclose(pihm->print.timing_file);
+    }
     for (i = 0; i < pihm->print.nprint; i++)
     {
         free(pihm->print.varctrl[i].var);
         free(pihm->print.varctrl[i].buffer);
         fclose(pihm->print.varctrl[i].datfile);
+        if (pihm->print.varctrl[i].idxfile != NULL)
+        {
+            fclose(pihm->print.varctrl[i].idxfile);
+        }
         if (pihm->ctrl.ascii)
         {
             fclose(pihm->print.varctrl[i].txtfile);
@@ -59,6 +71,40 @@ void FreeMem(pihm_struct pihm)
     free(pihm->river);
 }
 
+// Free input tables and forcing
+void FreeInput(pihm_struct pihm)
+{
+    FreeRivtbl(&pihm->rivtbl);
+
+    FreeShptbl(&pihm->shptbl);
+
+    FreeMatltbl(&pihm->matltbl);
+
+    FreeMeshtbl(&pihm->meshtbl);
+
+    FreeAtttbl(&pihm->atttbl);
+
+    FreeSoiltbl(&pihm->soiltbl);
+
+#if defined(_DGW_)
+    FreeGeoltbl(&pihm->geoltbl);
+#endif
+
+    FreeLctbl(&pihm->lctbl);
+
+    FreeForc(&pihm->forc);
+
+#if defined(_BGC_)
+    FreeEpctbl(&pihm->epctbl);
+#endif
+
+#if defined(_CYCLES_)
+    FreeMgmttbl(pihm->agtbl.noper, pihm->mgmttbl);
+
+    FreeAgtbl(&pihm->agtbl);
+#endif
+}
+
 void FreeRivtbl(rivtbl_struct *rivtbl)
 {
     free(rivtbl->from);
@@ -236,17 +282,27 @@ void FreeForc(forc_struct *forc)
     {
         for (i = 0; i < forc->nmeteo; i++)
         {
-            for (j = 0; j < forc->meteo[i].length; j++)
+            // Forcing times and values are either stored in contiguous blocks or mapped from binary forcing file
+            if (forc->meteo_map == NULL)
             {
-                free(forc->meteo[i].data[j]);
+                free(forc->meteo[i].data[0]);
+                free(forc->meteo[i].ftime);
             }
-            free(forc->meteo[i].ftime);
             free(forc->meteo[i].data);
             free(forc->meteo[i].value);
         }
         free(forc->meteo);
     }
 
+    if (forc->meteo_map != NULL)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        free(forc->meteo_map);
+#else
+        munmap(forc->meteo_map, forc->meteo_map_size);
+#endif
+    }
+
     if (forc->nlai > 0)
     {
         for (i = 0; i < forc->nlai; i++)
@@ -407,6 +463,34 @@ void FreeAgtbl(agtbl_struct *agtbl)
 }
 #endif
 
+void FreeHydro(hydro_struct *hydro)
+{
+    free(hydro->edge_ind);
+    free(hydro->bound_ind);
+    free(hydro->nabr);
+    free(hydro->nabr_river);
+    free(hydro->x_nabr);
+    free(hydro->y_nabr);
+    free(hydro->dist_nabr);
+    free(hydro->edge);
+    free(hydro->area);
+    free(hydro->zmax);
+    free(hydro->zmin);
+    free(hydro->porosity);
+    free(hydro->rough);
+    free(hydro->surfh);
+    free(hydro->gw);
+    free(hydro->effk);
+    free(hydro->sf);
+    free(hydro->bank_edge);
+    free(hydro->river_head);
+    free(hydro->up_ptr);
+    free(hydro->up_ind);
+#if defined(_VEC_)
+    FreeHydroVec(hydro);
+#endif
+}
+
 void FreeCtrl(ctrl_struct *ctrl)
 {
     free(ctrl->tout);
@@ -1,9 +1,12 @@
 #include "pihm.h"
 
-void Hydrol(const ctrl_struct *ctrl, elem_struct elem[], river_struct river[])
+void Hydrol(const ctrl_struct *ctrl, hydro_struct *hydro, timing_struct *timing, elem_struct elem[],
+    river_struct river[])
 {
     int             i;
 
+    TimerStart(TM_HYDROL_STATE, timing);
+
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
@@ -11,17 +14,43 @@ void Hydrol(const ctrl_struct *ctrl, elem_struct elem[], river_struct river[])
     {
         // Calculate actual surface water depth
         elem[i].ws.surfh = SurfH(elem[i].ws.surf);
+
+        // Update hot state used by lateral flux kernels
+        hydro->surfh[i] = elem[i].ws.surfh;
+        hydro->gw[i] = elem[i].ws.gw;
+        hydro->effk[i] = EffKh(elem[i].ws.gw, &elem[i].soil);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        hydro->river_head[i] = (river[i].ws.stage > river[i].shp.depth) ?
+            river[i].topo.zbed + river[i].ws.stage : river[i].topo.zmax;
+#if defined(_VEC_)
+        hydro->river_stage[i] = river[i].ws.stage;
+#endif
     }
+    TimerStop(TM_HYDROL_STATE, timing);
 
     // Determine which layers does ET extract water from
+    TimerStart(TM_ET_UPTAKE, timing);
     EtUptake(elem);
+    TimerStop(TM_ET_UPTAKE, timing);
 
     // Water flow
-    LateralFlow(river, elem);
+    TimerStart(TM_LATERAL, timing);
+    LateralFlow(hydro, elem);
+    TimerStop(TM_LATERAL, timing);
 
+    TimerStart(TM_VERTICAL, timing);
     VerticalFlow((double)ctrl->stepsize, elem);
+    TimerStop(TM_VERTICAL, timing);
 
-    RiverFlow(elem, river);
+    TimerStart(TM_RIVER, timing);
+    RiverFlow(hydro, elem, river);
+    TimerStop(TM_RIVER, timing);
 }
 
 void EtUptake(elem_struct elem[])
@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#if defined(_MPI_)
+# include <mpi.h>
+#endif
 
 #if defined(_MSC_VER)
 # define strcasecmp             _stricmp
@@ -37,6 +40,8 @@ int             CountLines(FILE *, char *, int, ...);
 int             CountOccurr(FILE *, const char *);
 void            FindLine(FILE *, const char *, int *, const char *);
 int             NextLine(FILE *, char *, int *);
+int             NextOptLine(FILE *, const char *, char *, int *);
 int             NonBlank(char *);
+void            SetExitHook(void (*)(void));
 
 #endif
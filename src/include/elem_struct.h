@@ -38,10 +38,28 @@ typedef struct topo_struct
     double          slope;                  // slope (degree)
     double          aspect;                 // surface aspect (degree)
     double          svf;                    // sky view factor (-)
+    double          cos_slope;              // cosine of slope (-)
+    double          sin_slope;              // sine of slope (-)
+    double          tcf;                    // terrain configuration factor (-)
     double          h_phi[36];              // unobstructed angle in each direction (degree)
 #endif
 } topo_struct;
 
+// Tabulated van Genuchten soil hydraulic functions of one beta value. Saturation below 0.5 is tabulated in binades
+// (factor-of-two ranges) of saturation, and saturation above 0.5 is tabulated in binades of saturation deficit
+// (1 - saturation), with the same number of linear intervals in each binade. Table indices are thus obtained using
+// frexp, and steep parts of the functions near SATMIN and full saturation are resolved
+typedef struct vgtbl_struct
+{
+    double          beta;                   // beta (n) from van Genuchten equation (-)
+    int             nintv;                  // number of intervals in each binade
+    int             exp_lo;                 // binary exponent of SATMIN
+    double         *kr_lo;                  // relative hydraulic conductivity at nodes below 0.5 saturation (-)
+    double         *psi_lo;                 // suction head with alpha = 1 m-1 at nodes below 0.5 saturation (m)
+    double         *kr_up;                  // relative hydraulic conductivity at nodes above 0.5 saturation (-)
+    double         *psi_up;                 // suction head with alpha = 1 m-1 at nodes above 0.5 saturation (m)
+} vgtbl_struct;
+
 // Soil parameters
 typedef struct soil_struct
 {
@@ -63,6 +81,7 @@ typedef struct soil_struct
     double          kmacv;                  // macropore vertical saturated hydraulic conductivity (m s-1)
     double          areafv;                 // macropore area fraction on a vertical cross-section (m2 m-2)
     double          areafh;                 // macropore area fraction on a horizontal cross-section (m2 m-2)
+    const vgtbl_struct *vgtbl;              // tabulated hydraulic functions, NULL = closed-form functions
 #if defined(_CYCLES_)
     double          clay[MAXLYR];
     double          sand[MAXLYR];
@@ -653,6 +672,25 @@ typedef struct daily_struct
 } daily_struct;
 #endif
 
+#if defined(_NOAH_)
+// Land surface activity tracking variables. Forcing and states are recorded at the last full land surface step
+typedef struct activity_struct
+{
+    int             nskip;                  // number of consecutive skipped land surface steps
+    long int        skipped;                // total number of skipped land surface steps
+    long int        steps;                  // total number of land surface steps
+    double          sfctmp;                 // air temperature (K)
+    double          soldn;                  // downward solar radiation (W m-2)
+    double          longwave;               // downward longwave radiation (W m-2)
+    double          q2;                     // mixing ratio (kg kg-1)
+    double          sfcspd;                 // wind speed (m s-1)
+    double          sfcprs;                 // surface pressure (Pa)
+    double          proj_lai;               // live projected leaf area index (m2 m-2)
+    double          dt1;                    // change of skin temperature in the last full step (K)
+    double          smc[MAXLYR];            // total soil moisture content (m3 m-3)
+} activity_struct;
+#endif
+
 #if defined(_BGC_)
 // Carbon state variables (including sums for sources and sinks)
 typedef struct cstate_struct
@@ -1261,6 +1299,9 @@ typedef struct elem_struct
 #if defined(_DAILY_)
     daily_struct    daily;
 #endif
+#if defined(_NOAH_)
+    activity_struct act;
+#endif
 #if defined(_DGW_)
     soil_struct     geol;
     bc_struct       bc_geol;
@@ -8,7 +8,9 @@
 #include <time.h>
 #include <errno.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <float.h>
+#include <limits.h>
 #include <sys/stat.h>
 #if defined(_WIN32) || defined(_WIN64)
 # include <windows.h>
@@ -16,6 +18,8 @@
 # include <io.h>
 #else
 # include <unistd.h>
+# include <pthread.h>
+# include <sys/mman.h>
 #endif
 #if defined(unix) || defined(__unix__) || defined(__unix)
 # include <fenv.h>
@@ -24,16 +28,24 @@
 # include <omp.h>
 #endif
 
+#if defined(_MPI_) && (defined(_RT_) || defined(_BGC_) || defined(_CYCLES_))
+# error "MPI mode is only available for PIHM and Flux-PIHM."
+#endif
+
 #define VERSION             "1.0.0.post"
 
 // SUNDIAL Header Files
 #include "cvode/cvode.h"    // Prototypes for CVODE fcts., consts.
 #include "sunlinsol/sunlinsol_spgmr.h"  // Access to SPGMR SUNLinearSolver
+#include "sunmatrix/sunmatrix_sparse.h" // Access to sparse SUNMatrix
 #if defined(_CVODE_OMP)
 # include "nvector/nvector_openmp.h"    // Access to N_Vector
 #else
 # include "nvector/nvector_serial.h"
 #endif
+#if defined(_MPI_)
+# include "nvector/nvector_parallel.h"  // Access to parallel N_Vector
+#endif
 #include "sundials/sundials_math.h"     // Definition of macros SUNSQR and EXP
 #include "sundials/sundials_dense.h"    // Prototypes for small dense fcts.
 
@@ -41,6 +53,10 @@
 # include "spa.h"
 #endif
 
+#if defined(_VEC_)
+# include "vec_math.h"
+#endif
+
 #include "custom_io.h"
 
 #include "pihm_const.h"
@@ -71,6 +71,16 @@
 #define CMCFACTR                2E-4        // canopy water capacity per LAI (m)
 #define SH2OMIN                 0.02        // minimum swc (m3 m-3)
 
+// Maximum changes of forcing and states since the last full land surface step, below which land surface steps are
+// skipped in inactive elements
+#define SKIP_DTEMP              0.2         // air and skin temperature (K)
+#define SKIP_DRAD               10.0        // downward solar and longwave radiation (W m-2)
+#define SKIP_DQ                 2E-4        // mixing ratio (kg kg-1)
+#define SKIP_DWIND              0.5         // wind speed (m s-1)
+#define SKIP_DPRES              100.0       // surface pressure (Pa)
+#define SKIP_DLAI               0.05        // leaf area index (m2 m-2)
+#define SKIP_DSMC               1E-3        // soil moisture content (m3 m-3)
+
 // Maximum of soil layers in Flux-PIHM
 #define MAXLYR                  11
 
@@ -169,6 +179,14 @@
 #define RELAX                   0
 #define RST_FILE                1
 
+// Preconditioner type
+#define NO_PRECOND              0
+#define BLOCK_PRECOND           1
+
+// Element and river segment renumbering
+#define NO_RENUMBER             0
+#define RCM_RENUMBER            1
+
 // Average flux
 #define SUM                     0
 #define AVG                     1
@@ -177,6 +195,55 @@
 #define NO_INTRPL               0
 #define INTRPL                  1
 
+// Output writer
+#define WRITER_BATCH_SIZE       1048576     // target size of record batches handed to writer thread (bytes)
+#define WRITER_QUEUE_LEN        64          // maximum number of batches waiting in writer queue
+
+// Binary output format
+#define DAT_OUTPUT              0
+#define CHUNK_OUTPUT            1
+
+// Chunked output
+#define CHUNK_MAGIC             "PIHMCHK1"
+#define CHUNK_IDX_MAGIC         "PIHMIDX1"
+#define CHUNK_COLS              256         // number of columns in each compressed block
+#define CHUNK_RAW               0
+#define CHUNK_LZ                1
+
+// Binary meteorological forcing
+#define METEO_MAGIC             "PIHMMET1"
+#define METEO_HEADER_SIZE       16          // size of file header (bytes)
+#define METEO_SERIES_SIZE       32          // size of each series table entry (bytes)
+
+// Checkpoint files
+#define CKPT_MAGIC              "PIHMCKP1"
+#define CKPT_WRITE              0
+#define CKPT_READ               1
+
+// Timed phases
+#define NUM_TIMER               21
+#define TM_STEP                 0           // model step, i.e., the PIHM function
+#define TM_APPLY_BC             1           // boundary conditions
+#define TM_FORCING              2           // meteorological forcing
+#define TM_LSM                  3           // land surface model (Noah or interception, snow, and ET)
+#define TM_REACTION             4           // kinetic reactions
+#define TM_DAILY                5           // daily modules (Cycles or BGC)
+#define TM_CVODE                6           // CVODE solver
+#define TM_RHS                  7           // right-hand side evaluations
+#define TM_PREC_SETUP           8           // preconditioner setup
+#define TM_PREC_SOLVE           9           // preconditioner solve
+#define TM_HALO                 10          // halo exchange
+#define TM_HYDROL_STATE         11          // hot state of hydrology kernels
+#define TM_ET_UPTAKE            12          // ET water sources
+#define TM_LATERAL              13          // lateral flow
+#define TM_VERTICAL             14          // vertical flow
+#define TM_RIVER                15          // river flow
+#define TM_TRANSPT              16          // solute concentrations and transport
+#define TM_GATHER               17          // gathering of state variables and fluxes
+#define TM_UPDATE               18          // update of model variables after solver step
+#define TM_PRINT                19          // water balance and model output
+#define TM_STARTUP              20          // reading input, initialization, and creation of output files
+
 // Maximum allowable difference between simulation cycles in subsurface water storage at steady-state (m)
 #define SPINUP_W_TOLERANCE      0.01
 
@@ -250,6 +317,10 @@
 #define KIN_REACTION            0
 #define TRANSPORT_ONLY          1
 
+// RT reaction Jacobian types
+#define FD_JAC                  0
+#define ANALYTIC_JAC            1
+
 // RT primary species types
 #define AQUEOUS                 1
 #define ADSORPTION              2
@@ -485,6 +556,7 @@ enum output_var{
 extern int     verbose_mode;
 extern int     debug_mode;
 extern int     append_mode;
+extern int     resume_mode;
 extern int     corr_mode;
 extern int     spinup_mode;
 extern int     fixed_length;
@@ -48,9 +48,11 @@
 #if defined(_WIN32) || defined(_WIN64)
 # define pihm_mkdir(path)       _mkdir((path))
 # define pihm_access(path, amode) _access((path), (amode))
+# define pihm_ftruncate(fp, size) _chsize(_fileno((fp)), (size))
 #else
 # define pihm_mkdir(path)       mkdir(path, 0755)
 # define pihm_access(path, amode) access((path), (amode))
+# define pihm_ftruncate(fp, size) ftruncate(fileno((fp)), (size))
 #endif
 #if defined(_MSC_VER)
 # define timegm                 _mkgmtime
@@ -73,7 +75,9 @@ int             feenableexcept(int);
 // Function Declarations
 void            _InitLc(const lctbl_struct *, const calib_struct *, elem_struct *);
 double          _WsAreaElev(int, const elem_struct *);
-void            AdjCVodeMaxStep(void *, ctrl_struct *);
+void            AddDepCell(int, int, int [], int [], int *);
+void            AddElemNabr(int, int, int, const elem_struct [], int [], int [], int *);
+void            AdjCVodeMaxStep(void *, ctrl_struct *, cvstat_struct *);
 #if defined(_RT_)
 void            ApplyBc(int, const rttbl_struct *, forc_struct *, elem_struct [], river_struct []);
 #else
@@ -85,9 +89,10 @@ void            ApplyElemBc(int, const rttbl_struct *, forc_struct *, elem_struc
 void            ApplyElemBc(int, forc_struct *, elem_struct []);
 #endif
 #if defined(_RT_)
-void            ApplyForcing(int, int, const siteinfo_struct *, const rttbl_struct *, forc_struct *, elem_struct []);
+void            ApplyForcing(int, int, const siteinfo_struct *, const sun_struct *, const rttbl_struct *, forc_struct *,
+    elem_struct []);
 #elif defined(_NOAH_)
-void            ApplyForcing(int, int, const siteinfo_struct *, forc_struct *, elem_struct []);
+void            ApplyForcing(int, int, const siteinfo_struct *, const sun_struct *, forc_struct *, elem_struct []);
 #else
 void            ApplyForcing(int, forc_struct *, elem_struct []);
 #endif
@@ -97,7 +102,7 @@ void            ApplyLai(elem_struct []);
 void            ApplyLai(int, forc_struct *, elem_struct []);
 #endif
 #if defined(_NOAH_)
-void            ApplyMeteoForcing(int, int, const siteinfo_struct *, forc_struct *, elem_struct []);
+void            ApplyMeteoForcing(int, int, const siteinfo_struct *, const sun_struct *, forc_struct *, elem_struct []);
 #else
 void            ApplyMeteoForcing(int, forc_struct *, elem_struct []);
 #endif
@@ -106,43 +111,75 @@ double          AvgKv(double, double, const soil_struct *);
 double          AvgH(double, double, double);
 double          AvgHsurf(double, double, double);
 void            BackupInput(const char [], const filename_struct *);
+int             Bandwidth(const elem_struct []);
 void            BoundFluxElem(int, int, const topo_struct *, const soil_struct *, const bc_struct *,
     const wstate_struct *, wflux_struct *);
 double          BoundFluxRiver(int, const river_topo_struct *, const shp_struct *, const matl_struct *,
     const river_bc_struct *, const river_wstate_struct *);
+void            BuildVgTbl(int, double, vgtbl_struct *);
 void            CalcModelSteps(ctrl_struct *);
-double          ChannelFlowElemToRiver(double, double, const river_struct *, elem_struct *);
+int             CellStateVar(int, sunindextype []);
+double          ChannelFlowElemToRiver(int, double, const hydro_struct *, const river_struct *);
 double          ChannelFlowRiverToRiver(const river_struct *, const river_struct *);
 void            CheckCVodeFlag(int);
 int             CheckHeader(const char [], int , ...);
+void            CheckpointCVode(int, void *, sunindextype, FILE *);
+void            CheckpointFile(int, FILE *, FILE *);
+void            CheckpointFn(const pihm_struct, char []);
+void            CheckpointHeader(int, const pihm_struct, const char [], FILE *);
+void            CheckpointIo(int, void *, size_t, size_t, FILE *);
+void            CheckpointModel(int, pihm_struct, FILE *);
+void            CheckpointOutput(int, print_struct *, FILE *);
+void            CheckpointPrec(int, prec_struct *, FILE *);
+void            CheckpointState(int, pihm_struct, const char [], FILE *);
 #if defined(_BGC_)
-int             CheckSteadyState(int, int, int, double, const elem_struct []);
+int             CheckSteadyState(int, int, int, double, const elem_struct [], ctx_struct *);
 #else
-int             CheckSteadyState(int, int, double, const elem_struct []);
+int             CheckSteadyState(int, int, double, const elem_struct [], ctx_struct *);
 #endif
+void            CheckVgTbl(const vgtbl_struct *);
+void            ClaimWriter(writer_struct *);
+int             CompareInd(const void *, const void *);
+int             CompareIndexPair(const void *, const void *);
 void            CorrectElev(const river_struct [], elem_struct []);
+tsdata_struct  *CopySeries(int, const tsdata_struct []);
+pihm_struct     CreateMember(const pihm_struct, const char [], const char []);
 void            CreateOutputDir(char []);
+pihm_struct     CreatePihm(const char [], const char []);
+void            DestroyPihm(pihm_struct);
 double          DhByDl(const double [], const double [], const double []);
+double          DSurfH(double);
 double          EffKh(double, const soil_struct *);
 double          EffKinf(double, double, double, double, double, const soil_struct *);
 double          EffKv(const soil_struct *, double, int);
+void            ElemJac(double, const hydro_struct *, const elem_struct [], const river_struct [], realtype **);
 void            EtUptake(elem_struct []);
 double          FieldCapacity(double, double, double, double);
+int             FindCheckpoint(const pihm_struct);
+int             FindChunkFrame(FILE *, double, int64_t *);
+void            FlushWriter(int, varctrl_struct [], writer_struct *);
+int             ForcingRecord(int, tsdata_struct *);
 void            FreeAtttbl(atttbl_struct *);
 void            FreeCtrl(ctrl_struct *);
 void            FreeForc(forc_struct *);
+void            FreeInput(pihm_struct);
 void            FreeLctbl(lctbl_struct *);
 void            FreeMatltbl(matltbl_struct *);
 void            FreeMeshtbl(meshtbl_struct *);
 void            FreeMem(pihm_struct);
+void            FreeMemberForc(int, forc_struct *);
+void            FreeOrder(order_struct *);
+void            FreePrec(prec_struct *);
 void            FreeRivtbl(rivtbl_struct *);
 void            FreeShptbl(shptbl_struct *);
 void            FreeSoiltbl(soiltbl_struct *);
-void            FrictionSlope(const elem_struct [], const river_struct [],
-    double [], double []);
-void            Hydrol(const ctrl_struct *, elem_struct [], river_struct []);
+void            FreeVgTbl(int, vgtbl_struct []);
+void            FreeHydro(hydro_struct *);
+void            FrictionSlope(hydro_struct *);
+void            Hydrol(const ctrl_struct *, hydro_struct *, timing_struct *, elem_struct [], river_struct []);
 double          Infil(double, const topo_struct *, const soil_struct *, const wstate_struct *, const wstate_struct *,
     const wflux_struct *);
+void            InitEdgeList(hydro_struct *);
 void            InitEFlux(eflux_struct *);
 void            InitEState(estate_struct *);
 #if defined(_RT_)
@@ -151,9 +188,12 @@ void            InitForcing(const rttbl_struct *, const calib_struct *, forc_str
 void            InitForcing(const calib_struct *, forc_struct *, elem_struct []);
 #endif
 void            Initialize(pihm_struct, N_Vector, void **);
+void            InitHydro(const elem_struct [], const river_struct [], hydro_struct *);
 void            InitLc(const lctbl_struct *, const calib_struct *, elem_struct []);
 void            InitMesh(const meshtbl_struct *, elem_struct []);
-void            InitOutputFiles(const char [], int, int, print_struct *);
+void            InitOutputFiles(const char [], int, int, int, int, int, print_struct *);
+void            InitPihm(pihm_struct);
+void            InitPrec(prec_struct *);
 void            InitPrintCtrl(const char [], const char [], int, int, int, varctrl_struct *);
 void            InitRiver(const meshtbl_struct *, const rivtbl_struct *, const shptbl_struct *, const matltbl_struct *,
     const calib_struct *, elem_struct [], river_struct []);
@@ -165,15 +205,28 @@ void            InitSoil(const soiltbl_struct *, const noahtbl_struct *, const c
 void            InitSoil(const soiltbl_struct *, const calib_struct *, elem_struct []);
 #endif
 void            InitSurfL(const meshtbl_struct *, elem_struct []);
+void            InitTimingFile(FILE *);
 void            InitTopo(const meshtbl_struct *, elem_struct []);
+void            InitUpstreamList(const river_struct [], hydro_struct *);
 void            InitVar(elem_struct [], river_struct [], N_Vector);
+vgtbl_struct   *InitVgTbl(int, int *, elem_struct []);
 void            InitWbFile(char *, char *, FILE *);
 void            InitWFlux(wflux_struct *);
 void            InitWState(wstate_struct *);
+void            InitWriter(int, int, varctrl_struct [], writer_struct *);
 void            IntcpSnowEt(int, double, const calib_struct *, elem_struct []);
 void            IntrplForcing(int, int, int, tsdata_struct *);
+void            IntrplForcingBatch(int, int, int, int, tsdata_struct []);
 double          KrFunc(double, double);
-void            LateralFlow(const river_struct [], elem_struct []);
+double          KrFuncDeficit(double, double);
+void            LateralFlow(hydro_struct *, elem_struct []);
+void            LinkVgTbl(int, const vgtbl_struct [], elem_struct []);
+void            LoadContext(const pihm_struct);
+size_t          LzBound(size_t);
+size_t          LzCompress(const unsigned char [], size_t, unsigned char []);
+size_t          LzDecompress(const unsigned char [], size_t, unsigned char [], size_t);
+void            LzLength(size_t, unsigned char [], size_t *);
+void            MapMeteo(const char [], forc_struct *);
 #if defined(_CYCLES_)
 void            MapOutput(const char [], const int [], const crop_struct [], const elem_struct [],
     const river_struct [], print_struct *);
@@ -198,24 +251,33 @@ int             Ode(realtype, N_Vector, N_Vector, void *);
 double          OutletFlux(int, const river_topo_struct *, const shp_struct *, const matl_struct *,
     const river_bc_struct *, const river_wstate_struct *);
 double          OverLandFlow(double, double, double, double, double);
-double          OvlFlowElemToElem(int, double, const elem_struct *, const elem_struct *);
-double          OvlFlowElemToRiver(const river_struct *, elem_struct *);
-void            ParseCmdLineParam(int, char *[], char []);
+void            OvlFlowEdge(int, const hydro_struct *, double []);
+double          OvlFlowElemToRiver(int, const hydro_struct *, const river_struct *);
+void            ParseCmdLineParam(int, char *[], char [], char []);
 void            PIHM(double, pihm_struct, void *, N_Vector); pihm_t_struct   PIHMTime(int);
+void            PermuteDomain(const int [], const int [], const order_struct *, elem_struct [], river_struct []);
+void            PermuteStateVar(const int [], const int [], N_Vector);
+int             PrecSetup(realtype, N_Vector, N_Vector, booleantype, booleantype *, realtype, void *);
+int             PrecSolve(realtype, N_Vector, N_Vector, N_Vector, N_Vector, realtype, realtype, int, void *);
 void            PrintCVodeFinalStats(void *);
-void            PrintData(int, int, int, int, varctrl_struct *);
-void            PrintInit(const char [], int, int, int, int, const elem_struct [], const river_struct []);
+void            PrintData(int, int, int, int, writer_struct *, varctrl_struct *);
+void            PrintInit(const char [], int, int, int, int, const order_struct *, const elem_struct [],
+    const river_struct []);
 int             PrintNow(int, int, pihm_t_struct);
-void            PrintPerf(int, int, double, double, double, FILE *, void *);
-void            PrintWaterBalance(int, int, int, const elem_struct [], const river_struct [], FILE *);
+void            PrintPerf(int, int, double, double, double, FILE *, void *, cvstat_struct *);
+void            PrintTiming(int, int, int, timing_struct *, FILE *);
+void            PrintWaterBalance(int, int, int, const elem_struct [], const river_struct [], FILE *,
+    ctx_struct *);
 void            ProgressBar(double);
 double          Psi(double, double, double);
+double          PsiDeficit(double, double, double);
 double          PtfAlpha(double, double, double, double, int);
 double          PtfBeta(double, double, double, double, int);
 double          PtfKv(double, double, double, double, int);
 double          PtfThetar(double, double);
 double          PtfThetas(double, double, double, double, int);
 double          Qtz(int);
+void            RcmOrder(const elem_struct [], int []);
 void            ReadAlloc(pihm_struct);
 void            ReadAtt(const char [], atttbl_struct *);
 #if defined(_RT_)
@@ -225,6 +287,12 @@ void            ReadBc(const char [], const atttbl_struct *, const chemtbl_struc
 void            ReadBc(const char [], const atttbl_struct *, forc_struct *);
 #endif
 void            ReadCalib(const char [], calib_struct *);
+char          **ReadEnsemble(const char [], int *);
+void            ReadCheckpoint(pihm_struct);
+int             ReadChunk(FILE *, int *, int *, double **, int64_t **);
+int             ReadChunkBlock(FILE *, int, int, int, const int64_t [], double []);
+int             ReadChunkHeader(FILE *, int *, int *);
+int             ReadChunkIndexHeader(FILE *);
 void            ReadMeteo(const char [], forc_struct *);
 void            ReadIc(const char [], elem_struct [], river_struct []);
 int             ReadKeyword(const char [], const char [], char, const char [], int, void *);
@@ -237,31 +305,79 @@ void            ReadRiver(const char [], rivtbl_struct *, shptbl_struct *, matlt
 void            ReadSoil(const char [], soiltbl_struct *);
 int             ReadTs(const char [], int, int *, double *);
 double          Recharge(const soil_struct *, const wstate_struct *, const wflux_struct *);
+void            Renumber(int, order_struct *, elem_struct [], river_struct [], N_Vector);
+void            RenumberOutput(const order_struct *, const elem_struct [], const river_struct [], print_struct *);
+void            ResetForcing(forc_struct *);
 double          RiverCrossSectArea(int, double, double);
 double          RiverEqWid(int, double, double);
-void            RiverFlow(elem_struct [], river_struct []);
+int             RiverEdge(const elem_struct *, int);
+void            RiverFlow(hydro_struct *, elem_struct [], river_struct []);
+void            RiverJac(const hydro_struct *, const elem_struct [], const river_struct [], realtype **);
+void            RiverOrder(const int [], const river_struct [], int []);
 double          RiverPerim(int, double, double);
-void            RiverToElem(river_struct *, elem_struct *, elem_struct *);
+void            RiverToElem(int, const hydro_struct *, elem_struct [], river_struct *);
 int             roundi(double);
 #if defined(_OPENMP)
-void            RunTime(double, double *, double *);
+void            RunTime(double, double *, double *, double *);
 #else
-void            RunTime (clock_t, double *, double *);
+void            RunTime (clock_t, clock_t *, double *, double *);
 #endif
 void            RelaxIc(elem_struct [], river_struct []);
+void            RunEnsemble(const char [], const char []);
+void            SaveContext(pihm_struct);
+double          Secant(double, double);
+void            ShareForc(const forc_struct *, const calib_struct *, forc_struct *, int *);
+void            Shuffle(const unsigned char [], size_t, unsigned char []);
+int             SkipChunk(FILE *, int, const int64_t []);
 void            SetCVodeParam(pihm_struct, void *, SUNLinearSolver *, N_Vector);
 int             SoilTex(double, double);
 void            SolveCVode(double, const ctrl_struct *, int *, void *, N_Vector);
-void            Spinup(pihm_struct, N_Vector, void *, SUNLinearSolver *);
+void            Spinup(pihm_struct);
+void            SpinupPihm(pihm_struct);
 void            StartupScreen(void);
+int             StepPihm(pihm_struct);
+void            SubmitRecords(writer_struct *, varctrl_struct *);
+void            SyncOwnedWriters(void);
+void            SyncWriter(int, varctrl_struct [], writer_struct *);
 int             StrTime(const char []);
-double          SubsurfFlow(int, const elem_struct *, const elem_struct *);
+double          SubsurfFlow(int, int, const hydro_struct *);
+void            SubsurfFlowEdge(int, const hydro_struct *, double []);
 void            UpdateVar(double, elem_struct [], river_struct [], N_Vector);
 double          SurfH(double);
+void            TimerStart(int, timing_struct *);
+void            TimerStop(int, timing_struct *);
 void            UpdatePrintVar(int, int, varctrl_struct *);
 void            UpdPrintVarT(varctrl_struct *, int);
+void            Unshuffle(const unsigned char [], size_t, unsigned char []);
+int             UseMeteoBin(const char [], const char []);
 void            VerticalFlow(double, elem_struct []);
+void            VgFunc(double, const soil_struct *, double *, double *);
+void            VgTblLookup(double, const vgtbl_struct *, double *, double *);
+double          WallTime(void);
 double          WiltingPoint(double, double, double, double);
+void            WriteCheckpoint(pihm_struct);
+void            WriteChunk(int, int, const double [], FILE *, FILE *);
+void            WriteChunkHeader(int, FILE *);
+void            WriteChunkIndexHeader(FILE *);
+void            WriteMeteoBin(const char [], const forc_struct *);
+void            WriteRecords(int, wrreq_struct *);
+void            WriteTiming(const char [], const timing_struct *);
+void           *WriterThread(void *);
+
+// MPI functions
+#if defined(_MPI_)
+void            ElemStateVar(int, int []);
+void            ExchangeHalo(const double [], mpi_struct *, double []);
+void            FreeDecomp(mpi_struct *);
+void            GatherFlux(mpi_struct *, elem_struct [], river_struct []);
+void            GatherState(const double [], mpi_struct *, double []);
+void            GlobalState(const double [], const mpi_struct *, double []);
+void            InitDecomp(const elem_struct [], const river_struct [], mpi_struct *);
+void            LocalEdgeList(const mpi_struct *, hydro_struct *);
+void            LocalState(const double [], const mpi_struct *, double []);
+void            PackElemFlux(const elem_struct *, double []);
+void            UnpackElemFlux(const double [], elem_struct *);
+#endif
 
 // DGW functions
 #if defined(_DGW_)
@@ -276,11 +392,24 @@ void            ReadBedrock(const char [], meshtbl_struct *, atttbl_struct *, ct
 void            ReadGeol(const char *, geoltbl_struct *);
 #endif
 
+// Vectorized kernels
+#if defined(_VEC_)
+void            FreeHydroVec(hydro_struct *);
+void            InitHydroVec(const river_struct [], hydro_struct *);
+void            OvlFlowVec(hydro_struct *);
+void            RiverFlowVec(hydro_struct *);
+#endif
+
 // Noah functions
 #if defined(_NOAH_)
 void            AdjustSmcProfile(double, const double [], const soil_struct *, const phystate_struct *, wstate_struct *,
     wflux_struct *);
 void            AlCalc(int, double, phystate_struct *);
+double          Azimuth(double, double);
+void            BoxDirections(double, double, const double [], int *, int *);
+double          BoxDistance(double, double, const double []);
+void            BuildHorizonGrid(int, const hrzn_edge_struct [], hrzn_grid_struct *);
+void            CalcHorizon(double, const meshtbl_struct *, elem_struct []);
 void            CalcLateralFlux(const phystate_struct *, wflux_struct *);
 void            CalcSlopeAspect(const meshtbl_struct *, elem_struct []);
 void            CalHum(phystate_struct *, estate_struct *);
@@ -290,11 +419,13 @@ void            CanRes(const estate_struct *, phystate_struct *);
 void            CanRes(const soil_struct *, const epconst_struct *, const wstate_struct *, const estate_struct *,
     const eflux_struct *, phystate_struct *);
 # endif
+int             CompareNodePair(const void *, const void *);
 double          CSnow(double);
 void            DefineSoilDepths(int, double, const double [], int *, double [],
     double []);
 void            DEvap(const soil_struct *, const lc_struct *, const phystate_struct *, const wstate_struct *,
     wflux_struct *);
+void            EdgeHorizon(double, const hrzn_edge_struct *, topo_struct *);
 # if defined(_CYCLES_)
 void            Evapo(const soil_struct *, const lc_struct *, const weather_struct *, const phystate_struct *,
     const estate_struct *es, const cstate_struct *, crop_struct [], wstate_struct *, wflux_struct *);
@@ -303,18 +434,28 @@ void            Evapo(double, const soil_struct *, const lc_struct *, const phys
     wflux_struct *);
 # endif
 int             FindLayer(double, int, const double []);
+void            FreeSun(sun_struct *);
 int             FindWaterTable(int, double, const double [], double []);
 double          FrozRain(double, double);
+double          FrzFcr(const double [], const phystate_struct *);
 double          GwTranspFrac(int, int, double, const double []);
+unsigned long long HashBytes(unsigned long long, const void *, size_t);
+unsigned long long HorizonChecksum(double, const meshtbl_struct *, const elem_struct []);
+int             HorizonGridCell(double, double, const hrzn_grid_struct *);
 void            HRT(double, double, double, double, const soil_struct *, const lc_struct *, const phystate_struct *,
     const estate_struct *, double [], double [], double [], double [], wstate_struct *);
 void            HStep(int, double, double [], double [], double [], double [], estate_struct *);
 void            IcePac(int, double, double, double, double, const soil_struct *, const lc_struct *, phystate_struct *,
     wstate_struct *, wflux_struct *, estate_struct *, eflux_struct *);
+void            InitActivity(elem_struct *);
+void            InitHorizon(const char [], int, double, const meshtbl_struct *, elem_struct []);
+void            InitHorizonCell(hrzn_cell_struct *);
 void            InitLsm(const char [], const ctrl_struct *, const noahtbl_struct *, const calib_struct *,
     elem_struct []);
+void            InitSun(const ctrl_struct *, const siteinfo_struct *, sun_struct *);
+double          MaxHorizon(int, int, const double []);
 double          Mod(double, double);
-void            Noah(double, const lctbl_struct *, const calib_struct *, elem_struct []);
+void            Noah(double, int, const lctbl_struct *, const calib_struct *, elem_struct []);
 void            NoahHydrol(double, elem_struct []);
 # if defined(_CYCLES_)
 void            NoPac(double, double, const soil_struct *, const lc_struct *, const weather_struct *,
@@ -329,6 +470,7 @@ void            Penman(int, int, double, const estate_struct *, double *, physta
     eflux_struct *);
 void            PenmanGlacial(int, int, double, const estate_struct *, double *, phystate_struct *, wflux_struct *,
     eflux_struct *);
+void            PrintLsmSkip(const elem_struct []);
 double          Pslhs(double);
 double          Pslhu(double);
 double          Pslms(double);
@@ -338,11 +480,15 @@ double          Psphu(double);
 double          Pspms(double);
 double          Pspmu(double);
 void            ReadGlacierIce(const char [], double[]);
+int             ReadHorizon(const char [], double, const meshtbl_struct *, elem_struct []);
 void            ReadLsm(const char [], ctrl_struct *, siteinfo_struct *, noahtbl_struct *);
 void            ReadRad(const char [], forc_struct *);
+void            RecordLsm(double, elem_struct *);
 void            RootDist(int, int, const double [], double []);
 void            Rosr12(int, const double [], const double [], const double [], double [], double [], double []);
+void            SearchHorizon(double, const hrzn_edge_struct [], const hrzn_grid_struct *, topo_struct *);
 void            SfcDifOff(int, double, double, const lc_struct *, phystate_struct *);
+void            SetSunPos(const spa_data *, sunpos_struct *);
 # if defined(_CYCLES_)
 void            SFlx(double, const weather_struct *, const cstate_struct *, soil_struct *, lc_struct *, crop_struct [],
     phystate_struct *, wstate_struct *, wflux_struct *, estate_struct *, eflux_struct *);
@@ -354,7 +500,13 @@ void            SFlxGlacial(double, soil_struct *, lc_struct *, phystate_struct
     estate_struct *, eflux_struct *);
 void            ShFlx(double, double, double, double, const soil_struct *, const lc_struct *, const phystate_struct *,
     wstate_struct *, estate_struct *);
+int             SkipHorizonCell(double, const hrzn_cell_struct *, const topo_struct *);
+int             SkipLsm(int, double, elem_struct *);
+double          SkyViewFactor(const topo_struct *);
 void            SmFlx(double, const soil_struct *, phystate_struct *, wstate_struct *, wflux_struct *);
+# if defined(_VEC_)
+void            SmFlxVec(double, elem_struct []);
+# endif
 double          SnFrac(double, double, double);
 void            SnkSrc(int, double, double, double, double, const double [], const soil_struct *, double *, double *);
 # if defined(_CYCLES_)
@@ -367,19 +519,24 @@ void            SnoPac(int, double, double, double, double, const soil_struct *,
 # endif
 void            SnowNew(double, const estate_struct *, phystate_struct *);
 void            SnowPack(double, double, double, double, double *, double *);
+double          SpaDayLength(const spa_data *);
 double          Snowz0(double, double, double);
 void            SRT(const soil_struct *, double [], double [], double [], double [], double [], phystate_struct *,
     wstate_struct *, wflux_struct *);
 void            SStep(double, const soil_struct *, double [], double [], double [], double [], double [],
     phystate_struct *, wstate_struct *, wflux_struct *);
-void            SunPos(int, const siteinfo_struct *, spa_data *);
+void            SunPos(int, int, const siteinfo_struct *, spa_data *);
+void            SunPosition(int, const siteinfo_struct *, const sun_struct *, sunpos_struct *);
 double          TBnd(int, int, double, double, double, const double []);
 double          TDfCnd(double, double, double, double, double);
+hrzn_edge_struct *TerrainEdges(const meshtbl_struct *, const elem_struct [], int *);
 double          TmpAvg(int, double, double, double, const double []);
-double          TopoRadn(double, double, double, double, const topo_struct *);
+double          TopoRadn(double, double, const sunpos_struct *, const topo_struct *);
+void            TopoRadnBatch(const sunpos_struct *, elem_struct []);
 void            Transp(const soil_struct *, const lc_struct *, const phystate_struct *, const wstate_struct *,
     wflux_struct *);
 void            WDfCnd(double, double, const soil_struct *, double *, double *);
+void            WriteHorizon(const char [], double, const meshtbl_struct *, const elem_struct []);
 #endif
 
 #if defined(_DAILY_)
@@ -394,10 +551,11 @@ void            SetAbsTolArray(double, N_Vector);
 #endif
 
 #if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
-double          AdvDiffDisp(double, double, double, double, double, double, double, double, double);
+double          AdvDiffDisp(double, double, double, double, double);
+double          DiffCoef(double, double, double, double, double);
 void            InitSolute(elem_struct []);
-void            RiverElemSoluteFlow(int, int, elem_struct *, river_struct *);
-void            SoluteTranspt(double, double, double, elem_struct [], river_struct []);
+void            RiverElemSoluteFlow(int, int, int, elem_struct *, river_struct *);
+void            SoluteTranspt(double, double, double, const hydro_struct *, elem_struct [], river_struct []);
 #endif
 
 #if defined(_BGC_) || defined(_CYCLES_)
@@ -418,6 +576,7 @@ void            DailyAllocation(const epconst_struct *, const cstate_struct *, c
 void            DailyBgc(int, pihm_struct);
 void            DailyCarbonStateUpdate(int, int, int, cstate_struct *, cflux_struct *);
 void            DailyNitrogenStateUpdate(int, int, int, nstate_struct *, nflux_struct *, solute_struct *);
+double          DayLength(int, const siteinfo_struct *, const sun_struct *);
 void            Decomp(double, const epconst_struct *, const cstate_struct *, const nstate_struct *, epvar_struct *,
     cflux_struct *, nflux_struct *, ntemp_struct *);
 void            EvergreenPhenology(const epconst_struct *, const cstate_struct *, epvar_struct *);
@@ -457,7 +616,7 @@ void            SoilPsi(const soil_struct *, double, double *);
 void            SoluteConc(elem_struct [], river_struct []);
 void            TotalPhotosynthesis(const epconst_struct *, const daily_struct *, const phystate_struct *,
     epvar_struct *, cflux_struct *, psn_struct *, psn_struct *);
-void            WriteBgcIc(const char [], elem_struct [], river_struct []);
+void            WriteBgcIc(const char [], const order_struct *, elem_struct [], river_struct []);
 void            ZeroSrcSnk(cstate_struct *, nstate_struct *, summary_struct *, solute_struct *);
 #endif
 
@@ -466,7 +625,8 @@ double          AdjustClipThld(double, double);
 void            AdjustThermalTime(crop_struct *);
 double          Aeration(double);
 double          AirMolarDensity(double, double);
-void            ApplyDailyMeteoForcing(int, int, const siteinfo_struct *, forc_struct *, elem_struct []);
+void            ApplyDailyMeteoForcing(int, int, const siteinfo_struct *, const sun_struct *, forc_struct *,
+    elem_struct []);
 void            ApplyFert(const fert_struct *fixed_fert, const phystate_struct *phys, cstate_struct *cs,
     nstate_struct *ns, nflux_struct *nf);
 void            AutoIrrig(int, const crop_struct [], const airrig_struct [], const soil_struct *, const wstate_struct *,
@@ -621,7 +781,7 @@ double          VolWCAt1500Jkg(double, double, double);
 double          WaterContentLimitToEvap(double, double, double);
 void            WaterUptake(double, const soil_struct *, const weather_struct *, const phystate_struct *,
     crop_struct [], wstate_struct *, wflux_struct *);
-void            WriteCyclesIc(const char [], const elem_struct []);
+void            WriteCyclesIc(const char [], const order_struct *, const elem_struct []);
 void            ZeroFluxes(wflux_struct *, cflux_struct *, nflux_struct *);
 void            ZeroHarvest(crop_struct *);
 void            NRT(double, double, double [], const soil_struct *, const wstate_struct *, const wstate_struct *,
@@ -629,16 +789,21 @@ void            NRT(double, double, double [], const soil_struct *, const wstate
 #endif
 
 #if defined(_RT_)
+void            FreeRTWork(rtwork_struct []);
 void            InitChem(const char [], const calib_struct *, forc_struct *forc, chemtbl_struct [], kintbl_struct [],
     rttbl_struct *, chmictbl_struct *, elem_struct []);
-void            Reaction(double, const chemtbl_struct [], const kintbl_struct [], const rttbl_struct *, elem_struct []);
+rtwork_struct  *InitRTWork(const rttbl_struct *);
+void            Reaction(double, const chemtbl_struct [], const kintbl_struct [], const rttbl_struct *,
+    rtwork_struct [], elem_struct []);
 int             SolveReact(double, const chemtbl_struct [], const kintbl_struct [], const rttbl_struct *, double, double,
-    chmstate_struct *);
+    rtwork_struct *, chmstate_struct *);
 void            ReactControl(const chemtbl_struct [], const kintbl_struct [], const rttbl_struct *, double, double,
-    double, chmstate_struct *, double []);
+    double, rtwork_struct *, chmstate_struct *, double []);
+void            ReactJac(double, double, const chemtbl_struct [], const kintbl_struct [], const rttbl_struct *,
+    const double [], const double [], const double [], const double [], const double [], realtype **);
 void            Lookup(FILE *, const calib_struct *, chemtbl_struct [], kintbl_struct [], rttbl_struct *);
-void            RiverSpeciation(const chemtbl_struct [], const rttbl_struct *, river_struct []);
-void            Speciation(const chemtbl_struct [], const rttbl_struct *, int, chmstate_struct *);
+void            RiverSpeciation(const chemtbl_struct [], const rttbl_struct *, rtwork_struct [], river_struct []);
+void            Speciation(const chemtbl_struct [], const rttbl_struct *, int, rtwork_struct *, chmstate_struct *);
 int             SpeciesType(FILE *, const char []);
 void            Unwrap(const char [], char []);
 double          EqvUnsatH(double, double, double, double, double);
@@ -653,7 +818,8 @@ void            ApplyPrcpConc(int, const  rttbl_struct *, forc_struct *, elem_st
 void            Wrap(char *);
 void            SoluteConc(const chemtbl_struct [], const rttbl_struct *, elem_struct [], river_struct []);
 void            RTUpdate(const rttbl_struct *, elem_struct [], river_struct []);
-void            InitRTVar(const chemtbl_struct [], const rttbl_struct *, elem_struct [], river_struct [], N_Vector);
+void            InitRTVar(const chemtbl_struct [], const rttbl_struct *, rtwork_struct *, elem_struct [],
+    river_struct [], N_Vector);
 int             MatchWrappedKey(const char [], const char []);
 void            ReadTempPoints(const char [], double, int *, int *);
 void            ReadDHParam(const char [], int, double *);
@@ -665,11 +831,13 @@ void            ReadAdsorption(const char [], int, int, chemtbl_struct [], rttbl
 void            ReadCationEchg(const char [], double, chemtbl_struct [], rttbl_struct *);
 void            ReadMinKin(FILE *, int, double, int *, char [], chemtbl_struct [], kintbl_struct *);
 double          SoilTempFactor(double, double);
-void            InitChemS(const chemtbl_struct [], const rttbl_struct *, const rtic_struct *, double, double, chmstate_struct *);
+void            InitChemS(const chemtbl_struct [], const rttbl_struct *, const rtic_struct *, double, double,
+    rtwork_struct *, chmstate_struct *);
 void            ReadChemAtt(const char *, atttbl_struct *);
 void            ReadRtIc(const char *, elem_struct []);
 void            UpdatePrimConc(const rttbl_struct *, elem_struct [], river_struct []);
-void            WriteRtIc(const char *, const chemtbl_struct [], const rttbl_struct *, elem_struct []);
+void            WriteRtIc(const char *, const chemtbl_struct [], const rttbl_struct *, const order_struct *,
+    elem_struct []);
 #endif
 
 #endif
@@ -10,6 +10,7 @@ typedef struct filename_struct
     char            soil[MAXSTRING];        // soil property file
     char            lc[MAXSTRING];          // land cover property file
     char            meteo[MAXSTRING];       // meteorological forcing file
+    char            meteo_bin[MAXSTRING];   // binary meteorological forcing file
     char            lai[MAXSTRING];         // lai forcing file
     char            bc[MAXSTRING];          // boundary condition file
     char            para[MAXSTRING];        // control parameter file
@@ -37,6 +38,7 @@ typedef struct filename_struct
     char            lsm[MAXSTRING];         // land surface module control file
     char            rad[MAXSTRING];         // radiation forcing file
     char            ice[MAXSTRING];         // glacier ice file
+    char            horizon[MAXSTRING];     // horizon angle cache file
 #endif
 #if defined(_RT_)
     char            cdbs[MAXSTRING];        // chemistry database file
@@ -208,6 +210,7 @@ typedef struct tsdata_struct
     int            *ftime;                  // forcing time
     double        **data;                   // forcing values at forcing time
     double         *value;                  // forcing values at model time t
+    int             cursor;                 // index of forcing record used at previous look-up
     union
     {
         int             bc_type;            // boundary condition type: 1 = Dirichlet, 2 = Neumann
@@ -222,6 +225,8 @@ typedef struct forc_struct
     tsdata_struct  *bc;                     // boundary condition time series
     int             nmeteo;                 // number of meteorological forcing series
     tsdata_struct  *meteo;                  // meteorological forcing series
+    void           *meteo_map;              // mapped binary meteorological forcing file
+    size_t          meteo_map_size;         // size of mapped binary meteorological forcing file
     int             nlai;                   // number of lai series
     tsdata_struct  *lai;                    // lai forcing series
     int             nsource;                // number of source forcing series
@@ -580,6 +585,7 @@ typedef struct rttbl_struct
     int             tmp_coup;               // flag to couple soil temperature
     int             rel_min;                // relative mineral flag: 1 = total solid volume, 0 = total pore volume
     int             transpt_flag;           // transport only flag: 0 = simulate kinetic reaction, 1 = transport only
+    int             jac_type;               // reaction Jacobian: 0 = finite difference, 1 = analytic
     double          cond;                   // ratio between infiltration concentration and rain water
     int             num_stc;                // number of total species
     int             num_spc;                // number of primary species
@@ -25,6 +25,31 @@ typedef struct siteinfo_struct
     double          tavg;                   // annual average air temperature (K)
 } siteinfo_struct;
 
+#if defined(_NOAH_)
+// Sun position at a given time
+typedef struct sunpos_struct
+{
+    double          zenith;                 // topocentric zenith angle (degree)
+    double          azimuth;                // topocentric azimuth angle, westward from south, [0, 360) (degree)
+    double          cos_zenith;             // cosine of zenith angle (-)
+    double          sin_zenith;             // sine of zenith angle (-)
+} sunpos_struct;
+
+// Solar ephemeris tables of the simulation period, which are calculated once using SPA at initialization
+typedef struct sun_struct
+{
+    int             t0;                     // time of the first Sun position (ctime)
+    int             dt;                     // interval between Sun positions (s)
+    int             nstep;                  // number of Sun positions
+    sunpos_struct  *pos;                    // Sun positions
+# if defined(_BGC_)
+    int             day0;                   // start time of the first day length (ctime)
+    int             nday;                   // number of day lengths
+    double         *dayl;                   // day length (s)
+# endif
+} sun_struct;
+#endif
+
 #if defined(_BGC_) || defined(_CYCLES_)
 // A structure to hold information on the annual CO2 concentration
 typedef struct co2control_struct
@@ -138,16 +163,28 @@ typedef struct calib_struct
 #endif
 } calib_struct;
 
+// Wall clock time and number of calls of timed model phases
+typedef struct timing_struct
+{
+    double          time[NUM_TIMER];        // accumulated time (s)
+    long int        calls[NUM_TIMER];       // number of calls
+    double          start[NUM_TIMER];       // time at the start of current call (s)
+    double          time_prev[NUM_TIMER];   // accumulated time at previous timing output (s)
+} timing_struct;
+
 // Model control parameters
 typedef struct ctrl_struct
 {
     int             ascii;                  // flag to turn on ascii output
     int             waterbal;               // flag to turn on water balance diagnostic output
     int             write_ic;               // flag to write model output as initial conditions
+    int             out_format;             // binary output format: 0 = .dat, 1 = chunked
     int             nstep;                  // number of external time steps (when results can be printed) for the whole
                                             // simulation
     int             cstep;                  // current model step (from 0)
     int             prtvrbl[MAXPRINT];      // number of output
+    int             checkpoint;             // checkpoint interval, 0 = no checkpoint
+    int             timing;                 // timing output interval, 0 = no timing output
     int             init_type;              // initialization mode: 0 = relaxed mode, 1 = use .ic file
     int             etstep;                 // land surface (ET) time step (s)
     int             starttime;              // start time of simulation (ctime)
@@ -165,6 +202,10 @@ typedef struct ctrl_struct
     double          decr;                   // decrease factor (-)
     double          incr;                   // increase factor (-)
     int             maxspinyears;           // maximum number of years for spinup run
+    int             precond;                // preconditioner type: 0 = none, 1 = physics-based block
+    int             renumber;               // renumbering of elements and river segments: 0 = none, 1 = RCM
+    int             soil_table;             // number of intervals in each binade of tabulated soil hydraulic
+                                            // functions, 0 = closed-form functions
 #if defined(_BGC_)
     int             read_bgc_restart;       // flag to read BGC restart file
     int             write_bgc_restart;      // flag to write BGC restart file
@@ -177,6 +218,9 @@ typedef struct ctrl_struct
     int             nlayers;                // number of standard soil layers
     double          soil_depth[MAXLYR];     // thickness of soil layer (m)
     int             rad_mode;               // radiation forcing mode: 0 = uniform, 1 = topographic
+    double          horizon_radius;         // maximum search distance for horizon angles, 0 = unlimited (m)
+    int             lsm_skip;               // maximum number of consecutive land surface steps skipped in inactive
+                                            // elements, 0 = no skipping
 #endif
 #if defined(_RT_)
     int             read_rt_restart;        // flag to read chemistry restart file
@@ -185,6 +229,123 @@ typedef struct ctrl_struct
 #endif
 } ctrl_struct;
 
+// Hydrology hot state structure. Variables used by hydrology right-hand side kernels are stored in contiguous arrays
+// (structure of arrays), so that lateral and river flux kernels do not need to access neighbors' element structures.
+// Edge variables are stored as [NUM_EDGE * element + edge]
+typedef struct hydro_struct
+{
+    int             nedge;                  // number of edges shared by two elements
+    int             nedge_ovl;              // number of shared edges without river segments, which are stored first
+                                            //   in the edge list
+    int            *edge_ind;               // edge indices [NUM_EDGE * element + edge] on the two sides of each shared
+                                            //   edge [2 * shared edge + 0 or 1]
+    int             nbound;                 // number of boundary edges
+    int            *bound_ind;              // edge indices [NUM_EDGE * element + edge] of boundary edges
+    int            *nabr;                   // neighbor element index (0-based), -1 if none (edge)
+    int            *nabr_river;             // neighbor river segment index (0-based), -1 if none (edge)
+    double         *x_nabr;                 // x of neighbor element centroid or river segment (edge) (m)
+    double         *y_nabr;                 // y of neighbor element centroid or river segment (edge) (m)
+    double         *dist_nabr;              // distance to neighbor (edge) (m)
+    double         *edge;                   // length of edge (edge) (m)
+    double         *area;                   // area of element (m2)
+    double         *zmax;                   // surface elevation (m)
+    double         *zmin;                   // soil bottom elevation (m)
+    double         *porosity;               // soil porosity (m3 m-3)
+    double         *rough;                  // surface roughness (s m-1/3)
+    double         *surfh;                  // actual surface water depth (m)
+    double         *gw;                     // groundwater storage (m)
+    double         *effk;                   // effective horizontal hydraulic conductivity (m s-1)
+    double         *sf;                     // magnitude of surface friction slope (-)
+    int            *bank_edge;              // edge of left and right bank elements adjacent to river segment
+                                            //   [2 * river segment + 0 (left) or 1 (right)]
+    double         *river_head;             // river water level seen by neighbor elements (m)
+    int            *up_ptr;                 // pointers to upstream segments of each river segment in up_ind (CSR)
+    int            *up_ind;                 // indices of upstream river segments, in ascending order for each river
+                                            //   segment
+#if defined(_VEC_)
+    double         *ovl_conv;               // cross-sectional area per unit edge length times flow depth term of
+                                            //   Manning's equation, h * h ^ (2/3) (m5/3)
+    double         *ovl_flux;               // overland fluxes through shared edges, out of the elements on both
+                                            //   sides [2 * shared edge + 0 or 1] (m3 s-1)
+    int            *river_down;             // downstream river segment index (0-based), own index for outlets
+    int            *bank_elem;              // left and right bank element index (0-based), -1 if none
+                                            //   [2 * river segment + 0 (left) or 1 (right)]
+    int            *river_order;            // interpolation order (shape of channel) of river segment
+    double         *river_coeff;            // width coefficient of river segment
+    double         *river_length;           // length of river segment (m)
+    double         *river_zbed;             // river bed elevation (m)
+    double         *river_zmax;             // river bank elevation (m)
+    double         *river_rough;            // river channel roughness (s m-1/3)
+    double         *river_cwr;              // river discharge coefficient (-)
+    double         *river_stage;            // river stage (m)
+    double         *river_area;             // river cross-sectional area (m2)
+    double         *river_perim;            // river wetted perimeter (m)
+    double         *river_flux;             // channel flow to downstream segment (m3 s-1)
+    double         *bank_flux;              // overland flow from river segment to left and right bank elements
+                                            //   [2 * river segment + 0 (left) or 1 (right)] (m3 s-1)
+#endif
+} hydro_struct;
+
+// Preconditioner structure
+typedef struct prec_struct
+{
+    realtype      **elem_jac;               // Jacobian of element surface, unsaturated, and groundwater blocks
+    realtype      **elem_blk;               // factored element blocks of I - gamma * J
+    sunindextype   *pivot;                  // pivots of factored element blocks
+    realtype      **river_jac;              // Jacobian of river stage and its coupling to bank elements
+    double         *river_diag;             // diagonal of I - gamma * J for river segments
+} prec_struct;
+
+#if defined(_RT_)
+// Reaction Newton solver workspace. One workspace is allocated for each thread at initialization and reused by
+// SolveReact and Speciation, which only use the leading block of the Jacobian
+typedef struct rtwork_struct
+{
+    realtype      **jcb;                    // Jacobian (num_stc by num_stc)
+    sunindextype   *pivot;                  // pivots of factored Jacobian
+    realtype       *x;                      // right-hand side and Newton step
+} rtwork_struct;
+#endif
+
+#if defined(_NOAH_)
+// Terrain edge structure for horizon angle search
+typedef struct hrzn_edge_struct
+{
+    double          x[2];                   // x of edge end points (m)
+    double          y[2];                   // y of edge end points (m)
+    double          z[2];                   // surface elevation of edge end points (m)
+    double          xc;                     // x of edge midpoint (m)
+    double          yc;                     // y of edge midpoint (m)
+    double          zc;                     // surface elevation of edge midpoint (m)
+} hrzn_edge_struct;
+
+// Horizon angle search grid cell structure
+typedef struct hrzn_cell_struct
+{
+    int             nedge;                  // number of edges with midpoints in the cell
+    int            *edge;                   // indices of edges with midpoints in the cell
+    double          zmax;                   // maximum midpoint elevation of edges (m)
+    double          mid_box[4];             // bounding box of edge midpoints (xmin, xmax, ymin, ymax) (m)
+    double          end_box[4];             // bounding box of edge end points (xmin, xmax, ymin, ymax) (m)
+} hrzn_cell_struct;
+
+// Horizon angle search grid structure
+typedef struct hrzn_grid_struct
+{
+    int             nx;                     // number of grid cells in x direction
+    int             ny;                     // number of grid cells in y direction
+    double          x0;                     // x of lower left corner (m)
+    double          y0;                     // y of lower left corner (m)
+    double          size;                   // grid cell size (m)
+    double          zmax;                   // maximum midpoint elevation of all edges (m)
+    hrzn_cell_struct *cell;                 // grid cells
+    int             bnx;                    // number of grid blocks in x direction
+    int             bny;                    // number of grid blocks in y direction
+    hrzn_cell_struct *block;                // grid blocks (groups of grid cells)
+    int            *cell_edge;              // edge indices sorted by grid cell
+} hrzn_grid_struct;
+#endif
+
 // Print variable control structure
 typedef struct varctrl_struct
 {
@@ -198,8 +359,44 @@ typedef struct varctrl_struct
     int             counter;                // counter for averaging variables
     FILE           *txtfile;                // pointer to txt file
     FILE           *datfile;                // pointer to binary file
+    FILE           *idxfile;                // pointer to frame index of chunked binary file
+    double         *recbuf;                 // batch of binary records waiting to be written
+    int             nrec;                   // number of records in batch
+    int             maxrec;                 // maximum number of records in batch
 } varctrl_struct;
 
+// Output write request
+typedef struct wrreq_struct
+{
+    FILE           *fp;                     // pointer to binary file
+    FILE           *idx_fp;                 // pointer to frame index of chunked binary file
+    double         *data;                   // batch of records (freed after writing)
+    size_t          size;                   // number of doubles in batch
+    int             nvar;                   // number of variables in each record
+} wrreq_struct;
+
+// Output writer structure. Batches of binary records are written to disk by a dedicated thread through a bounded
+// queue, so that the solver only blocks when the queue is full
+typedef struct writer_struct
+{
+    wrreq_struct    queue[WRITER_QUEUE_LEN];// ring buffer of write requests
+    int             head;                   // position of first request in queue
+    int             count;                  // number of requests in queue
+    int             done;                   // flag to stop writer thread
+    int             busy;                   // flag that indicates a request is being written
+    int             format;                 // binary output format
+    int             nprint;                 // number of output variables
+    varctrl_struct *varctrl;                // output variables with pending records
+    struct writer_struct *next;             // next active writer, whose pending records are written at error exit
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_t       thread;                 // writer thread
+    pthread_t       owner;                  // thread that advances the model instance and fills record batches
+    pthread_mutex_t mutex;                  // mutex protecting queue
+    pthread_cond_t  not_empty;              // signaled when a request is added
+    pthread_cond_t  not_full;               // signaled when a request is removed or written
+#endif
+} writer_struct;
+
 // Print structure
 typedef struct print_struct
 {
@@ -207,11 +404,118 @@ typedef struct print_struct
     int             nprint;                 // number of output variables
     FILE           *watbal_file;            // pointer to water balance file
     FILE           *cvodeperf_file;         // pointer to CVode performance file
+    FILE           *timing_file;            // pointer to timing output file
+    writer_struct   writer;                 // binary output writer
 } print_struct;
 
+// Cumulative CVODE counters at a previous step
+typedef struct cvstat_struct
+{
+    long int        nst;                    // number of internal steps
+    long int        nfe;                    // number of right-hand side function calls
+    long int        nni;                    // number of nonlinear iterations
+    long int        nli;                    // number of linear iterations
+    long int        ncfn;                   // number of nonlinear convergence failures
+    long int        netf;                   // number of local error test failures
+} cvstat_struct;
+
+// Model instance context. Model dimensions and modes are process global variables, which are set from the context of
+// an instance before the instance is advanced. Solver, spin-up, and water balance bookkeeping that is kept between
+// steps is also stored here so that several instances can be run in one process
+typedef struct ctx_struct
+{
+    char            project[MAXSTRING];     // project name
+    char            outputdir[MAXSTRING];   // output directory
+    int             member;                 // flag that indicates an ensemble member sharing input with others
+    int             own_meteo;              // flag that indicates an ensemble member owns meteorological forcing values
+    int             nelem;                  // number of model grids
+    int             nriver;                 // number of river segments
+    int             spinup_mode;            // spin-up simulation flag
+#if defined(_RT_)
+    int             nsolute;                // number of solutes
+#endif
+#if defined(_BGC_)
+    int             first_balance;          // flag that indicates the first BGC mass balance check
+#endif
+    N_Vector        CV_Y;                   // CVODE state variables
+    void           *cvode_mem;              // CVODE memory block
+    SUNLinearSolver sun_ls;                 // CVODE linear solver
+    int             cvode_init;             // flag that indicates CVODE memory has been initialized
+#if defined(_OPENMP)
+    double          start;                  // wall clock time at the beginning of simulation
+    double          ptime;                  // wall clock time at previous step
+#else
+    clock_t         start;                  // cpu time at the beginning of simulation
+    clock_t         ptime;                  // cpu time at previous step
+#endif
+    cvstat_struct   maxstep_stat;           // CVODE counters at previous max step adjustment
+    cvstat_struct   perf_stat;              // CVODE counters at previous performance output
+    double          totalw_prev;            // subsurface water storage at previous spin-up cycle (m)
+#if defined(_DGW_)
+    double          gwgeol_prev;            // deep groundwater storage at previous spin-up cycle (m)
+#endif
+#if defined(_BGC_)
+    double          soilc_prev;             // soil carbon at previous spin-up cycle (kgC m-2)
+#endif
+#if defined(_CYCLES_)
+    double          soc_prev;               // soil organic carbon at previous spin-up cycle
+#endif
+    double          tot_strg_prev;          // total water storage at previous water balance output (m3)
+    double          wb_error;               // cumulative water balance error (m3)
+} ctx_struct;
+
+// Element and river segment order. Model arrays are stored in renumbered order, whereas input and output files use
+// the original order
+typedef struct order_struct
+{
+    int            *elem;                   // model index of each element in input and output files
+    int            *river;                  // model index of each river segment in input and output files
+} order_struct;
+
+#if defined(_MPI_)
+// MPI domain decomposition structure. Each process owns the CVODE state variables of a block of elements and of the
+// river segments along them. Halo values are state variables owned by other processes that are needed to calculate
+// fluxes of owned elements and river segments
+typedef struct mpi_struct
+{
+    int             rank;                   // rank of process
+    int             nprocs;                 // number of processes
+    int            *elem_rank;              // rank of process that owns each element
+    int            *river_rank;             // rank of process that owns each river segment
+    int             nlocal;                 // number of owned state variables
+    int            *own_ind;                // global indices of owned state variables
+    int             nsend;                  // number of halo values sent to other processes
+    int            *send_cnt;               // number of halo values sent to each process
+    int            *send_displ;             // displacements of halo values sent to each process
+    int            *send_ind;               // local indices of halo values sent
+    double         *send_buf;               // buffer of halo values sent
+    int             nrecv;                  // number of halo values received from other processes
+    int            *recv_cnt;               // number of halo values received from each process
+    int            *recv_displ;             // displacements of halo values received from each process
+    int            *recv_ind;               // global indices of halo values received
+    double         *recv_buf;               // buffer of halo values received
+    int            *all_cnt;                // number of state variables owned by each process
+    int            *all_displ;              // displacements of state variables owned by each process
+    int            *all_ind;                // global indices of state variables owned by all processes, in rank order
+    int            *elem_cnt;               // number of elements owned by each process
+    int            *elem_displ;             // index of first element owned by each process
+    int            *river_cnt;              // number of river segments owned by each process
+    int            *river_displ;            // displacements of river segments owned by each process
+    int            *river_ind;              // river segments owned by all processes, in rank order
+    double         *buf;                    // buffer of gathered state variables and fluxes
+    double         *ydot;                   // right-hand side in global layout
+    double         *rwork;                  // preconditioner right-hand side in global layout
+    double         *zwork;                  // preconditioner solution in global layout
+    N_Vector        CV_Yl;                  // owned part of CVODE state variables (parallel N_Vector)
+} mpi_struct;
+#endif
+
 typedef struct pihm_struct
 {
     siteinfo_struct siteinfo;
+#if defined(_NOAH_)
+    sun_struct      sun;
+#endif
     filename_struct filename;
     meshtbl_struct  meshtbl;
     atttbl_struct   atttbl;
@@ -243,11 +547,22 @@ typedef struct pihm_struct
     calib_struct    calib;
     ctrl_struct     ctrl;
     print_struct    print;
+    hydro_struct    hydro;
+    prec_struct     prec;
+    ctx_struct      ctx;
+    order_struct    order;
+    timing_struct   timing;
+    int             nvgtbl;
+    vgtbl_struct   *vgtbl;
+#if defined(_MPI_)
+    mpi_struct      mpi;
+#endif
 #if defined(_RT_)
     chemtbl_struct  chemtbl[MAXSPS];
     kintbl_struct   kintbl[MAXSPS];
     rttbl_struct    rttbl;
     chmictbl_struct chmictbl;
+    rtwork_struct  *rtwork;
 #endif
 } *pihm_struct;
 
@@ -0,0 +1,109 @@
+#ifndef VEC_MATH_HEADER
+#define VEC_MATH_HEADER
+
+// Elementary functions for the batched kernels compiled with the VEC=on make option. Libm functions cannot be
+// vectorized by the compiler, thus the functions below are implemented using floating-point bit manipulation and
+// polynomials, without branches. Results are accurate to a few units in the last place. Arguments must be in the
+// ranges given below, because special values (zero, infinity, NaN) are not handled
+
+// Cube root of a positive normal number. The initial guess divides the exponent by three in the high word of the
+// IEEE 754 representation (as in fdlibm), and is accurate to about five bits. Four Newton iterations are then accurate
+// to full double precision
+static inline double VecCbrt(double x)
+{
+    uint64_t        bits;
+    uint32_t        hi;
+    double          y;
+
+    memcpy(&bits, &x, sizeof(double));
+    hi = (uint32_t)(bits >> 32) / 3 + 715094163;
+    bits = (uint64_t)hi << 32;
+    memcpy(&y, &bits, sizeof(double));
+
+    y -= (y * y * y - x) / (3.0 * y * y);
+    y -= (y * y * y - x) / (3.0 * y * y);
+    y -= (y * y * y - x) / (3.0 * y * y);
+    y -= (y * y * y - x) / (3.0 * y * y);
+
+    return y;
+}
+
+// Natural logarithm of a positive number. The mantissa is reduced to [sqrt(2) / 2, sqrt(2)) using integer arithmetic
+// on the IEEE 754 representation (as in musl), and log(m) = 2 * atanh(s) with s = (m - 1) / (m + 1) is evaluated using
+// its Taylor series, which converges to double precision with 11 terms for |s| < 0.172
+static inline double VecLog(double x)
+{
+    const uint64_t  SQRT1_2 = 0x3fe6a09e667f3bcdULL;    // sqrt(2) / 2
+    const uint64_t  ONE = 0x3ff0000000000000ULL;
+    const double    LN2_HI = 6.93147180369123816490e-01;
+    const double    LN2_LO = 1.90821492927058770002e-10;
+    uint64_t        bits;
+    double          m;
+    double          s, z, p;
+    double          e;
+
+    memcpy(&bits, &x, sizeof(double));
+    bits += ONE - SQRT1_2;
+    e = (double)((int)(bits >> 52) - 1023);
+    bits = (bits & 0x000fffffffffffffULL) + SQRT1_2;
+    memcpy(&m, &bits, sizeof(double));
+
+    s = (m - 1.0) / (m + 1.0);
+    z = s * s;
+
+    p = 1.0 + z * (1.0 / 3.0 + z * (1.0 / 5.0 + z * (1.0 / 7.0 + z * (1.0 / 9.0 + z * (1.0 / 11.0 + z * (1.0 / 13.0 +
+        z * (1.0 / 15.0 + z * (1.0 / 17.0 + z * (1.0 / 19.0 + z / 21.0)))))))));
+
+    return e * LN2_HI + (2.0 * s * p + e * LN2_LO);
+}
+
+// Exponential function of x in (-708, 709). x is reduced to r = x - n * ln(2) with |r| <= ln(2) / 2 by rounding
+// x / ln(2) to the nearest integer n (as in fdlibm), and exp(r) is evaluated using its Taylor series, which converges
+// to double precision with 13 terms. 2 ^ n is constructed from the integer bits of the rounded value, which avoids
+// floating-point to integer conversions that cannot be vectorized on some architectures
+static inline double VecExp(double x)
+{
+    const double    LN2_HI = 6.93147180369123816490e-01;
+    const double    LN2_LO = 1.90821492927058770002e-10;
+    const double    INVLN2 = 1.44269504088896338700e+00;
+    const double    SHIFT = 6755399441055744.0;         // 1.5 * 2 ^ 52
+    uint64_t        bits;
+    double          t;
+    double          n;
+    double          r;
+    double          p;
+    double          scale;
+
+    // Adding 1.5 * 2 ^ 52 rounds to the nearest integer, which is stored in the lower bits of the mantissa
+    t = x * INVLN2 + SHIFT;
+    n = t - SHIFT;
+    r = (x - n * LN2_HI) - n * LN2_LO;
+
+    p = 1.0 + r * (1.0 + r * (1.0 / 2.0 + r * (1.0 / 6.0 + r * (1.0 / 24.0 + r * (1.0 / 120.0 + r * (1.0 / 720.0 +
+        r * (1.0 / 5040.0 + r * (1.0 / 40320.0 + r * (1.0 / 362880.0 + r * (1.0 / 3628800.0 +
+        r * (1.0 / 39916800.0 + r * (1.0 / 479001600.0 + r / 6227020800.0))))))))))));
+
+    memcpy(&bits, &t, sizeof(double));
+    bits = (bits + 1023) << 52;
+    memcpy(&scale, &bits, sizeof(double));
+
+    return p * scale;
+}
+
+// Power function of a positive normal x, with |y * log(x)| < 708. Relative errors are about |y * log(x)| times machine
+// epsilon
+static inline double VecPow(double x, double y)
+{
+    return VecExp(y * VecLog(x));
+}
+
+// Equivalent to MIN(MAX(x, lo), hi) within rounding errors. Conditional expressions would allow the compiler to move
+// the evaluation of x into a branch, which prevents vectorization
+static inline double VecClamp(double x, double lo, double hi)
+{
+    x = 0.5 * ((x + lo) + fabs(x - lo));
+
+    return 0.5 * ((x + hi) - fabs(x - hi));
+}
+
+#endif
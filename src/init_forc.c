@@ -8,8 +8,9 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
 {
     int             i, j;
 
-    // Apply climate scenarios
-    for (i = 0; i < forc->nmeteo; i++)
+    // Apply climate scenarios. Forcing values are not touched without climate scenarios so that pages of binary
+    // forcing file are not copied
+    for (i = 0; i < forc->nmeteo && (calib->prcp != 1.0 || calib->sfctmp != 0.0); i++)
     {
 #if defined(_OPENMP)
 # pragma omp parallel for
@@ -30,6 +31,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
 #else
             forc->bc[i].value = (double *)malloc(sizeof(double));
 #endif
+            forc->bc[i].cursor = 0;
         }
     }
     if (forc->nmeteo > 0)
@@ -37,6 +39,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
         for (i = 0; i < forc->nmeteo; i++)
         {
             forc->meteo[i].value = (double *)malloc(NUM_METEO_VAR * sizeof(double));
+            forc->meteo[i].cursor = 0;
         }
     }
     if (forc->nlai > 0)
@@ -44,6 +47,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
         for (i = 0; i < forc->nlai; i++)
         {
             forc->lai[i].value = (double *)malloc(sizeof(double));
+            forc->lai[i].cursor = 0;
         }
     }
     if (forc->nriverbc > 0)
@@ -51,6 +55,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
         for (i = 0; i < forc->nriverbc; i++)
         {
             forc->riverbc[i].value = (double *)malloc(sizeof(double));
+            forc->riverbc[i].cursor = 0;
         }
     }
     if (forc->nsource > 0)
@@ -58,6 +63,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
         for (i = 0; i < forc->nsource; i++)
         {
             forc->source[i].value = (double *)malloc(sizeof(double));
+            forc->source[i].cursor = 0;
         }
     }
 #if defined(_NOAH_)
@@ -66,6 +72,7 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
         for (i = 0; i < forc->nrad; i++)
         {
             forc->rad[i].value = (double *)malloc(2 * sizeof(double));
+            forc->rad[i].cursor = 0;
         }
     }
 #endif
@@ -74,11 +81,13 @@ void InitForcing(const calib_struct *calib, forc_struct *forc, elem_struct elem[
     if (forc->nco2 > 0)
     {
         forc->co2[0].value = (double *)malloc(sizeof(double));
+        forc->co2[0].cursor = 0;
     }
 
     if (forc->nndep > 0)
     {
         forc->ndep[0].value = (double *)malloc(sizeof(double));
+        forc->ndep[0].cursor = 0;
     }
 #endif
 
@@ -0,0 +1,203 @@
+#include "pihm.h"
+
+void InitHydro(const elem_struct elem[], const river_struct river[], hydro_struct *hydro)
+{
+    int             i;
+
+    hydro->nabr = (int *)malloc(NUM_EDGE * nelem * sizeof(int));
+    hydro->nabr_river = (int *)malloc(NUM_EDGE * nelem * sizeof(int));
+    hydro->x_nabr = (double *)malloc(NUM_EDGE * nelem * sizeof(double));
+    hydro->y_nabr = (double *)malloc(NUM_EDGE * nelem * sizeof(double));
+    hydro->dist_nabr = (double *)malloc(NUM_EDGE * nelem * sizeof(double));
+    hydro->edge = (double *)malloc(NUM_EDGE * nelem * sizeof(double));
+    hydro->area = (double *)malloc(nelem * sizeof(double));
+    hydro->zmax = (double *)malloc(nelem * sizeof(double));
+    hydro->zmin = (double *)malloc(nelem * sizeof(double));
+    hydro->porosity = (double *)malloc(nelem * sizeof(double));
+    hydro->rough = (double *)malloc(nelem * sizeof(double));
+    hydro->surfh = (double *)calloc(nelem, sizeof(double));
+    hydro->gw = (double *)calloc(nelem, sizeof(double));
+    hydro->effk = (double *)calloc(nelem, sizeof(double));
+    hydro->sf = (double *)calloc(nelem, sizeof(double));
+    hydro->bank_edge = (int *)malloc(2 * nriver * sizeof(int));
+    hydro->river_head = (double *)calloc(nriver, sizeof(double));
+
+    // Copy element connectivity and parameters that do not change during simulation
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+        int             ind;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            ind = NUM_EDGE * i + j;
+
+            hydro->nabr[ind] = elem[i].nabr[j] - 1;
+            hydro->nabr_river[ind] = elem[i].nabr_river[j] - 1;
+            hydro->dist_nabr[ind] = elem[i].topo.dist_nabr[j];
+            hydro->edge[ind] = elem[i].topo.edge[j];
+
+            // Surface friction slope uses the location of river segment for river edges
+            hydro->x_nabr[ind] = (elem[i].nabr[j] > 0 && elem[i].nabr_river[j] > 0) ?
+                river[elem[i].nabr_river[j] - 1].topo.x : elem[i].topo.x_nabr[j];
+            hydro->y_nabr[ind] = (elem[i].nabr[j] > 0 && elem[i].nabr_river[j] > 0) ?
+                river[elem[i].nabr_river[j] - 1].topo.y : elem[i].topo.y_nabr[j];
+        }
+
+        hydro->area[i] = elem[i].topo.area;
+        hydro->zmax[i] = elem[i].topo.zmax;
+        hydro->zmin[i] = elem[i].topo.zmin;
+        hydro->porosity[i] = elem[i].soil.porosity;
+        hydro->rough[i] = elem[i].lc.rough;
+    }
+
+    // Find the edges of bank elements that are adjacent to each river segment
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        hydro->bank_edge[2 * i] = (river[i].left > 0) ? RiverEdge(&elem[river[i].left - 1], river[i].ind) : -1;
+        hydro->bank_edge[2 * i + 1] = (river[i].right > 0) ? RiverEdge(&elem[river[i].right - 1], river[i].ind) : -1;
+    }
+
+    InitEdgeList(hydro);
+
+    InitUpstreamList(river, hydro);
+
+#if defined(_VEC_)
+    InitHydroVec(river, hydro);
+#endif
+}
+
+// Build the lists of boundary edges and edges shared by two elements, so that lateral fluxes through each shared edge
+// are only calculated once. Shared edges without river segments are stored before river bank edges, which have no
+// overland flow between elements
+void InitEdgeList(hydro_struct *hydro)
+{
+    int             i, j;
+    int             river_edge;
+
+    hydro->nedge = 0;
+    hydro->nbound = 0;
+    for (i = 0; i < NUM_EDGE * nelem; i++)
+    {
+        if (hydro->nabr[i] < 0)
+        {
+            hydro->nbound++;
+        }
+        else if (hydro->nabr[i] > i / NUM_EDGE)
+        {
+            hydro->nedge++;
+        }
+    }
+
+    hydro->edge_ind = (int *)malloc(2 * hydro->nedge * sizeof(int));
+    hydro->bound_ind = (int *)malloc(hydro->nbound * sizeof(int));
+
+    hydro->nedge = 0;
+    hydro->nbound = 0;
+    for (i = 0; i < NUM_EDGE * nelem; i++)
+    {
+        if (hydro->nabr[i] < 0)
+        {
+            hydro->bound_ind[hydro->nbound] = i;
+            hydro->nbound++;
+        }
+    }
+
+    for (river_edge = 0; river_edge <= 1; river_edge++)
+    {
+        for (i = 0; i < NUM_EDGE * nelem; i++)
+        {
+            int             nabr = hydro->nabr[i];
+
+            if (nabr <= i / NUM_EDGE || (hydro->nabr_river[i] >= 0) != river_edge)
+            {
+                continue;
+            }
+
+            // Find the same edge in the neighbor element
+            for (j = NUM_EDGE * nabr; j < NUM_EDGE * (nabr + 1); j++)
+            {
+                if (hydro->nabr[j] == i / NUM_EDGE)
+                {
+                    break;
+                }
+            }
+
+            if (j == NUM_EDGE * (nabr + 1))
+            {
+                pihm_printf(VL_ERROR, "Error: Element %d is not a neighbor of Element %d.\n", i / NUM_EDGE + 1,
+                    nabr + 1);
+                pihm_exit(EXIT_FAILURE);
+            }
+
+            hydro->edge_ind[2 * hydro->nedge] = i;
+            hydro->edge_ind[2 * hydro->nedge + 1] = j;
+            hydro->nedge++;
+        }
+
+        if (!river_edge)
+        {
+            hydro->nedge_ovl = hydro->nedge;
+        }
+    }
+}
+
+// Build the list of upstream segments of each river segment in compressed sparse row (CSR) format, so that in-flows
+// from upstream segments can be accumulated in parallel for each downstream segment. Upstream segments are stored in
+// ascending order, which keeps the summation order the same as a serial loop over river segments
+void InitUpstreamList(const river_struct river[], hydro_struct *hydro)
+{
+    int            *ptr;
+    int             i;
+
+    hydro->up_ptr = (int *)calloc(nriver + 1, sizeof(int));
+
+    for (i = 0; i < nriver; i++)
+    {
+        if (river[i].down > 0)
+        {
+            hydro->up_ptr[river[i].down]++;
+        }
+    }
+
+    for (i = 0; i < nriver; i++)
+    {
+        hydro->up_ptr[i + 1] += hydro->up_ptr[i];
+    }
+
+    hydro->up_ind = (int *)malloc(MAX(hydro->up_ptr[nriver], 1) * sizeof(int));
+
+    ptr = (int *)malloc(MAX(nriver, 1) * sizeof(int));
+    memcpy(ptr, hydro->up_ptr, nriver * sizeof(int));
+
+    for (i = 0; i < nriver; i++)
+    {
+        if (river[i].down > 0)
+        {
+            hydro->up_ind[ptr[river[i].down - 1]++] = i;
+        }
+    }
+
+    free(ptr);
+}
+
+int RiverEdge(const elem_struct *bank, int river_ind)
+{
+    int             j;
+
+    for (j = 0; j < NUM_EDGE; j++)
+    {
+        if (bank->nabr_river[j] == river_ind)
+        {
+            return j;
+        }
+    }
+
+    return -1;
+}
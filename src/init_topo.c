@@ -1,5 +1,11 @@
 #include "pihm.h"
 
+#if defined(_NOAH_)
+# define EDGES_PER_CELL     4.0     // average number of terrain edges in each horizon search grid cell
+# define HRZN_BLOCK         8       // number of grid cells in each direction of a horizon search block
+# define HRZN_TOL           1.0E-6  // tolerance of unobstructed angle bounds (degree)
+#endif
+
 void InitTopo(const meshtbl_struct *meshtbl, elem_struct elem[])
 {
     int             i, j;
@@ -47,26 +53,25 @@ void InitTopo(const meshtbl_struct *meshtbl, elem_struct elem[])
 #if defined(_NOAH_)
 void CalcSlopeAspect(const meshtbl_struct *meshtbl, elem_struct elem[])
 {
-    const int       XCOMP = 0;
-    const int       YCOMP = 1;
-    const int       ZCOMP = 2;
-    double          x[NUM_EDGE];
-    double          y[NUM_EDGE];
-    double          zmax[NUM_EDGE];
-    double          edge_vector[2][NUM_EDGE];
-    double          normal_vector[NUM_EDGE];
-    double          vector[NUM_EDGE];
-    double          h, c;
-    double          se, ce;
-    int             nodes[2];
-    double          x1, y1, z1, x2, y2, z2, xc, yc, zc;
-    double          c1, c2, ce1, ce2, se1, se2, phi1, phi2;
-    double          integrable;
-    int             ind, ind1, ind2;
-    int             i, j, k;
+    int             i;
 
+# if defined(_OPENMP)
+#  pragma omp parallel for
+# endif
     for (i = 0; i < nelem; i++)
     {
+        const int       XCOMP = 0;
+        const int       YCOMP = 1;
+        const int       ZCOMP = 2;
+        double          x[NUM_EDGE];
+        double          y[NUM_EDGE];
+        double          zmax[NUM_EDGE];
+        double          edge_vector[2][NUM_EDGE];
+        double          normal_vector[NUM_EDGE];
+        double          c;
+        double          se, ce;
+        int             j;
+
         for (j = 0; j < NUM_EDGE; j++)
         {
             x[j] = meshtbl->x[elem[i].node[j] - 1];
@@ -114,119 +119,636 @@ void CalcSlopeAspect(const meshtbl_struct *meshtbl, elem_struct elem[])
             elem[i].topo.aspect = (se < 0.0) ? 360.0 - elem[i].topo.aspect : elem[i].topo.aspect;
             elem[i].topo.aspect = Mod(360.0 - elem[i].topo.aspect + 270.0, 360.0);
         }
+    }
+}
 
-        // Calculate sky view factor (Dozier and Frew 1990)
-        elem[i].topo.svf = 0.0;
+void InitHorizon(const char fn[], int rad_mode, double radius, const meshtbl_struct *meshtbl, elem_struct elem[])
+{
+    int             i, j;
 
-        // Calculate unobstructed angle for every 10 degrees
-        for (j = 0; j < 36; j++)
+    // Horizon angles are only needed by topographic solar radiation. They are read from the cache file if the cache
+    // matches current mesh and search radius, otherwise they are calculated and cached
+    if (rad_mode == TOPO_SOL)
+    {
+        if (!ReadHorizon(fn, radius, meshtbl, elem))
+        {
+            CalcHorizon(radius, meshtbl, elem);
+            WriteHorizon(fn, radius, meshtbl, elem);
+        }
+    }
+    else
+    {
+        for (i = 0; i < nelem; i++)
         {
-            elem[i].topo.h_phi[j] = 90.0;
+            for (j = 0; j < 36; j++)
+            {
+                elem[i].topo.h_phi[j] = 90.0;
+            }
         }
+    }
+
+# if defined(_OPENMP)
+#  pragma omp parallel for
+# endif
+    for (i = 0; i < nelem; i++)
+    {
+        elem[i].topo.svf = SkyViewFactor(&elem[i].topo);
+
+        // Slope terms and terrain configuration factor used by topographic solar radiation
+        // Dozier and Frew 1990, IEEE Transactions on Geoscience and Remote Sensing, 28(5), 963--969
+        elem[i].topo.cos_slope = cos(elem[i].topo.slope * PI / 180.0);
+        elem[i].topo.sin_slope = sin(elem[i].topo.slope * PI / 180.0);
+        elem[i].topo.tcf = (1.0 + elem[i].topo.cos_slope) / 2.0 - elem[i].topo.svf;
+        elem[i].topo.tcf = MAX(elem[i].topo.tcf, 0.0);
+    }
+}
+
+double SkyViewFactor(const topo_struct *topo)
+{
+    double          integrable;
+    double          svf = 0.0;
+    int             ind;
+
+    // Calculate sky view factor (Dozier and Frew 1990, Eq. 7b)
+    for (ind = 0; ind < 36; ind++)
+    {
+        integrable = sin(topo->slope * PI / 180.0) * cos((ind * 10.0 + 5.0 - topo->aspect) * PI / 180.0);
+        integrable *= topo->h_phi[ind] * PI / 180.0 -
+            sin(topo->h_phi[ind] * PI / 180.0) * cos(topo->h_phi[ind] * PI / 180.0);
+        integrable += cos(topo->slope * PI / 180.0) * pow(sin(topo->h_phi[ind] * PI / 180.0), 2);
 
-        // Consider every edge of every triangular grid
-        for (j = 0; j < nelem; j++)
+        svf += 0.5 / PI * integrable * 10.0 / 180.0 * PI;
+    }
+
+    return svf;
+}
+
+void CalcHorizon(double radius, const meshtbl_struct *meshtbl, elem_struct elem[])
+{
+    hrzn_edge_struct *edge;
+    hrzn_grid_struct grid;
+    int             nedge;
+    int             i;
+
+    // Terrain edges are indexed by a uniform grid of edge midpoints, with grid cells grouped into blocks. For each
+    // element, blocks are searched in rings of increasing distance, and blocks and cells that cannot lower the
+    // unobstructed angle in any direction they cover are skipped. Edges that are visited are processed exactly as in an
+    // exhaustive search, so the results are identical when the search radius is unlimited
+    edge = TerrainEdges(meshtbl, elem, &nedge);
+    BuildHorizonGrid(nedge, edge, &grid);
+
+# if defined(_OPENMP)
+#  pragma omp parallel for schedule(dynamic, 16)
+# endif
+    for (i = 0; i < nelem; i++)
+    {
+        SearchHorizon(radius, edge, &grid, &elem[i].topo);
+    }
+
+    free(edge);
+    free(grid.cell);
+    free(grid.block);
+    free(grid.cell_edge);
+}
+
+hrzn_edge_struct *TerrainEdges(const meshtbl_struct *meshtbl, const elem_struct elem[], int *nedge)
+{
+    const int       NODES[NUM_EDGE][2] = {{1, 2}, {0, 2}, {0, 1}};
+    int           (*pair)[2];
+    hrzn_edge_struct *edge;
+    int             node1, node2;
+    int             i, j, k;
+
+    // Collect all element edges as node pairs. Edges shared by two elements are only considered once
+    pair = (int (*)[2])malloc(NUM_EDGE * nelem * sizeof(int [2]));
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            node1 = elem[i].node[NODES[j][0]];
+            node2 = elem[i].node[NODES[j][1]];
+
+            pair[NUM_EDGE * i + j][0] = MIN(node1, node2);
+            pair[NUM_EDGE * i + j][1] = MAX(node1, node2);
+        }
+    }
+
+    qsort(pair, NUM_EDGE * nelem, sizeof(int [2]), CompareNodePair);
+
+    edge = (hrzn_edge_struct *)malloc(NUM_EDGE * nelem * sizeof(hrzn_edge_struct));
+
+    *nedge = 0;
+    for (i = 0; i < NUM_EDGE * nelem; i++)
+    {
+        if (i > 0 && pair[i][0] == pair[i - 1][0] && pair[i][1] == pair[i - 1][1])
+        {
+            continue;
+        }
+
+        for (k = 0; k < 2; k++)
         {
-            for (k = 0; k < NUM_EDGE; k++)
+            edge[*nedge].x[k] = meshtbl->x[pair[i][k] - 1];
+            edge[*nedge].y[k] = meshtbl->y[pair[i][k] - 1];
+            edge[*nedge].z[k] = meshtbl->zmax[pair[i][k] - 1];
+        }
+
+        edge[*nedge].xc = 0.5 * (edge[*nedge].x[0] + edge[*nedge].x[1]);
+        edge[*nedge].yc = 0.5 * (edge[*nedge].y[0] + edge[*nedge].y[1]);
+        edge[*nedge].zc = 0.5 * (edge[*nedge].z[0] + edge[*nedge].z[1]);
+
+        (*nedge)++;
+    }
+
+    free(pair);
+
+    return edge;
+}
+
+int CompareNodePair(const void *a, const void *b)
+{
+    const int      *pair1 = (const int *)a;
+    const int      *pair2 = (const int *)b;
+
+    return (pair1[0] != pair2[0]) ? pair1[0] - pair2[0] : pair1[1] - pair2[1];
+}
+
+void BuildHorizonGrid(int nedge, const hrzn_edge_struct edge[], hrzn_grid_struct *grid)
+{
+    double          xmin = DBL_MAX, xmax = -DBL_MAX;
+    double          ymin = DBL_MAX, ymax = -DBL_MAX;
+    int            *count;
+    int            *cell_ind;
+    hrzn_cell_struct *cell;
+    int             ncell;
+    int             i, k;
+
+    grid->zmax = -DBL_MAX;
+    for (k = 0; k < nedge; k++)
+    {
+        xmin = MIN(xmin, edge[k].xc);
+        xmax = MAX(xmax, edge[k].xc);
+        ymin = MIN(ymin, edge[k].yc);
+        ymax = MAX(ymax, edge[k].yc);
+        grid->zmax = MAX(grid->zmax, edge[k].zc);
+    }
+
+    // Grid cells are sized to hold a few edges each on average
+    grid->x0 = xmin;
+    grid->y0 = ymin;
+    grid->size = sqrt(EDGES_PER_CELL * MAX(xmax - xmin, 1.0) * MAX(ymax - ymin, 1.0) / (double)nedge);
+    grid->nx = (int)floor((xmax - xmin) / grid->size) + 1;
+    grid->ny = (int)floor((ymax - ymin) / grid->size) + 1;
+    ncell = grid->nx * grid->ny;
+
+    grid->cell = (hrzn_cell_struct *)malloc(ncell * sizeof(hrzn_cell_struct));
+    grid->cell_edge = (int *)malloc(nedge * sizeof(int));
+    count = (int *)calloc(ncell, sizeof(int));
+    cell_ind = (int *)malloc(nedge * sizeof(int));
+
+    for (i = 0; i < ncell; i++)
+    {
+        InitHorizonCell(&grid->cell[i]);
+    }
+
+    for (k = 0; k < nedge; k++)
+    {
+        cell_ind[k] = HorizonGridCell(edge[k].xc, edge[k].yc, grid);
+        cell = &grid->cell[cell_ind[k]];
+
+        cell->nedge++;
+        cell->zmax = MAX(cell->zmax, edge[k].zc);
+        cell->mid_box[0] = MIN(cell->mid_box[0], edge[k].xc);
+        cell->mid_box[1] = MAX(cell->mid_box[1], edge[k].xc);
+        cell->mid_box[2] = MIN(cell->mid_box[2], edge[k].yc);
+        cell->mid_box[3] = MAX(cell->mid_box[3], edge[k].yc);
+        cell->end_box[0] = MIN(cell->end_box[0], MIN(edge[k].x[0], edge[k].x[1]));
+        cell->end_box[1] = MAX(cell->end_box[1], MAX(edge[k].x[0], edge[k].x[1]));
+        cell->end_box[2] = MIN(cell->end_box[2], MIN(edge[k].y[0], edge[k].y[1]));
+        cell->end_box[3] = MAX(cell->end_box[3], MAX(edge[k].y[0], edge[k].y[1]));
+    }
+
+    // Group grid cells into blocks so that distant parts of the domain can be skipped at once
+    grid->bnx = (grid->nx + HRZN_BLOCK - 1) / HRZN_BLOCK;
+    grid->bny = (grid->ny + HRZN_BLOCK - 1) / HRZN_BLOCK;
+    grid->block = (hrzn_cell_struct *)malloc(grid->bnx * grid->bny * sizeof(hrzn_cell_struct));
+
+    for (i = 0; i < grid->bnx * grid->bny; i++)
+    {
+        InitHorizonCell(&grid->block[i]);
+    }
+
+    for (i = 0; i < ncell; i++)
+    {
+        cell = &grid->block[i / grid->nx / HRZN_BLOCK * grid->bnx + i % grid->nx / HRZN_BLOCK];
+
+        cell->nedge += grid->cell[i].nedge;
+        cell->zmax = MAX(cell->zmax, grid->cell[i].zmax);
+        for (k = 0; k < 4; k += 2)
+        {
+            cell->mid_box[k] = MIN(cell->mid_box[k], grid->cell[i].mid_box[k]);
+            cell->mid_box[k + 1] = MAX(cell->mid_box[k + 1], grid->cell[i].mid_box[k + 1]);
+            cell->end_box[k] = MIN(cell->end_box[k], grid->cell[i].end_box[k]);
+            cell->end_box[k + 1] = MAX(cell->end_box[k + 1], grid->cell[i].end_box[k + 1]);
+        }
+    }
+
+    // Sort edges by grid cell
+    for (i = 0; i < ncell; i++)
+    {
+        count[i] = (i == 0) ? 0 : count[i - 1] + grid->cell[i - 1].nedge;
+        grid->cell[i].edge = grid->cell_edge + count[i];
+    }
+
+    for (k = 0; k < nedge; k++)
+    {
+        grid->cell_edge[count[cell_ind[k]]++] = k;
+    }
+
+    free(count);
+    free(cell_ind);
+}
+
+void InitHorizonCell(hrzn_cell_struct *cell)
+{
+    cell->nedge = 0;
+    cell->edge = NULL;
+    cell->zmax = -DBL_MAX;
+    cell->mid_box[0] = DBL_MAX;
+    cell->mid_box[1] = -DBL_MAX;
+    cell->mid_box[2] = DBL_MAX;
+    cell->mid_box[3] = -DBL_MAX;
+    cell->end_box[0] = DBL_MAX;
+    cell->end_box[1] = -DBL_MAX;
+    cell->end_box[2] = DBL_MAX;
+    cell->end_box[3] = -DBL_MAX;
+}
+
+int HorizonGridCell(double x, double y, const hrzn_grid_struct *grid)
+{
+    int             ix, iy;
+
+    ix = (int)floor((x - grid->x0) / grid->size);
+    iy = (int)floor((y - grid->y0) / grid->size);
+
+    ix = MAX(ix, 0);
+    ix = MIN(ix, grid->nx - 1);
+    iy = MAX(iy, 0);
+    iy = MIN(iy, grid->ny - 1);
+
+    return iy * grid->nx + ix;
+}
+
+void SearchHorizon(double radius, const hrzn_edge_struct edge[], const hrzn_grid_struct *grid, topo_struct *topo)
+{
+    const hrzn_cell_struct *cell;
+    int             center;
+    int             bx0, by0, bx, by;
+    int             ix, iy;
+    int             ring, max_ring;
+    double          dist;
+    double          hmin;
+    int             k;
+
+    for (k = 0; k < 36; k++)
+    {
+        topo->h_phi[k] = 90.0;
+    }
+
+    if (grid->zmax <= topo->zmax)
+    {
+        // No edge is higher than the element
+        return;
+    }
+
+    center = HorizonGridCell(topo->x, topo->y, grid);
+    bx0 = center % grid->nx / HRZN_BLOCK;
+    by0 = center / grid->nx / HRZN_BLOCK;
+    max_ring = MAX(MAX(bx0, grid->bnx - 1 - bx0), MAX(by0, grid->bny - 1 - by0));
+
+    for (ring = 0; ring <= max_ring; ring++)
+    {
+        // Blocks in the current ring are at least (ring - 1) blocks away from the element centroid. Stop searching if
+        // the highest edge of the domain at that distance cannot lower the unobstructed angle in any direction
+        if (ring > 1)
+        {
+            dist = (ring - 1) * HRZN_BLOCK * grid->size;
+
+            if (radius > 0.0 && dist > radius)
+            {
+                break;
+            }
+
+            hmin = atan(dist / (grid->zmax - topo->zmax)) * 180.0 / PI;
+            if (hmin - HRZN_TOL >= MaxHorizon(0, 35, topo->h_phi))
             {
-                switch (k)
+                break;
+            }
+        }
+
+        for (by = MAX(by0 - ring, 0); by <= MIN(by0 + ring, grid->bny - 1); by++)
+        {
+            for (bx = MAX(bx0 - ring, 0); bx <= MIN(bx0 + ring, grid->bnx - 1); bx++)
+            {
+                // Only visit blocks on the boundary of the ring
+                if ((abs(bx - bx0) != ring && abs(by - by0) != ring) ||
+                    SkipHorizonCell(radius, &grid->block[by * grid->bnx + bx], topo))
                 {
-                    case 0:
-                        nodes[0] = 1;
-                        nodes[1] = 2;
-                        break;
-                    case 1:
-                        nodes[0] = 0;
-                        nodes[1] = 2;
-                        break;
-                    case 2:
-                        nodes[0] = 0;
-                        nodes[1] = 1;
-                        break;
+                    continue;
                 }
-                x1 = meshtbl->x[elem[j].node[nodes[0]] - 1];
-                y1 = meshtbl->y[elem[j].node[nodes[0]] - 1];
-                z1 = meshtbl->zmax[elem[j].node[nodes[0]] - 1];
-                x2 = meshtbl->x[elem[j].node[nodes[1]] - 1];
-                y2 = meshtbl->y[elem[j].node[nodes[1]] - 1];
-                z2 = meshtbl->zmax[elem[j].node[nodes[1]] - 1];
-
-                xc = 0.5 * (x1 + x2);
-                yc = 0.5 * (y1 + y2);
-                zc = 0.5 * (z1 + z2);
-
-                vector[XCOMP] = xc - elem[i].topo.x;
-                vector[YCOMP] = yc - elem[i].topo.y;
-                vector[ZCOMP] = zc - elem[i].topo.zmax;
-                c = sqrt(vector[XCOMP] * vector[XCOMP] + vector[YCOMP] * vector[YCOMP]);
-                // Unobstructed angle of the kth edge of the jth grid
-                h = (vector[ZCOMP] <= 0.0) ? 90.0 : atan(c / vector[ZCOMP]) * 180.0 / PI;
-
-                // Find out which directions are blocked
-                edge_vector[0][XCOMP] = x1 - elem[i].topo.x;
-                edge_vector[0][YCOMP] = y1 - elem[i].topo.y;
-                edge_vector[0][ZCOMP] = z1 - elem[i].topo.zmax;
-                edge_vector[1][XCOMP] = x2 - elem[i].topo.x;
-                edge_vector[1][YCOMP] = y2 - elem[i].topo.y;
-                edge_vector[1][ZCOMP] = z2 - elem[i].topo.zmax;
-
-                c1 =
-                    sqrt(edge_vector[0][XCOMP] * edge_vector[0][XCOMP] + edge_vector[0][YCOMP] * edge_vector[0][YCOMP]);
-                c2 =
-                    sqrt(edge_vector[1][XCOMP] * edge_vector[1][XCOMP] + edge_vector[1][YCOMP] * edge_vector[1][YCOMP]);
-
-                ce1 = edge_vector[0][XCOMP] / c1;
-                se1 = edge_vector[0][YCOMP] / c1;
-                phi1 = acos(ce1) * 180.0 / PI;
-                phi1 = (se1 < 0.0) ? 360.0 - phi1 : phi1;
-                phi1 = Mod(360.0 - phi1 + 270.0, 360.0);
-
-                ce2 = edge_vector[1][XCOMP] / c2;
-                se2 = edge_vector[1][YCOMP] / c2;
-                phi2 = acos(ce2) * 180.0 / PI;
-                phi2 = (se2 < 0.0) ? 360.0 - phi2 : phi2;
-                phi2 = Mod(360.0 - phi2 + 270.0, 360.0);
-
-                if (fabs(phi1 - phi2) > 180.0)
-                {
-                    ind1 = 0;
-                    ind2 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
-                    for (ind = ind1; ind <= ind2; ind++)
-                    {
-                        elem[i].topo.h_phi[ind] = MIN(elem[i].topo.h_phi[ind], h);
-                    }
 
-                    ind1 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
-                    ind2 = 35;
-                    for (ind = ind1; ind <= ind2; ind++)
-                    {
-                        elem[i].topo.h_phi[ind] = MIN(elem[i].topo.h_phi[ind], h);
-                    }
-                }
-                else
+                for (iy = by * HRZN_BLOCK; iy < MIN((by + 1) * HRZN_BLOCK, grid->ny); iy++)
                 {
-                    ind1 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
-                    ind2 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
-                    for (ind = ind1; ind <= ind2; ind++)
+                    for (ix = bx * HRZN_BLOCK; ix < MIN((bx + 1) * HRZN_BLOCK, grid->nx); ix++)
                     {
-                        elem[i].topo.h_phi[ind] = MIN(elem[i].topo.h_phi[ind], h);
+                        cell = &grid->cell[iy * grid->nx + ix];
+
+                        if (SkipHorizonCell(radius, cell, topo))
+                        {
+                            continue;
+                        }
+
+                        for (k = 0; k < cell->nedge; k++)
+                        {
+                            EdgeHorizon(radius, &edge[cell->edge[k]], topo);
+                        }
                     }
                 }
             }
         }
+    }
+}
+
+int SkipHorizonCell(double radius, const hrzn_cell_struct *cell, const topo_struct *topo)
+{
+    int             ind1, ind2;
+    double          dist;
+    double          hmin;
+
+    if (cell->nedge == 0 || cell->zmax <= topo->zmax)
+    {
+        return 1;
+    }
+
+    dist = BoxDistance(topo->x, topo->y, cell->mid_box);
+
+    if (radius > 0.0 && dist > radius)
+    {
+        return 1;
+    }
+
+    // Lower bound of unobstructed angles of edges in the cell, and range of directions they can block
+    hmin = atan(dist / (cell->zmax - topo->zmax)) * 180.0 / PI;
+    BoxDirections(topo->x, topo->y, cell->end_box, &ind1, &ind2);
+
+    return hmin - HRZN_TOL >= MaxHorizon(ind1, ind2, topo->h_phi);
+}
+
+double BoxDistance(double x, double y, const double box[])
+{
+    double          dx, dy;
+
+    dx = (x < box[0]) ? box[0] - x : ((x > box[1]) ? x - box[1] : 0.0);
+    dy = (y < box[2]) ? box[2] - y : ((y > box[3]) ? y - box[3] : 0.0);
+
+    return sqrt(dx * dx + dy * dy);
+}
+
+void BoxDirections(double x, double y, const double box[], int *ind1, int *ind2)
+{
+    double          phi0, dphi;
+    double          dmin = 0.0, dmax = 0.0;
+    int             k;
+
+    if (x >= box[0] && x <= box[1] && y >= box[2] && y <= box[3])
+    {
+        // Point inside the box can be blocked in all directions
+        *ind1 = 0;
+        *ind2 = 35;
+        return;
+    }
+
+    // Range of directions of box corners, relative to the first corner to handle wrapping at 0 degree
+    phi0 = Azimuth(box[0] - x, box[2] - y);
+    for (k = 1; k < 4; k++)
+    {
+        dphi = Mod(Azimuth(box[k % 2] - x, box[2 + k / 2] - y) - phi0 + 180.0, 360.0) - 180.0;
+        dmin = MIN(dmin, dphi);
+        dmax = MAX(dmax, dphi);
+    }
+
+    if (dmax - dmin >= 180.0)
+    {
+        *ind1 = 0;
+        *ind2 = 35;
+        return;
+    }
+
+    // Directions are widened by one sector on each side to guard against round-off at sector boundaries
+    *ind1 = (int)floor((phi0 + dmin) / 10.0) - 1;
+    *ind2 = (int)floor((phi0 + dmax) / 10.0) + 1;
+}
+
+double MaxHorizon(int ind1, int ind2, const double h_phi[])
+{
+    double          hmax = 0.0;
+    int             ind;
+
+    // Sector indices may be out of [0, 35] and wrap around
+    if (ind2 - ind1 >= 35)
+    {
+        ind1 = 0;
+        ind2 = 35;
+    }
+
+    for (ind = ind1; ind <= ind2; ind++)
+    {
+        hmax = MAX(hmax, h_phi[(ind % 36 + 36) % 36]);
+    }
+
+    return hmax;
+}
+
+void EdgeHorizon(double radius, const hrzn_edge_struct *edge, topo_struct *topo)
+{
+    double          dx, dy, dz;
+    double          c, h;
+    double          phi1, phi2;
+    int             ind, ind1, ind2;
+
+    dx = edge->xc - topo->x;
+    dy = edge->yc - topo->y;
+    dz = edge->zc - topo->zmax;
+    c = sqrt(dx * dx + dy * dy);
+
+    if (dz <= 0.0 || (radius > 0.0 && c > radius))
+    {
+        return;
+    }
+
+    // Unobstructed angle of the edge
+    h = atan(c / dz) * 180.0 / PI;
+
+    // Find out which directions are blocked
+    phi1 = Azimuth(edge->x[0] - topo->x, edge->y[0] - topo->y);
+    phi2 = Azimuth(edge->x[1] - topo->x, edge->y[1] - topo->y);
+
+    if (fabs(phi1 - phi2) > 180.0)
+    {
+        ind1 = 0;
+        ind2 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            topo->h_phi[ind] = MIN(topo->h_phi[ind], h);
+        }
+
+        ind1 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
+        ind2 = 35;
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            topo->h_phi[ind] = MIN(topo->h_phi[ind], h);
+        }
+    }
+    else
+    {
+        ind1 = (int)floor((phi1 < phi2 ? phi1 : phi2) / 10.0);
+        ind2 = (int)floor((phi1 > phi2 ? phi1 : phi2) / 10.0);
+        for (ind = ind1; ind <= ind2; ind++)
+        {
+            topo->h_phi[ind] = MIN(topo->h_phi[ind], h);
+        }
+    }
+}
+
+double Azimuth(double dx, double dy)
+{
+    double          c;
+    double          phi;
+
+    // Direction measured clockwise from north (degree)
+    c = sqrt(dx * dx + dy * dy);
+    phi = acos(dx / c) * 180.0 / PI;
+    phi = (dy / c < 0.0) ? 360.0 - phi : phi;
+
+    return Mod(360.0 - phi + 270.0, 360.0);
+}
+
+int ReadHorizon(const char fn[], double radius, const meshtbl_struct *meshtbl, elem_struct elem[])
+{
+    FILE           *fp;
+    char            cmdstr[MAXSTRING];
+    int             match;
+    int             ncache;
+    double          rcache;
+    unsigned long long checksum;
+    int             index;
+    int             bytes_now;
+    int             bytes_consumed;
+    int             lno = 0;
+    int             i, j;
+
+    if (pihm_access(fn, F_OK) == -1)
+    {
+        return 0;
+    }
+
+    fp = pihm_fopen(fn, "r");
+    pihm_printf(VL_VERBOSE, " Reading %s\n", fn);
+
+    // The cache is only valid for the same mesh, surface elevation, and search radius
+    match = NextLine(fp, cmdstr, &lno) && sscanf(cmdstr, "NUMELE %d", &ncache) == 1 && ncache == nelem;
+    match = match && NextLine(fp, cmdstr, &lno) && sscanf(cmdstr, "RADIUS %lf", &rcache) == 1 && rcache == radius;
+    match = match && NextLine(fp, cmdstr, &lno) && sscanf(cmdstr, "CHECKSUM %llx", &checksum) == 1 &&
+        checksum == HorizonChecksum(radius, meshtbl, elem);
+
+    for (i = 0; i < nelem && match; i++)
+    {
+        match = NextLine(fp, cmdstr, &lno) && sscanf(cmdstr, "%d%n", &index, &bytes_consumed) == 1 &&
+            index == i + 1;
+
+        for (j = 0; j < 36 && match; j++)
+        {
+            match = sscanf(cmdstr + bytes_consumed, "%lf%n", &elem[i].topo.h_phi[j], &bytes_now) == 1;
+            bytes_consumed += bytes_now;
+        }
+    }
+
+    fclose(fp);
+
+    if (!match)
+    {
+        pihm_printf(VL_VERBOSE, " %s does not match current mesh. Horizon angles will be recalculated.\n", fn);
+    }
+
+    return match;
+}
+
+void WriteHorizon(const char fn[], double radius, const meshtbl_struct *meshtbl, const elem_struct elem[])
+{
+    FILE           *fp;
+    int             i, j;
+
+    fp = pihm_fopen(fn, "w");
+    pihm_printf(VL_VERBOSE, " Writing horizon angle cache to %s\n", fn);
+
+    fprintf(fp, "# Unobstructed angles (degree) of every 10 degrees of azimuth, cached by MM-PIHM %s.\n", VERSION);
+    fprintf(fp, "# This file is regenerated if the mesh or HORIZON_RADIUS changes.\n");
+    fprintf(fp, "NUMELE\t%d\n", nelem);
+    fprintf(fp, "RADIUS\t%.17g\n", radius);
+    fprintf(fp, "CHECKSUM\t%016llx\n", HorizonChecksum(radius, meshtbl, elem));
+
+    for (i = 0; i < nelem; i++)
+    {
+        fprintf(fp, "%d", i + 1);
+        for (j = 0; j < 36; j++)
+        {
+            fprintf(fp, "\t%.17g", elem[i].topo.h_phi[j]);
+        }
+        fprintf(fp, "\n");
+    }
+
+    fflush(fp);
+    fclose(fp);
+}
 
-        // Calculate sky view factor (Eq. 7b)
-        for (ind = 0; ind < 36; ind++)
+unsigned long long HorizonChecksum(double radius, const meshtbl_struct *meshtbl, const elem_struct elem[])
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    double          value[3];
+    int             i, j;
+
+    // FNV-1a hash of search radius, and element node indices and coordinates
+    hash = HashBytes(hash, &radius, sizeof(double));
+
+    for (i = 0; i < nelem; i++)
+    {
+        hash = HashBytes(hash, elem[i].node, NUM_EDGE * sizeof(int));
+
+        for (j = 0; j < NUM_EDGE; j++)
         {
-            integrable = sin(elem[i].topo.slope * PI / 180.0) *
-                cos((ind * 10.0 + 5.0 - elem[i].topo.aspect) * PI / 180.0);
-            integrable *= elem[i].topo.h_phi[ind] * PI / 180.0 -
-                sin(elem[i].topo.h_phi[ind] * PI / 180.0) * cos(elem[i].topo.h_phi[ind] * PI / 180.0);
-            integrable += cos(elem[i].topo.slope * PI / 180.0) * pow(sin(elem[i].topo.h_phi[ind] * PI / 180.0), 2);
+            value[0] = meshtbl->x[elem[i].node[j] - 1];
+            value[1] = meshtbl->y[elem[i].node[j] - 1];
+            value[2] = meshtbl->zmax[elem[i].node[j] - 1];
 
-            elem[i].topo.svf += 0.5 / PI * integrable * 10.0 / 180.0 * PI;
+            hash = HashBytes(hash, value, 3 * sizeof(double));
         }
     }
+
+    return hash;
+}
+
+unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size)
+{
+    const unsigned char *byte = (const unsigned char *)data;
+    size_t          k;
+
+    for (k = 0; k < size; k++)
+    {
+        hash ^= byte[k];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
 }
 
 double Mod(double a, double n)
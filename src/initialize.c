@@ -94,11 +94,21 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
     // Initialize element topography
     InitTopo(&pihm->meshtbl, pihm->elem);
 
+#if defined(_NOAH_)
+    // Calculate unobstructed angles and sky view factors
+    InitHorizon(pihm->filename.horizon, pihm->ctrl.rad_mode, pihm->ctrl.horizon_radius, &pihm->meshtbl, pihm->elem);
+#endif
+
     // Calculate average elevation and total area of model domain
     pihm->siteinfo.zmax = AvgElev(pihm->elem);
     pihm->siteinfo.zmin = AvgZmin(pihm->elem);
     pihm->siteinfo.area = TotalArea(pihm->elem);
 
+#if defined(_NOAH_)
+    // Calculate Sun positions and day lengths of the simulation period
+    InitSun(&pihm->ctrl, &pihm->siteinfo, &pihm->sun);
+#endif
+
     // Initialize element soil properties
 #if defined(_NOAH_)
     InitSoil(&pihm->soiltbl, &pihm->noahtbl, &pihm->calib, pihm->elem);
@@ -111,6 +121,9 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
     InitGeol(&pihm->geoltbl, &pihm->calib, pihm->elem);
 #endif
 
+    // Tabulate soil hydraulic functions
+    pihm->vgtbl = InitVgTbl(pihm->ctrl.soil_table, &pihm->nvgtbl, pihm->elem);
+
     // Initialize element land cover properties
     InitLc(&pihm->lctbl, &pihm->calib, pihm->elem);
 
@@ -150,6 +163,8 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
 #if defined(_RT_)
     InitChem(pihm->filename.cdbs, &pihm->calib, &pihm->forc, pihm->chemtbl, pihm->kintbl, &pihm->rttbl, &pihm->chmictbl,
         pihm->elem);
+
+    pihm->rtwork = InitRTWork(&pihm->rttbl);
 #endif
 
 #if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
@@ -162,9 +177,10 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
         // Relaxation mode
         // Noah initialization needs air temperature thus forcing is applied
 #if defined(_RT_)
-        ApplyForcing(pihm->ctrl.starttime, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->rttbl, &pihm->forc, pihm->elem);
+        ApplyForcing(pihm->ctrl.starttime, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->sun, &pihm->rttbl, &pihm->forc,
+            pihm->elem);
 #elif defined(_NOAH_)
-        ApplyForcing(pihm->ctrl.starttime, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->forc, pihm->elem);
+        ApplyForcing(pihm->ctrl.starttime, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->sun, &pihm->forc, pihm->elem);
 #endif
 
         RelaxIc(pihm->elem, pihm->river);
@@ -212,7 +228,19 @@ void Initialize(pihm_struct pihm, N_Vector CV_Y, void **cvode_mem)
         ReadRtIc(pihm->filename.rtic, pihm->elem);
     }
 
-    InitRTVar(pihm->chemtbl, &pihm->rttbl, pihm->elem, pihm->river, CV_Y);
+    InitRTVar(pihm->chemtbl, &pihm->rttbl, pihm->rtwork, pihm->elem, pihm->river, CV_Y);
+#endif
+
+    // Renumber elements and river segments for memory locality
+    Renumber(pihm->ctrl.renumber, &pihm->order, pihm->elem, pihm->river, CV_Y);
+
+    // Initialize hydrology hot state arrays
+    InitHydro(pihm->elem, pihm->river, &pihm->hydro);
+
+#if defined(_MPI_)
+    // Partition the ODE system among MPI processes
+    InitDecomp(pihm->elem, pihm->river, &pihm->mpi);
+    LocalEdgeList(&pihm->mpi, &pihm->hydro);
 #endif
 
     // Calculate model time steps
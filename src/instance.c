@@ -0,0 +1,348 @@
+#include "pihm.h"
+
+// Model instance API. Each instance owns its input, state, solver, and output, so that several simulations can be
+// created, advanced, and destroyed in one process:
+//   pihm = CreatePihm("ShaleHills", "");
+//   while (StepPihm(pihm))
+//   {
+//       ...
+//   }
+//   DestroyPihm(pihm);
+// Model dimensions and modes are process global variables, which are swapped in from the instance context at every
+// call. Instances can thus be interleaved in one thread, but must not be advanced concurrently unless they share the
+// same model domain (see ensemble.c).
+pihm_struct CreatePihm(const char proj[], const char outputdir[])
+{
+    pihm_struct     pihm;
+
+    // Allocate memory for model data structure
+    pihm = (pihm_struct)calloc(1, sizeof(*pihm));
+    if (pihm == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for model instance.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    TimerStart(TM_STARTUP, &pihm->timing);
+
+    strcpy(project, proj);
+    strcpy(pihm->ctx.outputdir, outputdir);
+
+    // Read PIHM input files
+    ReadAlloc(pihm);
+
+    InitPihm(pihm);
+
+    return pihm;
+}
+
+// Create an ensemble member that shares input tables and forcing series with the base structure, which contains
+// input files read by ReadAlloc. Only calibration parameters are different among members
+pihm_struct CreateMember(const pihm_struct base, const char calib_fn[], const char outputdir[])
+{
+    pihm_struct     pihm;
+
+    pihm = (pihm_struct)malloc(sizeof(*pihm));
+    if (pihm == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for model instance.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    *pihm = *base;
+    memset(&pihm->ctx, 0, sizeof(ctx_struct));
+    pihm->ctx.member = 1;
+    strcpy(pihm->ctx.outputdir, outputdir);
+
+    TimerStart(TM_STARTUP, &pihm->timing);
+
+    strcpy(pihm->filename.calib, calib_fn);
+    ReadCalib(pihm->filename.calib, &pihm->calib);
+
+    ShareForc(&base->forc, &pihm->calib, &pihm->forc, &pihm->ctx.own_meteo);
+
+    InitPihm(pihm);
+
+    return pihm;
+}
+
+// Initialize model, solver, and output files of an instance from input files
+void InitPihm(pihm_struct pihm)
+{
+    int             resume;
+
+    // Initialize CVODE state variables
+    pihm->ctx.CV_Y = N_VNew(NumStateVar());
+    if (pihm->ctx.CV_Y == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error creating CVODE state variable vector.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    // Initialize PIHM structure
+    Initialize(pihm, pihm->ctx.CV_Y, &pihm->ctx.cvode_mem);
+
+#if defined(_MPI_)
+    // Only the root process writes output files
+    if (pihm->mpi.rank > 0)
+    {
+        memset(pihm->ctrl.prtvrbl, 0, sizeof(pihm->ctrl.prtvrbl));
+        pihm->ctrl.waterbal = 0;
+        pihm->ctrl.write_ic = 0;
+        pihm->ctrl.timing = 0;
+    }
+    else
+#endif
+    {
+        // Create output directory
+        CreateOutputDir(pihm->ctx.outputdir);
+    }
+
+#if defined(_MPI_)
+    // Output directory is created by the root process, and is used by all processes to write checkpoint files
+    MPI_Bcast(pihm->ctx.outputdir, MAXSTRING, MPI_CHAR, 0, MPI_COMM_WORLD);
+#endif
+
+    // When resuming from a checkpoint, model output is appended to existing output files, which are truncated to
+    // their sizes at the checkpoint
+    resume = (resume_mode && !spinup_mode) ? FindCheckpoint(pihm) : 0;
+
+    // Create output structures
+#if defined(_CYCLES_)
+    MapOutput(pihm->ctx.outputdir, pihm->ctrl.prtvrbl, pihm->croptbl, pihm->elem, pihm->river, &pihm->print);
+#elif defined(_RT_)
+    MapOutput(pihm->ctx.outputdir, pihm->ctrl.prtvrbl, pihm->chemtbl, &pihm->rttbl, pihm->elem, pihm->river,
+        &pihm->print);
+#else
+    MapOutput(pihm->ctx.outputdir, pihm->ctrl.prtvrbl, pihm->elem, pihm->river, &pihm->print);
+#endif
+
+    // Print element and river segment outputs in the original order
+    RenumberOutput(&pihm->order, pihm->elem, pihm->river, &pihm->print);
+
+    // Backup input files
+#if !defined(_MSC_VER)
+# if defined(_MPI_)
+    if (!append_mode && !resume && pihm->mpi.rank == 0)
+# else
+    if (!append_mode && !resume)
+# endif
+    {
+        BackupInput(pihm->ctx.outputdir, &pihm->filename);
+    }
+#endif
+
+    InitOutputFiles(pihm->ctx.outputdir, pihm->ctrl.waterbal, pihm->ctrl.timing, pihm->ctrl.ascii,
+        pihm->ctrl.out_format, append_mode || resume, &pihm->print);
+
+    pihm_printf(VL_VERBOSE, "\n\nSolving ODE system ... \n\n");
+
+    // Set solver parameters
+    SetCVodeParam(pihm, pihm->ctx.cvode_mem, &pihm->ctx.sun_ls, pihm->ctx.CV_Y);
+
+#if defined(_BGC_)
+    first_balance = 1;
+#endif
+
+    if (resume)
+    {
+        ReadCheckpoint(pihm);
+    }
+
+#if defined(_OPENMP)
+    pihm->ctx.start = omp_get_wtime();
+#else
+    pihm->ctx.start = clock();
+#endif
+
+    TimerStop(TM_STARTUP, &pihm->timing);
+
+    SaveContext(pihm);
+}
+
+// Advance the model by one model step. Returns 0 if the end of simulation has been reached and no step is taken
+int StepPihm(pihm_struct pihm)
+{
+    ctrl_struct    *ctrl = &pihm->ctrl;
+    double          cputime, cputime_dt;    // Time cpu duration
+
+    LoadContext(pihm);
+    ClaimWriter(&pihm->print.writer);
+
+    if (ctrl->cstep >= ctrl->nstep)
+    {
+        return 0;
+    }
+
+    RunTime(pihm->ctx.start, &pihm->ctx.ptime, &cputime, &cputime_dt);
+
+    // Run PIHM time step
+    PIHM(cputime, pihm, pihm->ctx.cvode_mem, pihm->ctx.CV_Y);
+
+    // Print wall clock time of model phases
+    if (ctrl->timing != 0)
+    {
+        PrintTiming(ctrl->tout[ctrl->cstep + 1], ctrl->tout[ctrl->cstep + 1] - ctrl->starttime, ctrl->timing,
+            &pihm->timing, pihm->print.timing_file);
+    }
+
+    // Adjust CVODE max step to reduce oscillation
+    AdjCVodeMaxStep(pihm->ctx.cvode_mem, ctrl, &pihm->ctx.maxstep_stat);
+
+    // Print CVODE performance and statistics
+    if (debug_mode)
+    {
+        PrintPerf(ctrl->tout[ctrl->cstep + 1], ctrl->starttime, cputime_dt, cputime, ctrl->maxstep,
+            pihm->print.cvodeperf_file, pihm->ctx.cvode_mem, &pihm->ctx.perf_stat);
+    }
+
+    // Write init files
+    if (ctrl->write_ic)
+    {
+        PrintInit(pihm->ctx.outputdir, ctrl->tout[ctrl->cstep + 1], ctrl->starttime, ctrl->endtime,
+            ctrl->prtvrbl[IC_CTRL], &pihm->order, pihm->elem, pihm->river);
+    }
+
+    ctrl->cstep++;
+
+    if (ctrl->cstep == ctrl->nstep)
+    {
+#if defined(_BGC_)
+        if (ctrl->write_bgc_restart)
+        {
+            WriteBgcIc(pihm->ctx.outputdir, &pihm->order, pihm->elem, pihm->river);
+        }
+#endif
+
+#if defined(_CYCLES_)
+        if (ctrl->write_cycles_restart)
+        {
+            WriteCyclesIc(pihm->ctx.outputdir, &pihm->order, pihm->elem);
+        }
+#endif
+
+#if defined(_RT_)
+        if (ctrl->write_rt_restart)
+        {
+            WriteRtIc(pihm->ctx.outputdir, pihm->chemtbl, &pihm->rttbl, &pihm->order, pihm->elem);
+        }
+#endif
+    }
+
+    // Write checkpoint file
+    if (ctrl->checkpoint != 0 && ctrl->cstep < ctrl->nstep &&
+        PrintNow(ctrl->checkpoint, ctrl->tout[ctrl->cstep] - ctrl->starttime, PIHMTime(ctrl->tout[ctrl->cstep])))
+    {
+        WriteCheckpoint(pihm);
+    }
+
+    SaveContext(pihm);
+
+    return 1;
+}
+
+// Run spin-up simulation and write initial conditions at the end of spin-up
+void SpinupPihm(pihm_struct pihm)
+{
+    ctrl_struct    *ctrl = &pihm->ctrl;
+
+    LoadContext(pihm);
+    ClaimWriter(&pihm->print.writer);
+
+    Spinup(pihm);
+
+    // In spin-up mode, initial conditions are always printed
+#if defined(_MPI_)
+    if (pihm->mpi.rank == 0)
+#endif
+    {
+        PrintInit(pihm->ctx.outputdir, ctrl->endtime, ctrl->starttime, ctrl->endtime, ctrl->prtvrbl[IC_CTRL],
+            &pihm->order, pihm->elem, pihm->river);
+    }
+
+#if defined(_BGC_)
+    WriteBgcIc(pihm->ctx.outputdir, &pihm->order, pihm->elem, pihm->river);
+#endif
+
+#if defined(_CYCLES_)
+    WriteCyclesIc(pihm->ctx.outputdir, &pihm->order, pihm->elem);
+#endif
+
+#if defined(_RT_)
+    WriteRtIc(pihm->ctx.outputdir, pihm->chemtbl, &pihm->rttbl, &pihm->order, pihm->elem);
+#endif
+
+    SaveContext(pihm);
+}
+
+void DestroyPihm(pihm_struct pihm)
+{
+    LoadContext(pihm);
+
+    if (debug_mode)
+    {
+        PrintCVodeFinalStats(pihm->ctx.cvode_mem);
+    }
+
+    // Write timing summary of model phases
+    WriteTiming(pihm->ctx.outputdir, &pihm->timing);
+
+#if defined(_NOAH_)
+    if (pihm->ctrl.lsm_skip > 0)
+    {
+        PrintLsmSkip(pihm->elem);
+    }
+#endif
+
+    // Free memory
+    N_VDestroy(pihm->ctx.CV_Y);
+
+    // Free integrator memory
+    CVodeFree(&pihm->ctx.cvode_mem);
+    SUNLinSolFree(pihm->ctx.sun_ls);
+    FreeMem(pihm);
+    free(pihm);
+}
+
+// Set process global variables from instance context. Globals are only written when they are different so that
+// instances with the same context (i.e., ensemble members) can be advanced concurrently
+void LoadContext(const pihm_struct pihm)
+{
+    if (strcmp(project, pihm->ctx.project) != 0)
+    {
+        strcpy(project, pihm->ctx.project);
+    }
+    if (nelem != pihm->ctx.nelem)
+    {
+        nelem = pihm->ctx.nelem;
+    }
+    if (nriver != pihm->ctx.nriver)
+    {
+        nriver = pihm->ctx.nriver;
+    }
+    if (spinup_mode != pihm->ctx.spinup_mode)
+    {
+        spinup_mode = pihm->ctx.spinup_mode;
+    }
+#if defined(_RT_)
+    nsolute = pihm->ctx.nsolute;
+#endif
+#if defined(_BGC_)
+    first_balance = pihm->ctx.first_balance;
+#endif
+}
+
+// Store process global variables in instance context
+void SaveContext(pihm_struct pihm)
+{
+    strcpy(pihm->ctx.project, project);
+    pihm->ctx.nelem = nelem;
+    pihm->ctx.nriver = nriver;
+    pihm->ctx.spinup_mode = spinup_mode;
+#if defined(_RT_)
+    pihm->ctx.nsolute = nsolute;
+#endif
+#if defined(_BGC_)
+    pihm->ctx.first_balance = first_balance;
+#endif
+}
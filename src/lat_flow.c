@@ -1,57 +1,57 @@
 #include "pihm.h"
 
-void LateralFlow(const river_struct river[], elem_struct elem[])
+void LateralFlow(hydro_struct *hydro, elem_struct elem[])
 {
     int             i;
-    double         *dh_dx;
-    double         *dh_dy;
 
-    dh_dx = (double *)malloc(nelem * sizeof(double));
-    dh_dy = (double *)malloc(nelem * sizeof(double));
+    FrictionSlope(hydro);
 
-    FrictionSlope(elem, river, dh_dx, dh_dy);
+#if defined(_VEC_)
+    OvlFlowVec(hydro);
+#endif
 
+    // Boundary condition flux
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-    for (i = 0; i < nelem; i++)
+    for (i = 0; i < hydro->nbound; i++)
     {
-        int             j;
-        double          avg_sf;
-        elem_struct    *nabr;
+        int             ind = hydro->bound_ind[i];
+        elem_struct    *elem_ptr = &elem[ind / NUM_EDGE];
 
-        for (j = 0; j < NUM_EDGE; j++)
-        {
-            if (elem[i].nabr[j] == 0)   // Boundary condition flux
-            {
-                BoundFluxElem(elem[i].attrib.bc[j], j, &elem[i].topo, &elem[i].soil, &elem[i].bc, &elem[i].ws,
-                    &elem[i].wf);
-            }
-            else
-            {
-                nabr = &elem[elem[i].nabr[j] - 1];
+        BoundFluxElem(elem_ptr->attrib.bc[ind % NUM_EDGE], ind % NUM_EDGE, &elem_ptr->topo, &elem_ptr->soil,
+            &elem_ptr->bc, &elem_ptr->ws, &elem_ptr->wf);
+    }
 
-                // Subsurface flow between triangular elements
-                elem[i].wf.subsurf[j] = SubsurfFlow(j, &elem[i], nabr);
-
-                // Surface flow between triangular elements
-                if (elem[i].nabr_river[j] == 0)
-                {
-                    // Surface flux between triangular elements
-                    // avg_sf not needed in kinematic mode
-                    avg_sf = 0.5 *
-                        (sqrt(dh_dx[i] * dh_dx[i] + dh_dy[i] * dh_dy[i]) +
-                        sqrt(dh_dx[nabr->ind - 1] * dh_dx[nabr->ind - 1] +
-                        dh_dy[nabr->ind - 1] * dh_dy[nabr->ind - 1]));
-
-                    elem[i].wf.overland[j] = OvlFlowElemToElem(j, avg_sf, &elem[i], nabr);
-                }
-            }
-        }   // End of neighbor loop
-    }   // End of element loop
+    // Fluxes between triangular elements are calculated once for each shared edge, and are written to the elements on
+    // both sides. Each edge of an element belongs to only one shared edge, so the loop is free of write conflicts
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < hydro->nedge; i++)
+    {
+        int             ind0 = hydro->edge_ind[2 * i];
+        int             ind1 = hydro->edge_ind[2 * i + 1];
+        double          flux[2];
+
+        // Subsurface flow between triangular elements
+        SubsurfFlowEdge(i, hydro, flux);
+        elem[ind0 / NUM_EDGE].wf.subsurf[ind0 % NUM_EDGE] = flux[0];
+        elem[ind1 / NUM_EDGE].wf.subsurf[ind1 % NUM_EDGE] = flux[1];
 
-    free(dh_dx);
-    free(dh_dy);
+        // Surface flow between triangular elements
+        if (i < hydro->nedge_ovl)
+        {
+#if defined(_VEC_)
+            flux[0] = hydro->ovl_flux[2 * i];
+            flux[1] = hydro->ovl_flux[2 * i + 1];
+#else
+            OvlFlowEdge(i, hydro, flux);
+#endif
+            elem[ind0 / NUM_EDGE].wf.overland[ind0 % NUM_EDGE] = flux[0];
+            elem[ind1 / NUM_EDGE].wf.overland[ind1 % NUM_EDGE] = flux[1];
+        }
+    }
 
 #if defined(_DGW_)
     // Lateral deep groundwater flow
@@ -82,50 +82,42 @@ void LateralFlow(const river_struct river[], elem_struct elem[])
 #endif
 }
 
-void FrictionSlope(const elem_struct elem[], const river_struct river[], double dh_dx[], double dh_dy[])
+void FrictionSlope(hydro_struct *hydro)
 {
     int             i;
+
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
     for (i = 0; i < nelem; i++)
     {
         int             j;
+        int             ind;
         double          surfh[NUM_EDGE];
-        double          x[NUM_EDGE];
-        double          y[NUM_EDGE];
-        const elem_struct *nabr;
-        const river_struct *river_nabr;
+        double          dh_dx, dh_dy;
 
         for (j = 0; j < NUM_EDGE; j++)
         {
-            if (elem[i].nabr[j] == 0)
+            ind = NUM_EDGE * i + j;
+
+            if (hydro->nabr[ind] < 0)
             {
-                surfh[j] = elem[i].topo.zmax + elem[i].ws.surfh;
-                x[j] = elem[i].topo.x_nabr[j];
-                y[j] = elem[i].topo.y_nabr[j];
+                surfh[j] = hydro->zmax[i] + hydro->surfh[i];
             }
-            else if (elem[i].nabr_river[j] == 0)
+            else if (hydro->nabr_river[ind] < 0)
             {
-                nabr = &elem[elem[i].nabr[j] - 1];
-
-                surfh[j] = nabr->topo.zmax + nabr->ws.surfh;
-                x[j] = elem[i].topo.x_nabr[j];
-                y[j] = elem[i].topo.y_nabr[j];
+                surfh[j] = hydro->zmax[hydro->nabr[ind]] + hydro->surfh[hydro->nabr[ind]];
             }
             else
             {
-                river_nabr = &river[elem[i].nabr_river[j] - 1];
-
-                surfh[j] = (river_nabr->ws.stage > river_nabr->shp.depth) ?
-                    river_nabr->topo.zbed + river_nabr->ws.stage : river_nabr->topo.zmax;
-                x[j] = river[elem[i].nabr_river[j] - 1].topo.x;
-                y[j] = river[elem[i].nabr_river[j] - 1].topo.y;
+                surfh[j] = hydro->river_head[hydro->nabr_river[ind]];
             }
         }
 
-        dh_dx[i] = DhByDl(y, x, surfh);
-        dh_dy[i] = DhByDl(x, y, surfh);
+        dh_dx = DhByDl(&hydro->y_nabr[NUM_EDGE * i], &hydro->x_nabr[NUM_EDGE * i], surfh);
+        dh_dy = DhByDl(&hydro->x_nabr[NUM_EDGE * i], &hydro->y_nabr[NUM_EDGE * i], surfh);
+
+        hydro->sf[i] = sqrt(dh_dx * dh_dx + dh_dy * dh_dy);
     }
 }
 
@@ -181,44 +173,97 @@ double OverLandFlow(double avg_h, double grad_h, double avg_sf, double cross_are
     return cross_area * pow(avg_h, 0.6666667) * grad_h / (sqrt(avg_sf) * avg_rough);
 }
 
-double SubsurfFlow(int j, const elem_struct *elem_ptr, const elem_struct *nabr)
+double SubsurfFlow(int i, int j, const hydro_struct *hydro)
 {
+    int             nabr;
     double          diff_h;
     double          avg_h;
     double          grad_h;
-    double          effk, effk_nabr;
     double          avg_ksat;
 
+    nabr = hydro->nabr[NUM_EDGE * i + j];
+
     // Subsurface lateral flux calculation between triangular elements
-    diff_h = (elem_ptr->ws.gw + elem_ptr->topo.zmin) - (nabr->ws.gw + nabr->topo.zmin);
-    avg_h = AvgH(diff_h, elem_ptr->ws.gw, nabr->ws.gw);
-    grad_h = diff_h / elem_ptr->topo.dist_nabr[j];
+    diff_h = (hydro->gw[i] + hydro->zmin[i]) - (hydro->gw[nabr] + hydro->zmin[nabr]);
+    avg_h = AvgH(diff_h, hydro->gw[i], hydro->gw[nabr]);
+    grad_h = diff_h / hydro->dist_nabr[NUM_EDGE * i + j];
 
     // Take into account macropore effect
-    effk = EffKh(elem_ptr->ws.gw, &elem_ptr->soil);
-    effk_nabr = EffKh(nabr->ws.gw, &nabr->soil);
-    avg_ksat = 0.5 * (effk + effk_nabr);
+    avg_ksat = 0.5 * (hydro->effk[i] + hydro->effk[nabr]);
+
+    // Groundwater flow modeled by Darcy's Law
+    return avg_ksat * grad_h * avg_h * hydro->edge[NUM_EDGE * i + j];
+}
+
+// Subsurface fluxes through a shared edge, out of the elements on both sides of the edge. The flux out of the second
+// element is the negative of the first one, except for zero head difference, for which both are positive zeros
+void SubsurfFlowEdge(int k, const hydro_struct *hydro, double flux[])
+{
+    int             ind = hydro->edge_ind[2 * k];
+    int             i = ind / NUM_EDGE;
+    int             nabr = hydro->nabr[ind];
+    double          diff_h;
+    double          avg_h;
+    double          grad_h;
+    double          avg_ksat;
+
+    diff_h = (hydro->gw[i] + hydro->zmin[i]) - (hydro->gw[nabr] + hydro->zmin[nabr]);
+    avg_h = AvgH(diff_h, hydro->gw[i], hydro->gw[nabr]);
+    grad_h = diff_h / hydro->dist_nabr[ind];
+
+    // Take into account macropore effect
+    avg_ksat = 0.5 * (hydro->effk[i] + hydro->effk[nabr]);
 
     // Groundwater flow modeled by Darcy's Law
-    return avg_ksat * grad_h * avg_h * elem_ptr->topo.edge[j];
+    flux[0] = avg_ksat * grad_h * avg_h * hydro->edge[ind];
+    flux[1] = (diff_h == 0.0) ? flux[0] : -flux[0];
 }
 
-double OvlFlowElemToElem(int j, double avg_sf, const elem_struct *elem_ptr, const elem_struct *nabr)
+// Overland fluxes through a shared edge, out of the elements on both sides of the edge. Both directions use the water
+// depth of the upstream element, so the flow depth term is only evaluated once. Because of the minimum gradient, the
+// two fluxes are not antisymmetric
+void OvlFlowEdge(int k, const hydro_struct *hydro, double flux[])
 {
+    int             ind = hydro->edge_ind[2 * k];
+    int             i = ind / NUM_EDGE;
+    int             nabr = hydro->nabr[ind];
     double          diff_h;
     double          avg_h;
     double          grad_h;
+    double          avg_sf;
     double          avg_rough;
     double          cross_area;
+    double          conv;
+    double          denom;
 
-    diff_h = (elem_ptr->ws.surfh + elem_ptr->topo.zmax) - (nabr->ws.surfh + nabr->topo.zmax);
-    avg_h = AvgHsurf(diff_h, elem_ptr->ws.surfh, nabr->ws.surfh);
-    grad_h = MAX(diff_h / elem_ptr->topo.dist_nabr[j], GRADMIN);
-    avg_sf = MAX(avg_sf, GRADMIN);
-    avg_rough = 0.5 * (elem_ptr->lc.rough + nabr->lc.rough);
-    cross_area = avg_h * elem_ptr->topo.edge[j];
+    diff_h = (hydro->surfh[i] + hydro->zmax[i]) - (hydro->surfh[nabr] + hydro->zmax[nabr]);
+    grad_h = diff_h / hydro->dist_nabr[ind];
+    // avg_sf not needed in kinematic mode
+    avg_sf = MAX(0.5 * (hydro->sf[i] + hydro->sf[nabr]), GRADMIN);
+    avg_rough = 0.5 * (hydro->rough[i] + hydro->rough[nabr]);
 
-    return OverLandFlow(avg_h, grad_h, avg_sf, cross_area, avg_rough);
+    if (diff_h == 0.0)
+    {
+        // Each element sees the water depth of the other one
+        avg_h = AvgHsurf(diff_h, hydro->surfh[i], hydro->surfh[nabr]);
+        cross_area = avg_h * hydro->edge[ind];
+        flux[0] = OverLandFlow(avg_h, GRADMIN, avg_sf, cross_area, avg_rough);
+
+        avg_h = AvgHsurf(diff_h, hydro->surfh[nabr], hydro->surfh[i]);
+        cross_area = avg_h * hydro->edge[ind];
+        flux[1] = OverLandFlow(avg_h, GRADMIN, avg_sf, cross_area, avg_rough);
+    }
+    else
+    {
+        avg_h = AvgHsurf(diff_h, hydro->surfh[i], hydro->surfh[nabr]);
+        cross_area = avg_h * hydro->edge[ind];
+
+        // Same evaluation order as OverLandFlow
+        conv = cross_area * pow(avg_h, 0.6666667);
+        denom = sqrt(avg_sf) * avg_rough;
+        flux[0] = conv * MAX(grad_h, GRADMIN) / denom;
+        flux[1] = conv * MAX(-grad_h, GRADMIN) / denom;
+    }
 }
 
 void BoundFluxElem(int bc_type, int j, const topo_struct *topo, const soil_struct *soil, const bc_struct *bc,
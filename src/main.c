@@ -4,6 +4,7 @@
 int             verbose_mode;
 int             debug_mode;
 int             append_mode;
+int             resume_mode;
 int             corr_mode;
 int             spinup_mode;
 int             fixed_length;
@@ -27,17 +28,14 @@ int             first_balance;
 int main(int argc, char *argv[])
 {
     char            outputdir[MAXSTRING];
+    char            ensemble_fn[MAXSTRING];
     pihm_struct     pihm;
-    ctrl_struct    *ctrl;
-    N_Vector        CV_Y;
-    void           *cvode_mem;
-    SUNLinearSolver sun_ls;
-#if defined(_OPENMP)
-    double          start_omp;
-#else
-    clock_t         start;
+#if defined(_MPI_)
+    int             rank;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 #endif
-    double          cputime, cputime_dt;    // Time cpu duration
 
 #if defined(unix) || defined(__unix__) || defined(__unix)
     feenableexcept(FE_DIVBYZERO | FE_INVALID | FE_OVERFLOW);
@@ -62,159 +60,61 @@ int main(int argc, char *argv[])
 
 
     memset(outputdir, 0, MAXSTRING);
+    memset(ensemble_fn, 0, MAXSTRING);
 
     // Read command line arguments
-    ParseCmdLineParam(argc, argv, outputdir);
-
-    // Print AscII art
-    StartupScreen();
-
-    // Allocate memory for model data structure
-    pihm = (pihm_struct)malloc(sizeof(*pihm));
+    ParseCmdLineParam(argc, argv, outputdir, ensemble_fn);
 
-    // Read PIHM input files
-    ReadAlloc(pihm);
-
-    // Initialize CVODE state variables
-    CV_Y = N_VNew(NumStateVar());
-    if (CV_Y == NULL)
+#if defined(_MPI_)
+    // Only the root process prints to screen
+    if (rank > 0)
     {
-        pihm_printf(VL_ERROR, "Error creating CVODE state variable vector.\n");
-        pihm_exit(EXIT_FAILURE);
+        verbose_mode = VL_SILENT;
+        debug_mode = 0;
     }
-
-    // Initialize PIHM structure
-    Initialize(pihm, CV_Y, &cvode_mem);
-
-    // Create output directory
-    CreateOutputDir(outputdir);
-
-    // Create output structures
-#if defined(_CYCLES_)
-    MapOutput(outputdir, pihm->ctrl.prtvrbl, pihm->croptbl, pihm->elem, pihm->river, &pihm->print);
-#elif defined(_RT_)
-    MapOutput(outputdir, pihm->ctrl.prtvrbl, pihm->chemtbl, &pihm->rttbl, pihm->elem, pihm->river, &pihm->print);
-#else
-    MapOutput(outputdir, pihm->ctrl.prtvrbl, pihm->elem, pihm->river, &pihm->print);
 #endif
 
-    // Backup input files
-#if !defined(_MSC_VER)
-    if (!append_mode)
+    // Print AscII art
+    StartupScreen();
+
+    if (ensemble_fn[0] != '\0')
     {
-        BackupInput(outputdir, &pihm->filename);
-    }
+#if defined(_MPI_)
+        pihm_printf(VL_ERROR, "Error: Ensemble mode is not available in MPI mode.\n");
+        pihm_exit(EXIT_FAILURE);
 #endif
 
-    InitOutputFiles(outputdir, pihm->ctrl.waterbal, pihm->ctrl.ascii, &pihm->print);
+        // Run ensemble members that share input files
+        RunEnsemble(ensemble_fn, outputdir);
 
-    pihm_printf(VL_VERBOSE, "\n\nSolving ODE system ... \n\n");
+        pihm_printf(VL_BRIEF, "Simulation completed.\n");
 
-    // Set solver parameters
-    SetCVodeParam(pihm, cvode_mem, &sun_ls, CV_Y);
+        return EXIT_SUCCESS;
+    }
 
-#if defined(_BGC_)
-    first_balance = 1;
-#endif
+    // Read input files, and initialize model, solver, and output files
+    pihm = CreatePihm(project, outputdir);
 
     // Run PIHM
-#if defined(_OPENMP)
-    start_omp = omp_get_wtime();
-#else
-    start = clock();
-#endif
-
-    ctrl = &pihm->ctrl;
-
     if (spinup_mode)
     {
-        Spinup(pihm, CV_Y, cvode_mem, &sun_ls);
-
-        // In spin-up mode, initial conditions are always printed
-        PrintInit(outputdir, ctrl->endtime, ctrl->starttime, ctrl->endtime, ctrl->prtvrbl[IC_CTRL], pihm->elem,
-            pihm->river);
-
-#if defined(_BGC_)
-        WriteBgcIc(outputdir, pihm->elem, pihm->river);
-#endif
-
-#if defined(_CYCLES_)
-        WriteCyclesIc(outputdir, pihm->elem);
-#endif
-
-#if defined(_RT_)
-        WriteRtIc(outputdir, pihm->chemtbl, &pihm->rttbl, pihm->elem);
-#endif
+        SpinupPihm(pihm);
     }
     else
     {
-        for (ctrl->cstep = 0; ctrl->cstep < ctrl->nstep; ctrl->cstep++)
+        while (StepPihm(pihm))
         {
-#if defined(_OPENMP)
-            RunTime(start_omp, &cputime, &cputime_dt);
-#else
-            RunTime(start, &cputime, &cputime_dt);
-#endif
-
-            // Run PIHM time step
-            PIHM(cputime, pihm, cvode_mem, CV_Y);
-
-            // Adjust CVODE max step to reduce oscillation
-            AdjCVodeMaxStep(cvode_mem, &pihm->ctrl);
-
-            // Print CVODE performance and statistics
-            if (debug_mode)
-            {
-                PrintPerf(ctrl->tout[ctrl->cstep + 1], ctrl->starttime, cputime_dt, cputime, ctrl->maxstep,
-                    pihm->print.cvodeperf_file, cvode_mem);
-            }
-
-            // Write init files
-            if (ctrl->write_ic)
-            {
-                PrintInit(outputdir, ctrl->tout[ctrl->cstep + 1], ctrl->starttime, ctrl->endtime,
-                    ctrl->prtvrbl[IC_CTRL], pihm->elem, pihm->river);
-            }
-
         }
-
-#if defined(_BGC_)
-        if (ctrl->write_bgc_restart)
-        {
-            WriteBgcIc(outputdir, pihm->elem, pihm->river);
-        }
-#endif
-
-#if defined(_CYCLES_)
-        if (ctrl->write_cycles_restart)
-        {
-            WriteCyclesIc(outputdir, pihm->elem);
-        }
-#endif
-
-#if defined(_RT_)
-        if (ctrl->write_rt_restart)
-        {
-            WriteRtIc(outputdir, pihm->chemtbl, &pihm->rttbl, pihm->elem);
-        }
-#endif
-    }
-
-    if (debug_mode)
-    {
-        PrintCVodeFinalStats(cvode_mem);
     }
 
     // Free memory
-    N_VDestroy(CV_Y);
-
-    // Free integrator memory
-    CVodeFree(&cvode_mem);
-    SUNLinSolFree(sun_ls);
-    FreeMem(pihm);
-    free(pihm);
+    DestroyPihm(pihm);
 
     pihm_printf(VL_BRIEF, "Simulation completed.\n");
 
+#if defined(_MPI_)
+    MPI_Finalize();
+#endif
+
     return EXIT_SUCCESS;
 }
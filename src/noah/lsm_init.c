@@ -42,6 +42,8 @@ void InitLsm(const char ice_fn[], const ctrl_struct *ctrl, const noahtbl_struct
         DefineSoilDepths(ctrl->nlayers, elem[i].soil.depth, ctrl->soil_depth, &elem[i].ps.nlayers,
             elem[i].ps.soil_depth, elem[i].ps.zsoil);
 
+        InitActivity(&elem[i]);
+
         // Set-up glacier ice parameters
         elem[i].ps.iceh = (elem[i].lc.glacier == 1) ? ((read_ice_flag == 1) ? iceh[i] : ICEH) : 0.0;
 
@@ -54,6 +54,32 @@ void ReadLsm(const char fn[], ctrl_struct *ctrl, siteinfo_struct *siteinfo, noah
     NextLine(fp, cmdstr, &lno);
     ReadKeyword(cmdstr, "RAD_MODE_DATA", 'i', fn, lno, &ctrl->rad_mode);
 
+    // Horizon search radius is optional, and is unlimited by default
+    ctrl->horizon_radius = 0.0;
+    if (NextOptLine(fp, "HORIZON_RADIUS", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "HORIZON_RADIUS", 'd', fn, lno, &ctrl->horizon_radius);
+    }
+    if (ctrl->horizon_radius < 0.0)
+    {
+        pihm_printf(VL_ERROR, "Horizon search radius should not be negative.\n");
+        pihm_printf(VL_ERROR, "Error in %s near Line %d.\n", fn, lno);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    // Skipping of land surface steps is optional, and is turned off by default
+    ctrl->lsm_skip = 0;
+    if (NextOptLine(fp, "LSM_SKIP", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "LSM_SKIP", 'i', fn, lno, &ctrl->lsm_skip);
+    }
+    if (ctrl->lsm_skip < 0)
+    {
+        pihm_printf(VL_ERROR, "Maximum number of skipped land surface steps should not be negative.\n");
+        pihm_printf(VL_ERROR, "Error in %s near Line %d.\n", fn, lno);
+        pihm_exit(EXIT_FAILURE);
+    }
+
     NextLine(fp, cmdstr, &lno);
     ReadKeyword(cmdstr, "SBETA_DATA", 'd', fn, lno, &noahtbl->sbeta);
 
@@ -153,7 +179,7 @@ void ReadRad(const char fn[], forc_struct *forc)
         pihm_exit(EXIT_FAILURE);
     }
 
-    forc->rad = (tsdata_struct *)malloc(forc->nrad * sizeof(tsdata_struct));
+    forc->rad = (tsdata_struct *)calloc(forc->nrad, sizeof(tsdata_struct));
 
     FindLine(fp, "BOF", &lno, fn);
 
@@ -0,0 +1,116 @@
+#include "pihm.h"
+
+// Skip the land surface step of an inactive element, i.e., an element whose forcing and states have not changed
+// significantly since its last full land surface step. Fluxes of the last full step are reused. To keep water balance
+// closed, only elements without canopy water and precipitation, and without melting snow are skipped, so that the
+// reused fluxes do not change canopy water storage, and snow storage is updated using the reused sublimation
+// (deposition) rate. A full step is forced after lsm_skip consecutive skipped steps. Returns 1 if the step is skipped
+int SkipLsm(int lsm_skip, double dt, elem_struct *elem)
+{
+    activity_struct *act = &elem->act;
+    double          esnow2;
+    int             kz;
+    const double    ESDMIN = 1.0E-6;
+
+    act->steps++;
+
+    if (act->nskip >= lsm_skip || elem->lc.glacier == 1)
+    {
+        return 0;
+    }
+
+    // Water fluxes of the last full step must not change canopy water storage, and snow must not be melting
+    if (elem->wf.prcp > 0.0 || elem->ws.cmc > 0.0 || elem->wf.ec != 0.0 || elem->wf.pcpdrp != 0.0 ||
+        elem->wf.dew != 0.0 || elem->wf.snomlt != 0.0)
+    {
+        return 0;
+    }
+
+    esnow2 = elem->wf.esnow * dt;
+    if (elem->ws.sneqv > 0.0 &&
+        (elem->es.t1 >= TFREEZ || elem->ps.sndens <= 0.0 || elem->ws.sneqv - esnow2 <= ESDMIN))
+    {
+        return 0;
+    }
+
+    // Changes of forcing since the last full step, and changes of states in (skin temperature) or since (soil
+    // moisture) the last full step
+    if (fabs(elem->es.sfctmp - act->sfctmp) > SKIP_DTEMP || fabs(elem->ef.soldn - act->soldn) > SKIP_DRAD ||
+        fabs(elem->ef.longwave - act->longwave) > SKIP_DRAD || fabs(elem->ps.q2 - act->q2) > SKIP_DQ ||
+        fabs(elem->ps.sfcspd - act->sfcspd) > SKIP_DWIND || fabs(elem->ps.sfcprs - act->sfcprs) > SKIP_DPRES ||
+        fabs(elem->ps.proj_lai - act->proj_lai) > SKIP_DLAI || fabs(act->dt1) > SKIP_DTEMP)
+    {
+        return 0;
+    }
+
+    for (kz = 0; kz < elem->ps.nlayers; kz++)
+    {
+        if (fabs(elem->ws.smc[kz] - act->smc[kz]) > SKIP_DSMC)
+        {
+            return 0;
+        }
+    }
+
+    // Update snowpack using the reused sublimation (deposition) rate, assuming constant snow density
+    if (elem->ws.sneqv > 0.0)
+    {
+        elem->ws.sneqv -= esnow2;
+        elem->ps.snowh = elem->ws.sneqv / elem->ps.sndens;
+    }
+
+    act->nskip++;
+    act->skipped++;
+
+    return 1;
+}
+
+// Record forcing and states of a full land surface step. t1 is the skin temperature before the step
+void RecordLsm(double t1, elem_struct *elem)
+{
+    activity_struct *act = &elem->act;
+    int             kz;
+
+    act->nskip = 0;
+    act->sfctmp = elem->es.sfctmp;
+    act->soldn = elem->ef.soldn;
+    act->longwave = elem->ef.longwave;
+    act->q2 = elem->ps.q2;
+    act->sfcspd = elem->ps.sfcspd;
+    act->sfcprs = elem->ps.sfcprs;
+    act->proj_lai = elem->ps.proj_lai;
+    act->dt1 = elem->es.t1 - t1;
+
+    for (kz = 0; kz < elem->ps.nlayers; kz++)
+    {
+        act->smc[kz] = elem->ws.smc[kz];
+    }
+}
+
+void InitActivity(elem_struct *elem)
+{
+    activity_struct *act = &elem->act;
+
+    act->nskip = 0;
+    act->skipped = 0;
+    act->steps = 0;
+
+    // The first land surface step is always a full step
+    act->dt1 = BADVAL;
+}
+
+// Report the fraction of skipped land surface steps of all elements. In MPI mode, each process runs land surface steps
+// of all elements, thus counts of the root process are reported
+void PrintLsmSkip(const elem_struct elem[])
+{
+    long int        count[2] = { 0, 0 };
+    int             i;
+
+    for (i = 0; i < nelem; i++)
+    {
+        count[0] += elem[i].act.skipped;
+        count[1] += elem[i].act.steps;
+    }
+
+    pihm_printf(VL_NORMAL, "Skipped %ld of %ld (%.2lf%%) land surface steps of inactive elements.\n", count[0],
+        count[1], (count[1] > 0) ? 100.0 * (double)count[0] / (double)count[1] : 0.0);
+}
@@ -1,6 +1,6 @@
 #include "pihm.h"
 
-void Noah(double dt, const lctbl_struct *lctbl, const calib_struct *calib, elem_struct elem[])
+void Noah(double dt, int lsm_skip, const lctbl_struct *lctbl, const calib_struct *calib, elem_struct elem[])
 {
     int             i;
 
@@ -10,6 +10,7 @@ void Noah(double dt, const lctbl_struct *lctbl, const calib_struct *calib, elem_
     for (i = 0; i < nelem; i++)
     {
         int             kz;
+        double          t1;
 
         // When ice on a glacier grid is all melted, turn land use to barren
         if (elem[i].lc.glacier == 1 && elem[i].ps.iceh <= 0.0)
@@ -22,6 +23,12 @@ void Noah(double dt, const lctbl_struct *lctbl, const calib_struct *calib, elem_
 
         CalHum(&elem[i].ps, &elem[i].es);
 
+        // Reuse fluxes of the last full land surface step in inactive elements
+        if (lsm_skip > 0 && SkipLsm(lsm_skip, dt, &elem[i]))
+        {
+            continue;
+        }
+
         elem[i].ps.ffrozp = FrozRain(elem[i].wf.prcp, elem[i].es.sfctmp);
 
         elem[i].ps.alb = BADVAL;
@@ -39,6 +46,8 @@ void Noah(double dt, const lctbl_struct *lctbl, const calib_struct *calib, elem_
         }
 
         // Run Noah LSM
+        t1 = elem[i].es.t1;
+
         if (elem[i].lc.glacier == 1)
         {
             SFlxGlacial(dt, &elem[i].soil, &elem[i].lc, &elem[i].ps, &elem[i].ws, &elem[i].wf, &elem[i].es,
@@ -59,6 +68,11 @@ void Noah(double dt, const lctbl_struct *lctbl, const calib_struct *calib, elem_
         elem[i].wf.ec   = elem[i].ef.ec / LVH2O / 1000.0;
         elem[i].wf.ett  = elem[i].ef.ett / LVH2O / 1000.0;
         elem[i].wf.edir = elem[i].ef.edir / LVH2O / 1000.0;
+
+        if (lsm_skip > 0)
+        {
+            RecordLsm(t1, &elem[i]);
+        }
     }
 }
 
@@ -83,9 +97,23 @@ void NoahHydrol(double dt, elem_struct elem[])
             elem[i].ws.swc[kz] = MIN(elem[i].ws.swc[kz], elem[i].ws.smc[kz]);
         }
 
+#if !defined(_VEC_)
         SmFlx(dt, &elem[i].soil, &elem[i].ps, &elem[i].ws, &elem[i].wf);
+#endif
+    }
+
+#if defined(_VEC_)
+    // Solve soil moisture of blocks of elements together
+    SmFlxVec(dt, elem);
+#endif
 
 #if defined(_CYCLES_)
+# if defined(_OPENMP)
+#  pragma omp parallel for
+# endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             kz;
         double          wflux[MAXLYR + 1];
 
         // Calculate vertical transport of solute
@@ -115,8 +143,8 @@ void NoahHydrol(double dt, elem_struct elem[])
         SoluteTransp(elem[i].ps.kd_no3, 0.0, wflux, elem[i].ws.smc, &elem[i].soil, &elem[i].ps, elem[i].ns.no3);
 
         SoluteTransp(elem[i].ps.kd_nh4, 0.0, wflux, elem[i].ws.smc, &elem[i].soil, &elem[i].ps, elem[i].ns.nh4);
-#endif
     }
+#endif
 
 #if TEMP_DISABLED
 # if defined(_DEBUG_)
@@ -1884,7 +1912,7 @@ void SRT(const soil_struct *soil, double rhstt[], double sice[], double ai[], do
     phystate_struct *ps, wstate_struct *ws, wflux_struct *wf)
 {
     int             iohinf;
-    int             j, jj, k, kz;
+    int             kz;
     double          ddz;
     double          ddz2;
     double          denom;
@@ -1898,18 +1926,7 @@ void SRT(const soil_struct *soil, double rhstt[], double sice[], double ai[], do
     double          wdf;
     double          wdf2;
     double          dsmdz, dsmdz2;
-    double          dice;
-    const double    CVFRZ = 3.0;
-    double          acrt;
-    double          sum;
-    int             ialp1;
-    // Frozen ground version:
-    // Reference frozen ground parameter, cvfrz, is a shape parameter of areal distribution function of soil ice content
-    // which equals 1/cv.
-    // Cv is a coefficient of spatial variation of soil ice content. Based on field data cv depends on areal mean of
-    // frozen depth, and it close to constant = 0.6 if areal mean frozen depth is above 20 cm. That is why parameter
-    // cvfrz = 3 (int{1/0.6*0.6}). Current logic doesn't allow cvfrz be bigger than 3
-    //
+
     // Let sicemax be the greatest, if any, frozen water content within soil layers.
     iohinf = 1;
     sicemax = 0.0;
@@ -1920,31 +1937,7 @@ void SRT(const soil_struct *soil, double rhstt[], double sice[], double ai[], do
     }
 
     // Calculate infiltration reduction factor due to frozen soil
-    dice = -ps->zsoil[0] * sice[0];
-    for (kz = 1; kz < ps->nlayers; kz++)
-    {
-        dice += (ps->zsoil[kz - 1] - ps->zsoil[kz]) * sice[kz];
-    }
-
-    ps->fcr = 1.0;
-
-    if (dice > 1.0E-2)
-    {
-        acrt = CVFRZ * ps->frzx / dice;
-        sum = 1.0;
-        ialp1 = roundi(CVFRZ) - 1;
-        for (j = 1; j < ialp1 + 1; j++)
-        {
-            k = 1;
-            for (jj = j + 1; jj < ialp1 + 1; jj++)
-            {
-                k *= jj;
-            }
-            sum += pow(acrt, CVFRZ - (double)j) / (double)k;
-        }
-
-        ps->fcr = 1.0 - exp(-acrt) * sum;
-    }
+    ps->fcr = FrzFcr(sice, ps);
 
     // Determine rainfall infiltration rate and runoff
     pddum = wf->eqv_infil;
@@ -2017,6 +2010,50 @@ void SRT(const soil_struct *soil, double rhstt[], double sice[], double ai[], do
     }
 }
 
+// Calculate infiltration reduction factor due to frozen soil
+double FrzFcr(const double sice[], const phystate_struct *ps)
+{
+    int             j, jj, k, kz;
+    double          dice;
+    const double    CVFRZ = 3.0;
+    double          acrt;
+    double          sum;
+    int             ialp1;
+    double          fcr = 1.0;
+
+    // Frozen ground version:
+    // Reference frozen ground parameter, cvfrz, is a shape parameter of areal distribution function of soil ice content
+    // which equals 1/cv.
+    // Cv is a coefficient of spatial variation of soil ice content. Based on field data cv depends on areal mean of
+    // frozen depth, and it close to constant = 0.6 if areal mean frozen depth is above 20 cm. That is why parameter
+    // cvfrz = 3 (int{1/0.6*0.6}). Current logic doesn't allow cvfrz be bigger than 3
+    dice = -ps->zsoil[0] * sice[0];
+    for (kz = 1; kz < ps->nlayers; kz++)
+    {
+        dice += (ps->zsoil[kz - 1] - ps->zsoil[kz]) * sice[kz];
+    }
+
+    if (dice > 1.0E-2)
+    {
+        acrt = CVFRZ * ps->frzx / dice;
+        sum = 1.0;
+        ialp1 = roundi(CVFRZ) - 1;
+        for (j = 1; j < ialp1 + 1; j++)
+        {
+            k = 1;
+            for (jj = j + 1; jj < ialp1 + 1; jj++)
+            {
+                k *= jj;
+            }
+            sum += pow(acrt, CVFRZ - (double)j) / (double)k;
+        }
+
+        fcr = 1.0 - exp(-acrt) * sum;
+    }
+
+    return fcr;
+}
+
 // Calculate/update soil moisture content values and canopy moisture content values.
 void SStep(double dt, const soil_struct *soil, double rhstt[], double sice[], double ai[], double bi[], double ci[],
     phystate_struct *ps, wstate_struct *ws, wflux_struct *wf)
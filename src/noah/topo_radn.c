@@ -1,35 +1,161 @@
 #include "pihm.h"
 
-double TopoRadn(double sdir, double sdif, double zenith, double azimuth180, const topo_struct *topo)
+double TopoRadn(double sdir, double sdif, const sunpos_struct *sunpos, const topo_struct *topo)
 {
     double          incidence;              // Sun incidence angle (degree)
-    double          tcf;                    // terrain configuration factor (-)
     double          soldown;
 
-    azimuth180 = Mod(360.0 + azimuth180, 360.0);
-
     // If the Sun is blocked, set direct solar radiation to 0.0
-    sdir = (zenith > topo->h_phi[(int)floor(azimuth180 / 10.0)]) ? 0.0 : sdir;
+    sdir = (sunpos->zenith > topo->h_phi[(int)floor(sunpos->azimuth / 10.0)]) ? 0.0 : sdir;
 
     // Calculate Sun incidence angle
-    incidence = acos(cos(zenith * PI / 180.0) * cos(topo->slope * PI / 180.0) +
-        sin(zenith * PI / 180.0) * sin(topo->slope * PI / 180.0) * cos((azimuth180 - topo->aspect) * PI / 180.0));
+    incidence = acos(sunpos->cos_zenith * topo->cos_slope +
+        sunpos->sin_zenith * topo->sin_slope * cos((sunpos->azimuth - topo->aspect) * PI / 180.0));
     incidence *= 180.0 / PI;
     incidence = MIN(incidence, 90.0);
 
-    // Calculate terrain configuration factor
-    // Dozier and Frew 1990, IEEE Transactions on Geoscience and Remote Sensing, 28(5), 963--969
-    tcf = (1.0 + cos(topo->slope * PI / 180.0)) / 2.0 - topo->svf;
-    tcf = MAX(tcf, 0.0);
-
+    // Terrain configuration factor is calculated in InitHorizon
     soldown = sdir * cos(incidence * PI / 180.0) + topo->svf * sdif +
-        0.2 * tcf * (sdir * cos(zenith * PI / 180.0) + sdif);
+        0.2 * topo->tcf * (sdir * sunpos->cos_zenith + sdif);
     soldown = MAX(soldown, 0.0);
 
     return soldown;
 }
 
-void SunPos(int t, const siteinfo_struct *siteinfo, spa_data *spa)
+// Calculate topographic solar radiation of all elements from direct and diffuse solar radiation at the same Sun
+// position
+void TopoRadnBatch(const sunpos_struct *sunpos, elem_struct elem[])
+{
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        elem[i].ef.soldn = TopoRadn(elem[i].ef.soldir, elem[i].ef.soldif, sunpos, &elem[i].topo);
+        elem[i].ef.soldn = MAX(elem[i].ef.soldn, 0.0);
+    }
+}
+
+// Calculate Sun positions at land surface steps and day lengths of the simulation period. The full SPA is only
+// evaluated once for each time here, instead of at every land surface step, and in every spinup cycle
+void InitSun(const ctrl_struct *ctrl, const siteinfo_struct *siteinfo, sun_struct *sun)
+{
+    int             k;
+
+    sun->t0 = ctrl->starttime;
+#if defined(_CYCLES_)
+    // Cycles averages hourly forcing of each day
+    sun->dt = 3600;
+    sun->nstep = (ctrl->endtime - ctrl->starttime + DAYINSEC) / sun->dt;
+#else
+    sun->dt = ctrl->etstep;
+    sun->nstep = (ctrl->endtime - ctrl->starttime) / sun->dt + 1;
+#endif
+
+    // Sun positions are only needed by topographic solar radiation
+    sun->nstep = (ctrl->rad_mode == TOPO_SOL) ? sun->nstep : 0;
+    sun->pos = (sun->nstep > 0) ? (sunpos_struct *)malloc(sun->nstep * sizeof(sunpos_struct)) : NULL;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (k = 0; k < sun->nstep; k++)
+    {
+        spa_data        spa;
+
+        // Sunrise and sunset are not needed for Sun positions
+        SunPos(sun->t0 + k * sun->dt, SPA_ZA, siteinfo, &spa);
+        SetSunPos(&spa, &sun->pos[k]);
+    }
+
+#if defined(_BGC_)
+    // Daily BGC uses day lengths of current and previous days
+    sun->day0 = ctrl->starttime - DAYINSEC;
+    sun->nday = (ctrl->endtime - sun->day0) / DAYINSEC + 1;
+    sun->dayl = (double *)malloc(sun->nday * sizeof(double));
+
+# if defined(_OPENMP)
+#  pragma omp parallel for
+# endif
+    for (k = 0; k < sun->nday; k++)
+    {
+        spa_data        spa;
+
+        SunPos(sun->day0 + k * DAYINSEC, SPA_ZA_RTS, siteinfo, &spa);
+        sun->dayl[k] = SpaDayLength(&spa);
+    }
+#endif
+}
+
+void FreeSun(sun_struct *sun)
+{
+    free(sun->pos);
+#if defined(_BGC_)
+    free(sun->dayl);
+#endif
+}
+
+// Get Sun position from the Sun position table. Times that are not in the table are calculated using SPA
+void SunPosition(int t, const siteinfo_struct *siteinfo, const sun_struct *sun, sunpos_struct *sunpos)
+{
+    int             k;
+    spa_data        spa;
+
+    k = (t - sun->t0) / sun->dt;
+
+    if (t >= sun->t0 && (t - sun->t0) % sun->dt == 0 && k < sun->nstep)
+    {
+        *sunpos = sun->pos[k];
+    }
+    else
+    {
+        SunPos(t, SPA_ZA, siteinfo, &spa);
+        SetSunPos(&spa, sunpos);
+    }
+}
+
+#if defined(_BGC_)
+// Get day length from the day length table. Times that are not in the table are calculated using SPA
+double DayLength(int t, const siteinfo_struct *siteinfo, const sun_struct *sun)
+{
+    int             k;
+    spa_data        spa;
+
+    k = (t - sun->day0) / DAYINSEC;
+
+    if (t >= sun->day0 && (t - sun->day0) % DAYINSEC == 0 && k < sun->nday)
+    {
+        return sun->dayl[k];
+    }
+    else
+    {
+        SunPos(t, SPA_ZA_RTS, siteinfo, &spa);
+        return SpaDayLength(&spa);
+    }
+}
+#endif
+
+void SetSunPos(const spa_data *spa, sunpos_struct *sunpos)
+{
+    sunpos->zenith = spa->zenith;
+    sunpos->azimuth = Mod(360.0 + spa->azimuth180, 360.0);
+    sunpos->cos_zenith = cos(spa->zenith * PI / 180.0);
+    sunpos->sin_zenith = sin(spa->zenith * PI / 180.0);
+}
+
+double SpaDayLength(const spa_data *spa)
+{
+    double          dayl;
+
+    dayl = (spa->sunset - spa->sunrise) * 3600.0;
+    dayl = (dayl < 0.0) ? (dayl + 24.0 * 3600.0) : dayl;
+
+    return dayl;
+}
+
+void SunPos(int t, int function, const siteinfo_struct *siteinfo, spa_data *spa)
 {
     int             spa_result;
     pihm_t_struct   pihm_time;
@@ -56,7 +182,7 @@ void SunPos(int t, const siteinfo_struct *siteinfo, spa_data *spa)
     spa->pressure = 1013.25 * pow((293.0 - 0.0065 * spa->elevation) / 293.0, 5.26);
     spa->temperature = siteinfo->tavg;
 
-    spa->function = SPA_ZA_RTS;
+    spa->function = function;
     spa_result = spa_calculate(spa);
 
     if (spa_result != 0)
@@ -64,5 +190,4 @@ void SunPos(int t, const siteinfo_struct *siteinfo, spa_data *spa)
         pihm_printf(VL_ERROR, "Error with spa error code: %d.\n", spa_result);
         pihm_exit(EXIT_FAILURE);
     }
-
 }
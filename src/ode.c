@@ -8,13 +8,28 @@ int Ode(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
     pihm_struct     pihm;
     elem_struct    *elem;
     river_struct   *river;
+    const hydro_struct *hydro;
 
+    pihm = (pihm_struct)pihm_data;
+
+    TimerStart(TM_RHS, &pihm->timing);
+
+#if defined(_MPI_)
+    // CV_Y and CV_Ydot only contain state variables owned by this process. Fluxes are calculated using the global state
+    // vector, in which halo values are received from other processes
+    y = NV_DATA(pihm->ctx.CV_Y);
+    dy = pihm->mpi.ydot;
+    TimerStart(TM_HALO, &pihm->timing);
+    ExchangeHalo(NV_DATA_P(CV_Y), &pihm->mpi, y);
+    TimerStop(TM_HALO, &pihm->timing);
+#else
     y = NV_DATA(CV_Y);
     dy = NV_DATA(CV_Ydot);
-    pihm = (pihm_struct)pihm_data;
+#endif
 
     elem = &pihm->elem[0];
     river = &pihm->river[0];
+    hydro = &pihm->hydro;
 
     // Initialization of RHS of ODEs
 #if defined(_OPENMP)
@@ -88,9 +103,12 @@ int Ode(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
     }
 
     // PIHM Hydrology fluxes
-    Hydrol(&pihm->ctrl, pihm->elem, pihm->river);
+    Hydrol(&pihm->ctrl, &pihm->hydro, &pihm->timing, pihm->elem, pihm->river);
 
     // Calculate solute concentrations
+#if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
+    TimerStart(TM_TRANSPT, &pihm->timing);
+#endif
 #if defined(_BGC_)
     SoluteConc(pihm->elem, pihm->river);
 #elif defined(_CYCLES_)
@@ -101,9 +119,13 @@ int Ode(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 
 
 #if defined(_BGC_) || defined(_CYCLES_)
-    SoluteTranspt(0.0, 0.0, 0.0, pihm->elem, pihm->river);
+    SoluteTranspt(0.0, 0.0, 0.0, &pihm->hydro, pihm->elem, pihm->river);
 #elif defined(_RT_)
-    SoluteTranspt(pihm->rttbl.diff_coef, pihm->rttbl.disp_coef, pihm->rttbl.cementation, pihm->elem, pihm->river);
+    SoluteTranspt(pihm->rttbl.diff_coef, pihm->rttbl.disp_coef, pihm->rttbl.cementation, &pihm->hydro, pihm->elem,
+        pihm->river);
+#endif
+#if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
+    TimerStop(TM_TRANSPT, &pihm->timing);
 #endif
 
     // Build RHS of ODEs
@@ -130,15 +152,15 @@ int Ode(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
         // Horizontal water fluxes
         for (j = 0; j < NUM_EDGE; j++)
         {
-            dy[SURF(i)] -= elem[i].wf.overland[j] / elem[i].topo.area;
-            dy[GW(i)] -= elem[i].wf.subsurf[j] / elem[i].topo.area;
+            dy[SURF(i)] -= elem[i].wf.overland[j] / hydro->area[i];
+            dy[GW(i)] -= elem[i].wf.subsurf[j] / hydro->area[i];
 #if defined(_DGW_)
             dy[GW_GEOL(i)] -= elem[i].wf.dgw[j] / elem[i].topo.area;
 #endif
         }
 
-        dy[UNSAT(i)] /= elem[i].soil.porosity;
-        dy[GW(i)] /= elem[i].soil.porosity;
+        dy[UNSAT(i)] /= hydro->porosity[i];
+        dy[GW(i)] /= hydro->porosity[i];
 #if defined(_DGW_)
         dy[UNSAT_GEOL(i)] /= elem[i].geol.porosity;
         dy[GW_GEOL(i)] /= elem[i].geol.porosity;
@@ -199,6 +221,12 @@ int Ode(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, void *pihm_data)
 #endif
     }
 
+#if defined(_MPI_)
+    LocalState(dy, &pihm->mpi, NV_DATA_P(CV_Ydot));
+#endif
+
+    TimerStop(TM_RHS, &pihm->timing);
+
     return 0;
 }
 
@@ -226,7 +254,6 @@ int NumStateVar(void)
 void SetCVodeParam(pihm_struct pihm, void *cvode_mem, SUNLinearSolver *sun_ls, N_Vector CV_Y)
 {
     int             cv_flag;
-    static int      reset;
     N_Vector        abstol;
 #if defined(_BGC_) || defined(_CYCLES_)
     const double    TRANSP_TOL = 1.0E-5;
@@ -236,7 +263,13 @@ void SetCVodeParam(pihm_struct pihm, void *cvode_mem, SUNLinearSolver *sun_ls, N
 
     pihm->ctrl.maxstep = pihm->ctrl.stepsize;
 
-    if (reset)
+#if defined(_MPI_)
+    // CVODE integrates state variables owned by this process
+    LocalState(NV_DATA(CV_Y), &pihm->mpi, NV_DATA_P(pihm->mpi.CV_Yl));
+    CV_Y = pihm->mpi.CV_Yl;
+#endif
+
+    if (pihm->ctx.cvode_init)
     {
         // When model spins-up and recycles forcing, use CVodeReInit to reset solver time, which does not allocates
         // memory
@@ -247,32 +280,48 @@ void SetCVodeParam(pihm_struct pihm, void *cvode_mem, SUNLinearSolver *sun_ls, N
     {
         cv_flag = CVodeInit(cvode_mem, Ode, 0.0, CV_Y);
         CheckCVodeFlag(cv_flag);
-        reset = 1;
+        pihm->ctx.cvode_init = 1;
 
-        *sun_ls = SUNLinSol_SPGMR(CV_Y, PREC_NONE, 0);
-
-        // Attach the linear solver
-        CVodeSetLinearSolver(cvode_mem, *sun_ls, NULL);
+        // Specifies PIHM data block and attaches it to the main cvode memory block. User data must be specified before
+        // attaching the linear solver, which passes user data to preconditioner functions
+        cv_flag = CVodeSetUserData(cvode_mem, pihm);
+        CheckCVodeFlag(cv_flag);
 
         // When BGC, Cycles, or RT module is turned on, both water storage and transport variables are in the CVODE
         // vector. A vector of absolute tolerances is needed to specify different absolute tolerances for water storage
         // variables and transport variables
+#if defined(_MPI_)
+        abstol = N_VNew_Parallel(MPI_COMM_WORLD, pihm->mpi.nlocal, NumStateVar());
+        N_VConst((realtype)pihm->ctrl.abstol, abstol);
+#else
         abstol = N_VNew(NumStateVar());
-#if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
+# if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
         SetAbsTolArray(pihm->ctrl.abstol, TRANSP_TOL, abstol);
-#else
+# else
         SetAbsTolArray(pihm->ctrl.abstol, abstol);
+# endif
 #endif
 
         cv_flag = CVodeSVtolerances(cvode_mem, (realtype)pihm->ctrl.reltol, abstol);
         CheckCVodeFlag(cv_flag);
 
-        N_VDestroy(abstol);
+        *sun_ls = SUNLinSol_SPGMR(CV_Y, (pihm->ctrl.precond == BLOCK_PRECOND) ? PREC_LEFT : PREC_NONE, 0);
 
-        // Specifies PIHM data block and attaches it to the main cvode memory block
-        cv_flag = CVodeSetUserData(cvode_mem, pihm);
+        // Attach the linear solver
+        cv_flag = CVodeSetLinearSolver(cvode_mem, *sun_ls, NULL);
         CheckCVodeFlag(cv_flag);
 
+        if (pihm->ctrl.precond == BLOCK_PRECOND)
+        {
+            // Physics-based block preconditioner (see precond.c)
+            InitPrec(&pihm->prec);
+
+            cv_flag = CVodeSetPreconditioner(cvode_mem, PrecSetup, PrecSolve);
+            CheckCVodeFlag(cv_flag);
+        }
+
+        N_VDestroy(abstol);
+
         // Specifies the initial step size
         cv_flag = CVodeSetInitStep(cvode_mem, (realtype)pihm->ctrl.initstep);
         CheckCVodeFlag(cv_flag);
@@ -380,15 +429,12 @@ void SolveCVode(double cputime, const ctrl_struct *ctrl, int *t, void *cvode_mem
     }
 }
 
-void AdjCVodeMaxStep(void *cvode_mem, ctrl_struct *ctrl)
+void AdjCVodeMaxStep(void *cvode_mem, ctrl_struct *ctrl, cvstat_struct *stat0)
 {
     // Variable CVODE max step (to reduce oscillations)
     long int        nst;
     long int        ncfn;
     long int        nni;
-    static long int nst0;
-    static long int ncfn0;
-    static long int nni0;
     int             cv_flag;
     double          nsteps;
     double          nfails;
@@ -406,9 +452,9 @@ void AdjCVodeMaxStep(void *cvode_mem, ctrl_struct *ctrl)
     cv_flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
     CheckCVodeFlag(cv_flag);
 
-    nsteps = (double)(nst - nst0);
-    nfails = (double)(ncfn - ncfn0) / nsteps;
-    niters = (double)(nni - nni0) / nsteps;
+    nsteps = (double)(nst - stat0->nst);
+    nfails = (double)(ncfn - stat0->ncfn) / nsteps;
+    niters = (double)(nni - stat0->nni) / nsteps;
 
     ctrl->maxstep /= (nfails > ctrl->nncfn || niters >= ctrl->nnimax) ? ctrl->decr : 1.0;
 
@@ -421,7 +467,7 @@ void AdjCVodeMaxStep(void *cvode_mem, ctrl_struct *ctrl)
     cv_flag = CVodeSetMaxStep(cvode_mem, (realtype)ctrl->maxstep);
     CheckCVodeFlag(cv_flag);
 
-    nst0  = nst;
-    ncfn0 = ncfn;
-    nni0  = nni;
+    stat0->nst  = nst;
+    stat0->ncfn = ncfn;
+    stat0->nni  = nni;
 }
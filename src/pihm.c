@@ -7,30 +7,37 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
     const int       SPECIATION_STEP = 3600;
 #endif
 
+    TimerStart(TM_STEP, &pihm->timing);
+
     t = pihm->ctrl.tout[pihm->ctrl.cstep];
 
     // Apply boundary conditions
+    TimerStart(TM_APPLY_BC, &pihm->timing);
 #if defined(_RT_)
     ApplyBc(t, &pihm->rttbl, &pihm->forc, pihm->elem, pihm->river);
 #else
     ApplyBc(t, &pihm->forc, pihm->elem, pihm->river);
 #endif
+    TimerStop(TM_APPLY_BC, &pihm->timing);
 
     // Apply forcing and simulate land surface processes
     if ((t - pihm->ctrl.starttime) % pihm->ctrl.etstep == 0)
     {
         // Apply forcing
+        TimerStart(TM_FORCING, &pihm->timing);
 #if defined(_RT_)
-        ApplyForcing(t, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->rttbl, &pihm->forc, pihm->elem);
+        ApplyForcing(t, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->sun, &pihm->rttbl, &pihm->forc, pihm->elem);
 #elif defined(_NOAH_)
-        ApplyForcing(t, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->forc, pihm->elem);
+        ApplyForcing(t, pihm->ctrl.rad_mode, &pihm->siteinfo, &pihm->sun, &pihm->forc, pihm->elem);
 #else
         ApplyForcing(t, &pihm->forc, pihm->elem);
 #endif
+        TimerStop(TM_FORCING, &pihm->timing);
 
+        TimerStart(TM_LSM, &pihm->timing);
 #if defined(_NOAH_)
         // Calculate surface energy balance
-        Noah((double)pihm->ctrl.etstep, &pihm->lctbl, &pihm->calib, pihm->elem);
+        Noah((double)pihm->ctrl.etstep, pihm->ctrl.lsm_skip, &pihm->lctbl, &pihm->calib, pihm->elem);
 #else
         // Calculate Interception storage and ET
         IntcpSnowEt(t, (double)pihm->ctrl.etstep, &pihm->calib, pihm->elem);
@@ -38,6 +45,7 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
 
         // Update print variables for land surface step variables
         UpdatePrintVar(pihm->print.nprint, LS_STEP, pihm->print.varctrl);
+        TimerStop(TM_LSM, &pihm->timing);
     }
 
 #if defined(_RT_)
@@ -46,7 +54,9 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
     {
         if ((t - pihm->ctrl.starttime) % pihm->ctrl.AvgScl == 0)
         {
-            Reaction((double)pihm->ctrl.AvgScl, pihm->chemtbl, pihm->kintbl, &pihm->rttbl, pihm->elem);
+            TimerStart(TM_REACTION, &pihm->timing);
+            Reaction((double)pihm->ctrl.AvgScl, pihm->chemtbl, pihm->kintbl, &pihm->rttbl, pihm->rtwork, pihm->elem);
+            TimerStop(TM_REACTION, &pihm->timing);
         }
     }
 #endif
@@ -54,17 +64,33 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
 #if defined(_CYCLES_)
     if ((t - pihm->ctrl.starttime) % DAYINSEC == 0)
     {
+        TimerStart(TM_DAILY, &pihm->timing);
         Cycles(t, &pihm->co2ctrl, &pihm->forc, pihm->elem);
 
         // Update print variables for CN (daily) step variables
         UpdatePrintVar(pihm->print.nprint, CN_STEP, pihm->print.varctrl);
+        TimerStop(TM_DAILY, &pihm->timing);
     }
 #endif
 
     // Solve PIHM hydrology ODE using CVode
+    TimerStart(TM_CVODE, &pihm->timing);
+#if defined(_MPI_)
+    SolveCVode(cputime, &pihm->ctrl, &t, cvode_mem, pihm->mpi.CV_Yl);
+    TimerStop(TM_CVODE, &pihm->timing);
+
+    // Gather state variables and fluxes from all processes
+    TimerStart(TM_GATHER, &pihm->timing);
+    GatherState(NV_DATA_P(pihm->mpi.CV_Yl), &pihm->mpi, NV_DATA(CV_Y));
+    GatherFlux(&pihm->mpi, pihm->elem, pihm->river);
+    TimerStop(TM_GATHER, &pihm->timing);
+#else
     SolveCVode(cputime, &pihm->ctrl, &t, cvode_mem, CV_Y);
+    TimerStop(TM_CVODE, &pihm->timing);
+#endif
 
     // Use mass balance to calculate model fluxes or variables
+    TimerStart(TM_UPDATE, &pihm->timing);
     UpdateVar((double)pihm->ctrl.stepsize, pihm->elem, pihm->river, CV_Y);
 
 #if defined(_NOAH_)
@@ -81,7 +107,7 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
         if ((t - pihm->ctrl.starttime) % SPECIATION_STEP == 0)
         {
             // Speciation
-            RiverSpeciation(pihm->chemtbl, &pihm->rttbl, pihm->river);
+            RiverSpeciation(pihm->chemtbl, &pihm->rttbl, pihm->rtwork, pihm->river);
         }
     }
     else
@@ -91,6 +117,7 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
 
     UpdatePrintVar(pihm->print.nprint, RT_STEP, pihm->print.varctrl);
 #endif
+    TimerStop(TM_UPDATE, &pihm->timing);
 
 #if defined(_DAILY_)
     DailyVar(t, pihm->ctrl.starttime, pihm->elem);
@@ -100,10 +127,12 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
     {
 # if defined(_BGC_)
         // Daily BGC processes
+        TimerStart(TM_DAILY, &pihm->timing);
         DailyBgc(t - DAYINSEC, pihm);
 
         // Update print variables for CN (daily) step variables
         UpdatePrintVar(pihm->print.nprint, CN_STEP, pihm->print.varctrl);
+        TimerStop(TM_DAILY, &pihm->timing);
 # endif
 
         // Initialize daily structures
@@ -112,13 +141,19 @@ void PIHM(double cputime, pihm_struct pihm, void *cvode_mem, N_Vector CV_Y)
 #endif
 
     // Print outputs
+    TimerStart(TM_PRINT, &pihm->timing);
+
     // Print water balance
     if (pihm->ctrl.waterbal)
     {
         PrintWaterBalance(t, pihm->ctrl.starttime, pihm->ctrl.stepsize, pihm->elem, pihm->river,
-            pihm->print.watbal_file);
+            pihm->print.watbal_file, &pihm->ctx);
     }
 
     // Print binary and txt output files
-    PrintData(pihm->print.nprint, t, t - pihm->ctrl.starttime, pihm->ctrl.ascii, pihm->print.varctrl);
+    PrintData(pihm->print.nprint, t, t - pihm->ctrl.starttime, pihm->ctrl.ascii, &pihm->print.writer,
+        pihm->print.varctrl);
+    TimerStop(TM_PRINT, &pihm->timing);
+
+    TimerStop(TM_STEP, &pihm->timing);
 }
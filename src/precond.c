@@ -0,0 +1,471 @@
+#include "pihm.h"
+
+// Number of hydrologic state variables in an element block (surface, unsaturated zone, and groundwater)
+#define NUM_BLK_VAR             3
+#define BLK_SURF                0
+#define BLK_UNSAT               1
+#define BLK_GW                  2
+
+// Entries of river segment Jacobian: stage, and surface and groundwater of left and right banks
+#define NUM_RIV_JAC             5
+#define RIV_STAGE               0
+#define LEFT_SURF               1
+#define LEFT_GW                 2
+#define RIGHT_SURF              3
+#define RIGHT_GW                4
+
+// Minimum head difference (m) for which a secant conductance is calculated
+#define DHMIN                   1.0E-10
+
+void InitPrec(prec_struct *prec)
+{
+    // Element blocks are stored as columns of dense matrices so that SUNDIALS small dense functions can be applied to
+    // each NUM_BLK_VAR by NUM_BLK_VAR block
+    prec->elem_jac = newDenseMat(NUM_BLK_VAR, NUM_BLK_VAR * nelem);
+    prec->elem_blk = newDenseMat(NUM_BLK_VAR, NUM_BLK_VAR * nelem);
+    prec->pivot = newIndexArray(NUM_BLK_VAR * nelem);
+    prec->river_jac = newDenseMat(NUM_RIV_JAC, nriver);
+    prec->river_diag = (double *)malloc(nriver * sizeof(double));
+
+    if (prec->elem_jac == NULL || prec->elem_blk == NULL || prec->pivot == NULL || prec->river_jac == NULL ||
+        prec->river_diag == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for preconditioner.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+}
+
+void FreePrec(prec_struct *prec)
+{
+    destroyMat(prec->elem_jac);
+    destroyMat(prec->elem_blk);
+    destroyArray(prec->pivot);
+    destroyMat(prec->river_jac);
+    free(prec->river_diag);
+}
+
+// Preconditioner Jacobians and factored blocks are reused by CVODE until its next preconditioner setup
+void CheckpointPrec(int mode, prec_struct *prec, FILE *fp)
+{
+    // Dense matrices are stored in contiguous memory starting from the first column
+    CheckpointIo(mode, prec->elem_jac[0], sizeof(realtype), NUM_BLK_VAR * NUM_BLK_VAR * nelem, fp);
+    CheckpointIo(mode, prec->elem_blk[0], sizeof(realtype), NUM_BLK_VAR * NUM_BLK_VAR * nelem, fp);
+    CheckpointIo(mode, prec->pivot, sizeof(sunindextype), NUM_BLK_VAR * nelem, fp);
+    if (nriver > 0)
+    {
+        CheckpointIo(mode, prec->river_jac[0], sizeof(realtype), NUM_RIV_JAC * nriver, fp);
+    }
+    CheckpointIo(mode, prec->river_diag, sizeof(double), nriver, fp);
+}
+
+// Preconditioner setup function. The preconditioner approximates I - gamma * J using
+//   1. for each element, the 3 x 3 block of surface, unsaturated zone, and groundwater, in which vertical coupling
+//      (infiltration and recharge) is obtained by finite difference of Infil and Recharge, and lateral fluxes are
+//      linearized using secant conductances of the current fluxes;
+//   2. for each river segment, the stage diagonal and its coupling to the surface and groundwater of bank elements.
+// CVODE always calls the setup function right after evaluating Ode at CV_Y, so element and river states and fluxes are
+// consistent with CV_Y when the Jacobian is built
+int PrecSetup(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, booleantype jok, booleantype *jcur, realtype gamma,
+    void *pihm_data)
+{
+    int             i;
+    int             flag = 0;
+    pihm_struct     pihm;
+    prec_struct    *prec;
+
+    // The Jacobian is built from element and river variables instead of CV_Y
+    (void)t;
+    (void)CV_Y;
+    (void)CV_Ydot;
+
+    pihm = (pihm_struct)pihm_data;
+    prec = &pihm->prec;
+
+    TimerStart(TM_PREC_SETUP, &pihm->timing);
+
+    if (jok)
+    {
+        // Reuse saved Jacobian
+        *jcur = SUNFALSE;
+    }
+    else
+    {
+        ElemJac((double)pihm->ctrl.stepsize, &pihm->hydro, pihm->elem, pihm->river, prec->elem_jac);
+
+        RiverJac(&pihm->hydro, pihm->elem, pihm->river, prec->river_jac);
+
+        *jcur = SUNTRUE;
+    }
+
+    // Form and factor I - gamma * J for each element block
+#if defined(_OPENMP)
+# pragma omp parallel for reduction(+: flag)
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             j, k;
+        realtype      **blk;
+
+#if defined(_MPI_)
+        if (pihm->mpi.elem_rank[i] != pihm->mpi.rank)
+        {
+            continue;
+        }
+#endif
+
+        blk = &prec->elem_blk[NUM_BLK_VAR * i];
+
+        for (k = 0; k < NUM_BLK_VAR; k++)
+        {
+            for (j = 0; j < NUM_BLK_VAR; j++)
+            {
+                blk[k][j] = ((j == k) ? 1.0 : 0.0) - gamma * prec->elem_jac[NUM_BLK_VAR * i + k][j];
+            }
+        }
+
+        flag += (denseGETRF(blk, NUM_BLK_VAR, NUM_BLK_VAR, &prec->pivot[NUM_BLK_VAR * i]) != 0) ? 1 : 0;
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        prec->river_diag[i] = 1.0 - gamma * prec->river_jac[i][RIV_STAGE];
+    }
+
+#if defined(_MPI_)
+    // All processes must return the same value
+    MPI_Allreduce(MPI_IN_PLACE, &flag, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    TimerStop(TM_PREC_SETUP, &pihm->timing);
+
+    // A positive return value indicates a recoverable error, so that CVODE will retry with a new Jacobian or a smaller
+    // step
+    return (flag > 0) ? 1 : 0;
+}
+
+// Preconditioner solve function. Solves P z = r using a block Gauss-Seidel sweep: element blocks are solved first,
+// and river segments are then solved using the updated bank element states. Solute and deep zone state variables are
+// not preconditioned
+int PrecSolve(realtype t, N_Vector CV_Y, N_Vector CV_Ydot, N_Vector r, N_Vector z, realtype gamma, realtype delta,
+    int lr, void *pihm_data)
+{
+    int             i;
+    double         *rr;
+    double         *zz;
+    pihm_struct     pihm;
+    prec_struct    *prec;
+    const river_struct *river;
+
+    // The block sweep does not iterate, thus tolerance delta is not used. lr is always 1 (left preconditioning)
+    (void)t;
+    (void)CV_Y;
+    (void)CV_Ydot;
+    (void)delta;
+    (void)lr;
+
+    pihm = (pihm_struct)pihm_data;
+    prec = &pihm->prec;
+    river = pihm->river;
+
+    TimerStart(TM_PREC_SOLVE, &pihm->timing);
+
+#if defined(_MPI_)
+    // Residuals of state variables owned by other processes are zero, thus the preconditioner is block Jacobi across
+    // processes
+    rr = pihm->mpi.rwork;
+    zz = pihm->mpi.zwork;
+
+    for (i = 0; i < NumStateVar(); i++)
+    {
+        rr[i] = 0.0;
+    }
+    GlobalState(NV_DATA_P(r), &pihm->mpi, rr);
+    memcpy(zz, rr, NumStateVar() * sizeof(double));
+#else
+    rr = NV_DATA(r);
+    zz = NV_DATA(z);
+
+    N_VScale(1.0, r, z);
+#endif
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        realtype        x[NUM_BLK_VAR];
+
+#if defined(_MPI_)
+        if (pihm->mpi.elem_rank[i] != pihm->mpi.rank)
+        {
+            continue;
+        }
+#endif
+
+        x[BLK_SURF] = rr[SURF(i)];
+        x[BLK_UNSAT] = rr[UNSAT(i)];
+        x[BLK_GW] = rr[GW(i)];
+
+        denseGETRS(&prec->elem_blk[NUM_BLK_VAR * i], NUM_BLK_VAR, &prec->pivot[NUM_BLK_VAR * i], x);
+
+        zz[SURF(i)] = x[BLK_SURF];
+        zz[UNSAT(i)] = x[BLK_UNSAT];
+        zz[GW(i)] = x[BLK_GW];
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        double          rhs;
+
+        rhs = rr[RIVER(i)];
+
+        if (river[i].left > 0)
+        {
+            rhs += gamma * (prec->river_jac[i][LEFT_SURF] * zz[SURF(river[i].left - 1)] +
+                prec->river_jac[i][LEFT_GW] * zz[GW(river[i].left - 1)]);
+        }
+
+        if (river[i].right > 0)
+        {
+            rhs += gamma * (prec->river_jac[i][RIGHT_SURF] * zz[SURF(river[i].right - 1)] +
+                prec->river_jac[i][RIGHT_GW] * zz[GW(river[i].right - 1)]);
+        }
+
+        zz[RIVER(i)] = rhs / prec->river_diag[i];
+    }
+
+#if defined(_MPI_)
+    LocalState(zz, &pihm->mpi, NV_DATA_P(z));
+#endif
+
+    TimerStop(TM_PREC_SOLVE, &pihm->timing);
+
+    return 0;
+}
+
+void ElemJac(double dt, const hydro_struct *hydro, const elem_struct elem[], const river_struct river[],
+    realtype **jac)
+{
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             j, k;
+        double          dinfil[NUM_BLK_VAR];
+        double          drechg[NUM_BLK_VAR];
+        double          dsurfh;
+        double          csurf = 0.0;
+        double          cgw = 0.0;
+        double          head_surf;
+        double          head_gw;
+        wstate_struct   ws;
+        wflux_struct    wf;
+        realtype      **blk;
+        const elem_struct *nabr;
+        const river_struct *river_nabr;
+
+        blk = &jac[NUM_BLK_VAR * i];
+
+        // Vertical coupling by finite difference of infiltration and recharge
+        for (k = 0; k < NUM_BLK_VAR; k++)
+        {
+            double          inc;
+
+            ws = elem[i].ws;
+            wf = elem[i].wf;
+
+            switch (k)
+            {
+                case BLK_SURF:
+                    inc = SUNRsqrt(UNIT_ROUNDOFF) * MAX(fabs(ws.surf), 1.0);
+                    ws.surf += inc;
+                    ws.surfh = SurfH(ws.surf);
+                    break;
+                case BLK_UNSAT:
+                    inc = SUNRsqrt(UNIT_ROUNDOFF) * MAX(fabs(ws.unsat), 1.0);
+                    ws.unsat += inc;
+                    break;
+                default:
+                    inc = SUNRsqrt(UNIT_ROUNDOFF) * MAX(fabs(ws.gw), 1.0);
+                    ws.gw += inc;
+                    break;
+            }
+
+            wf.infil = Infil(dt, &elem[i].topo, &elem[i].soil, &ws, &elem[i].ws0, &wf);
+#if defined(_NOAH_)
+            wf.infil *= elem[i].ps.fcr;
+#endif
+            wf.recharge = Recharge(&elem[i].soil, &ws, &wf);
+
+            dinfil[k] = (wf.infil - elem[i].wf.infil) / inc;
+            drechg[k] = (wf.recharge - elem[i].wf.recharge) / inc;
+        }
+
+        for (k = 0; k < NUM_BLK_VAR; k++)
+        {
+            blk[k][BLK_SURF] = -dinfil[k];
+            blk[k][BLK_UNSAT] = (dinfil[k] - drechg[k]) / elem[i].soil.porosity;
+            blk[k][BLK_GW] = drechg[k] / elem[i].soil.porosity;
+        }
+
+        // Lateral fluxes linearized using secant conductances
+        head_surf = elem[i].topo.zmax + elem[i].ws.surfh;
+        head_gw = elem[i].topo.zmin + elem[i].ws.gw;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].nabr[j] == 0)
+            {
+                if (elem[i].attrib.bc[j] > 0)
+                {
+                    cgw += Secant(elem[i].wf.subsurf[j], head_gw - elem[i].bc.head[j]);
+                }
+            }
+            else
+            {
+                nabr = &elem[elem[i].nabr[j] - 1];
+
+                if (elem[i].nabr_river[j] == 0)
+                {
+                    csurf += Secant(elem[i].wf.overland[j], head_surf - (nabr->topo.zmax + nabr->ws.surfh));
+                    cgw += Secant(elem[i].wf.subsurf[j], head_gw - (nabr->topo.zmin + nabr->ws.gw));
+                }
+                else
+                {
+                    // Subsurface flux on a river edge includes the flux to the element on the other side of the
+                    // river, and the flux to the river segment
+                    river_nabr = &river[elem[i].nabr_river[j] - 1];
+
+                    csurf += Secant(elem[i].wf.overland[j],
+                        head_surf - (river_nabr->topo.zbed + river_nabr->ws.stage));
+                    cgw += Secant(SubsurfFlow(i, j, hydro), head_gw - (nabr->topo.zmin + nabr->ws.gw));
+                    cgw += Secant((river_nabr->left == elem[i].ind) ?
+                        river_nabr->wf.rivflow[AQUIFER_LEFT] : river_nabr->wf.rivflow[AQUIFER_RIGHT],
+                        river_nabr->topo.zbed + river_nabr->ws.stage - head_gw);
+                }
+            }
+        }
+
+        dsurfh = DSurfH(elem[i].ws.surf);
+
+        blk[BLK_SURF][BLK_SURF] -= csurf * dsurfh / elem[i].topo.area;
+        blk[BLK_GW][BLK_GW] -= cgw / elem[i].topo.area / elem[i].soil.porosity;
+    }
+}
+
+void RiverJac(const hydro_struct *hydro, const elem_struct elem[], const river_struct river[], realtype **jac)
+{
+    int             i;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        double          head;
+        double          cdown = 0.0;
+        double          csurf;
+        double          cgw;
+        const elem_struct *bank;
+        const river_struct *down;
+
+        head = river[i].topo.zbed + river[i].ws.stage;
+
+        jac[i][LEFT_SURF] = 0.0;
+        jac[i][LEFT_GW] = 0.0;
+        jac[i][RIGHT_SURF] = 0.0;
+        jac[i][RIGHT_GW] = 0.0;
+
+        if (river[i].down > 0)
+        {
+            down = &river[river[i].down - 1];
+
+            cdown = Secant(river[i].wf.rivflow[DOWNSTREAM], head - (down->topo.zbed + down->ws.stage));
+        }
+        else if (river[i].down == OUTLET_DIRICHLET)
+        {
+            cdown = Secant(river[i].wf.rivflow[DOWNSTREAM], head - river[i].bc.head);
+        }
+
+        jac[i][RIV_STAGE] = -cdown;
+
+        if (river[i].left > 0)
+        {
+            bank = &elem[river[i].left - 1];
+
+            csurf = Secant(river[i].wf.rivflow[SURF_LEFT], head - (bank->topo.zmax + bank->ws.surfh));
+            cgw = Secant(river[i].wf.rivflow[AQUIFER_LEFT], head - (bank->topo.zmin + bank->ws.gw));
+
+            jac[i][RIV_STAGE] -= csurf + cgw;
+            jac[i][LEFT_SURF] = csurf * DSurfH(bank->ws.surf) / river[i].topo.area;
+            jac[i][LEFT_GW] = cgw / river[i].topo.area;
+        }
+
+        if (river[i].right > 0)
+        {
+            bank = &elem[river[i].right - 1];
+
+            csurf = Secant(river[i].wf.rivflow[SURF_RIGHT], head - (bank->topo.zmax + bank->ws.surfh));
+            cgw = Secant(river[i].wf.rivflow[AQUIFER_RIGHT], head - (bank->topo.zmin + bank->ws.gw));
+
+            jac[i][RIV_STAGE] -= csurf + cgw;
+            jac[i][RIGHT_SURF] = csurf * DSurfH(bank->ws.surf) / river[i].topo.area;
+            jac[i][RIGHT_GW] = cgw / river[i].topo.area;
+        }
+    }
+
+    // Add the dependence of inflows from upstream segments on stage. Each segment gathers from its upstream segments so
+    // that no two threads update the same segment
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        int             k;
+
+        for (k = hydro->up_ptr[i]; k < hydro->up_ptr[i + 1]; k++)
+        {
+            const river_struct *up;
+
+            up = &river[hydro->up_ind[k]];
+
+            jac[i][RIV_STAGE] -= Secant(up->wf.rivflow[DOWNSTREAM],
+                (up->topo.zbed + up->ws.stage) - (river[i].topo.zbed + river[i].ws.stage));
+        }
+
+        jac[i][RIV_STAGE] /= river[i].topo.area;
+    }
+}
+
+double Secant(double flux, double diff_h)
+{
+    // Secant conductance of a flux driven by head difference. Negative conductances may occur when fluxes are
+    // limited by minimum gradients, and are not used
+    return (fabs(diff_h) > DHMIN) ? MAX(flux / diff_h, 0.0) : 0.0;
+}
+
+double DSurfH(double surf_eqv)
+{
+    // Derivative of actual surface water depth with respect to equivalent surface water depth (see SurfH)
+    if (DEPRSTG == 0.0 || surf_eqv > 0.5 * DEPRSTG)
+    {
+        return 1.0;
+    }
+    else if (surf_eqv <= 0.0)
+    {
+        return 0.0;
+    }
+    else
+    {
+        return sqrt(0.5 * DEPRSTG / surf_eqv);
+    }
+}
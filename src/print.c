@@ -56,19 +56,25 @@ void StartupScreen(void)
     {
         pihm_printf(VL_NORMAL, "    Append mode turned on.\n");
     }
+    if (1 == resume_mode)
+    {
+        pihm_printf(VL_NORMAL, "    Resume mode turned on.\n");
+    }
 }
 
-void InitOutputFiles(const char outputdir[], int watbal, int ascii, print_struct *print)
+void InitOutputFiles(const char outputdir[], int watbal, int timing, int ascii, int format, int append,
+    print_struct *print)
 {
     char            ascii_fn[MAXSTRING];
     char            dat_fn[MAXSTRING];
     char            watbal_fn[MAXSTRING];
     char            perf_fn[MAXSTRING];
+    char            timing_fn[MAXSTRING];
     int             i;
     char            mode[2];
     char            bin_mode[3];
 
-    if (append_mode)
+    if (append)
     {
         strcpy(mode, "a");
         strcpy(bin_mode, "ab");
@@ -92,15 +98,61 @@ void InitOutputFiles(const char outputdir[], int watbal, int ascii, print_struct
         sprintf(perf_fn, "%s%s.cvode.log", outputdir, project);
         print->cvodeperf_file = pihm_fopen(perf_fn, mode);
         // Print header lines
-        fprintf(print->cvodeperf_file, "%-8s%-8s%-16s%-8s%-8s%-8s%-8s%-8s%-8s\n",
-            "step", "cpu_dt", "cputime", "maxstep", "nsteps", "niters", "nevals", "nefails", "ncfails");
+        fprintf(print->cvodeperf_file, "%-8s%-8s%-16s%-8s%-8s%-8s%-8s%-8s%-8s%-8s\n",
+            "step", "cpu_dt", "cputime", "maxstep", "nsteps", "niters", "nevals", "nliters", "nefails", "ncfails");
+    }
+
+    // Initialize timing output file
+    if (timing)
+    {
+        if (snprintf(timing_fn, sizeof(timing_fn), "%s%s.timing_intvl.csv", outputdir, project) >=
+            (int)sizeof(timing_fn))
+        {
+            pihm_printf(VL_ERROR, "Error: Interval timing file name in %s is too long.\n", outputdir);
+            pihm_exit(EXIT_FAILURE);
+        }
+        print->timing_file = pihm_fopen(timing_fn, mode);
+        InitTimingFile(print->timing_file);
     }
 
     // Initialize model variable output files
     for (i = 0; i < print->nprint; i++)
     {
-        sprintf(dat_fn, "%s.dat", print->varctrl[i].name);
-        print->varctrl[i].datfile = pihm_fopen(dat_fn, bin_mode);
+        if (format == CHUNK_OUTPUT)
+        {
+            if (snprintf(dat_fn, sizeof(dat_fn), "%s.chk", print->varctrl[i].name) >= (int)sizeof(dat_fn))
+            {
+                pihm_printf(VL_ERROR, "Error: Output file name %s.chk is too long.\n", print->varctrl[i].name);
+                pihm_exit(EXIT_FAILURE);
+            }
+            print->varctrl[i].datfile = pihm_fopen(dat_fn, bin_mode);
+
+            if (snprintf(dat_fn, sizeof(dat_fn), "%s.idx", print->varctrl[i].name) >= (int)sizeof(dat_fn))
+            {
+                pihm_printf(VL_ERROR, "Error: Output file name %s.idx is too long.\n", print->varctrl[i].name);
+                pihm_exit(EXIT_FAILURE);
+            }
+            print->varctrl[i].idxfile = pihm_fopen(dat_fn, bin_mode);
+
+            // Headers are only written to new files, so that frames can be appended in append mode
+            fseek(print->varctrl[i].datfile, 0, SEEK_END);
+            if (ftell(print->varctrl[i].datfile) == 0)
+            {
+                WriteChunkHeader(print->varctrl[i].nvar, print->varctrl[i].datfile);
+            }
+
+            fseek(print->varctrl[i].idxfile, 0, SEEK_END);
+            if (ftell(print->varctrl[i].idxfile) == 0)
+            {
+                WriteChunkIndexHeader(print->varctrl[i].idxfile);
+            }
+        }
+        else
+        {
+            sprintf(dat_fn, "%s.dat", print->varctrl[i].name);
+            print->varctrl[i].datfile = pihm_fopen(dat_fn, bin_mode);
+            print->varctrl[i].idxfile = NULL;
+        }
 
         if (ascii)
         {
@@ -108,6 +160,9 @@ void InitOutputFiles(const char outputdir[], int watbal, int ascii, print_struct
             print->varctrl[i].txtfile = pihm_fopen(ascii_fn, mode);
         }
     }
+
+    // Start binary output writer
+    InitWriter(print->nprint, format, print->varctrl, &print->writer);
 }
 
 void UpdatePrintVar(int nprint, int module_step, varctrl_struct *varctrl)
@@ -132,7 +187,7 @@ void UpdatePrintVar(int nprint, int module_step, varctrl_struct *varctrl)
     }
 }
 
-void PrintData(int nprint, int t, int lapse, int ascii, varctrl_struct *varctrl)
+void PrintData(int nprint, int t, int lapse, int ascii, writer_struct *writer, varctrl_struct *varctrl)
 {
     int             i;
     pihm_t_struct   pihm_time;
@@ -146,7 +201,7 @@ void PrintData(int nprint, int t, int lapse, int ascii, varctrl_struct *varctrl)
     {
         int             j;
         double          outval;
-        double          outtime;
+        double         *outrec;
 
         if(PrintNow(varctrl[i].intvl, lapse, pihm_time))
         {
@@ -165,25 +220,29 @@ void PrintData(int nprint, int t, int lapse, int ascii, varctrl_struct *varctrl)
                 fflush(varctrl[i].txtfile);
             }
 
-            outtime = (double)t;
-            fwrite(&outtime, sizeof(double), 1, varctrl[i].datfile);
+            // Pack binary record into the batch, which is written by the writer thread when full
+            outrec = varctrl[i].recbuf + (size_t)varctrl[i].nrec * (varctrl[i].nvar + 1);
+            outrec[0] = (double)t;
             for (j = 0; j < varctrl[i].nvar; j++)
             {
-                outval = (varctrl[i].counter > 0) ?
+                outrec[j + 1] = (varctrl[i].counter > 0) ?
                     varctrl[i].buffer[j] / (double)varctrl[i].counter : varctrl[i].buffer[j];
 
-                fwrite(&outval, sizeof(double), 1, varctrl[i].datfile);
-
                 varctrl[i].buffer[j] = 0.0;
             }
             varctrl[i].counter = 0;
-            fflush(varctrl[i].datfile);
+
+            varctrl[i].nrec++;
+            if (varctrl[i].nrec == varctrl[i].maxrec)
+            {
+                SubmitRecords(writer, &varctrl[i]);
+            }
         }
     }
 }
 
-void PrintInit(const char outputdir[], int t, int starttime, int endtime, int intvl, const elem_struct elem[],
-    const river_struct river[])
+void PrintInit(const char outputdir[], int t, int starttime, int endtime, int intvl, const order_struct *order,
+    const elem_struct elem[], const river_struct river[])
 {
     pihm_t_struct   pihm_time;
 
@@ -193,14 +252,17 @@ void PrintInit(const char outputdir[], int t, int starttime, int endtime, int in
     {
         FILE           *init_file;
         char            fn[MAXSTRING];
-        int             i;
+        int             i, k;
 
         sprintf(fn, "%s/restart/%s.%s.ic", outputdir, project, pihm_time.strshort);
 
         init_file = pihm_fopen(fn, "wb");
 
-        for (i = 0; i < nelem; i++)
+        // Initial conditions are written in the original order of elements and river segments
+        for (k = 0; k < nelem; k++)
         {
+            i = order->elem[k];
+
             fwrite(&elem[i].ws.cmc, sizeof(double), 1, init_file);
             fwrite(&elem[i].ws.sneqv, sizeof(double), 1, init_file);
             fwrite(&elem[i].ws.surf, sizeof(double), 1, init_file);
@@ -231,8 +293,10 @@ void PrintInit(const char outputdir[], int t, int starttime, int endtime, int in
 #endif
         }
 
-        for (i = 0; i < nriver; i++)
+        for (k = 0; k < nriver; k++)
         {
+            i = order->river[k];
+
             fwrite(&river[i].ws.stage, sizeof(double), 1, init_file);
         }
 
@@ -242,11 +306,9 @@ void PrintInit(const char outputdir[], int t, int starttime, int endtime, int in
 }
 
 void PrintPerf(int t, int starttime, double cputime_dt, double cputime, double maxstep, FILE *perf_file,
-    void *cvode_mem)
+    void *cvode_mem, cvstat_struct *stat0)
 {
-    static double   dt;
-    static long int nst0, nfe0, nni0, ncfn0, netf0;
-    long int        nst, nfe, nni, ncfn, netf;
+    long int        nst, nfe, nni, nli, ncfn, netf;
     int             cv_flag;
 
     // Get the cumulative number of internal steps taken by the solver (total so far)
@@ -261,6 +323,10 @@ void PrintPerf(int t, int starttime, double cputime_dt, double cputime, double m
     cv_flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
     CheckCVodeFlag(cv_flag);
 
+    // Get the number of linear iterations performed
+    cv_flag = CVodeGetNumLinIters(cvode_mem, &nli);
+    CheckCVodeFlag(cv_flag);
+
     // Get the number of nonlinear convergence failures that have occurred
     cv_flag = CVodeGetNumNonlinSolvConvFails(cvode_mem, &ncfn);
     CheckCVodeFlag(cv_flag);
@@ -270,27 +336,23 @@ void PrintPerf(int t, int starttime, double cputime_dt, double cputime, double m
     CheckCVodeFlag(cv_flag);
 
     fprintf(perf_file, "%-8d%-8.3f%-16.3f%-8.2f", t - starttime, cputime_dt, cputime, maxstep);
-    fprintf(perf_file, "%-8ld%-8ld%-8ld%-8ld%-8ld\n", nst - nst0, nni - nni0, nfe - nfe0, netf - netf0, ncfn - ncfn0);
+    fprintf(perf_file, "%-8ld%-8ld%-8ld%-8ld%-8ld%-8ld\n", nst - stat0->nst, nni - stat0->nni, nfe - stat0->nfe,
+        nli - stat0->nli, netf - stat0->netf, ncfn - stat0->ncfn);
     fflush(perf_file);
 
-    dt = 0.0;
-
-    nst0 = nst;
-    nni0 = nni;
-    nfe0 = nfe;
-    netf0 = netf;
-    ncfn0 = ncfn;
-
-    dt += cputime_dt;
+    stat0->nst = nst;
+    stat0->nni = nni;
+    stat0->nfe = nfe;
+    stat0->nli = nli;
+    stat0->netf = netf;
+    stat0->ncfn = ncfn;
 }
 
 void PrintWaterBalance(int t, int tstart, int dt, const elem_struct elem[], const river_struct river[],
-    FILE *watbal_file)
+    FILE *watbal_file, ctx_struct *ctx)
 {
     int             i;
     double          tot_src = 0.0, tot_snk = 0.0, tot_strg = 0.0;
-    static double   tot_strg_prev = 0.0;
-    static double   error = 0.0;
 
     if (t == tstart + dt)
     {
@@ -323,16 +385,16 @@ void PrintWaterBalance(int t, int tstart, int dt, const elem_struct elem[], cons
         }
     }
 
-    if (tot_strg_prev != 0.0)
+    if (ctx->tot_strg_prev != 0.0)
     {
-        error += tot_src - tot_snk - (tot_strg - tot_strg_prev);
+        ctx->wb_error += tot_src - tot_snk - (tot_strg - ctx->tot_strg_prev);
 
-        fprintf(watbal_file, "%d %lg %lg %lg %lg %lg\n", t - tstart, tot_src, tot_snk, tot_strg - tot_strg_prev,
-            tot_src - tot_snk - (tot_strg - tot_strg_prev), error);
+        fprintf(watbal_file, "%d %lg %lg %lg %lg %lg\n", t - tstart, tot_src, tot_snk, tot_strg - ctx->tot_strg_prev,
+            tot_src - tot_snk - (tot_strg - ctx->tot_strg_prev), ctx->wb_error);
         fflush(watbal_file);
     }
 
-    tot_strg_prev = tot_strg;
+    ctx->tot_strg_prev = tot_strg;
 }
 
 void PrintCVodeFinalStats(void *cvode_mem)
@@ -343,6 +405,8 @@ void PrintCVodeFinalStats(void *cvode_mem)
     long int        netf;
     long int        nni;
     long int        ncfn;
+    long int        nli;
+    long int        npe;
 
     cv_flag = CVodeGetNumSteps(cvode_mem, &nst);
     CheckCVodeFlag(cv_flag);
@@ -359,11 +423,18 @@ void PrintCVodeFinalStats(void *cvode_mem)
     cv_flag = CVodeGetNumNonlinSolvIters(cvode_mem, &nni);
     CheckCVodeFlag(cv_flag);
 
+    cv_flag = CVodeGetNumLinIters(cvode_mem, &nli);
+    CheckCVodeFlag(cv_flag);
+
+    cv_flag = CVodeGetNumPrecEvals(cvode_mem, &npe);
+    CheckCVodeFlag(cv_flag);
+
     pihm_printf(VL_NORMAL, "\n");
     pihm_printf(VL_NORMAL, "num of steps = %-6ld num of rhs evals = %-6ld\n", nst, nfe);
     pihm_printf(VL_NORMAL, "num of nonlin solv iters = %-6ld "
         "num of nonlin solv conv fails = %-6ld "
         "num of err test fails = %-6ld\n", nni, ncfn, netf);
+    pihm_printf(VL_NORMAL, "num of lin solv iters = %-6ld num of prec evals = %-6ld\n", nli, npe);
 }
 
 int PrintNow(int intvl, int lapse, pihm_t_struct pihm_time)
@@ -25,6 +25,12 @@ void ReadAlloc(pihm_struct pihm)
     sprintf(pihm->filename.soil, "input/%s/%s.soil", proj, proj);
     sprintf(pihm->filename.lc, "input/vegprmt.tbl");
     sprintf(pihm->filename.meteo, "input/%s/%s.meteo", proj, proj);
+    if (snprintf(pihm->filename.meteo_bin, sizeof(pihm->filename.meteo_bin), "input/%s/%s.meteo.bin", proj, proj) >=
+        (int)sizeof(pihm->filename.meteo_bin))
+    {
+        pihm_printf(VL_ERROR, "Error: Binary forcing file name of project %s is too long.\n", proj);
+        pihm_exit(EXIT_FAILURE);
+    }
     sprintf(pihm->filename.lai, "input/%s/%s.lai", proj, proj);
     sprintf(pihm->filename.bc, "input/%s/%s.bc", proj, proj);
     sprintf(pihm->filename.para, "input/%s/%s.para", proj, proj);
@@ -38,6 +44,12 @@ void ReadAlloc(pihm_struct pihm)
     sprintf(pihm->filename.lsm, "input/%s/%s.lsm", proj, proj);
     sprintf(pihm->filename.rad, "input/%s/%s.rad", proj, proj);
     sprintf(pihm->filename.ice, "input/%s/%s.ice", proj, proj);
+    if (snprintf(pihm->filename.horizon, sizeof(pihm->filename.horizon), "input/%s/%s.horizon", proj, proj) >=
+        (int)sizeof(pihm->filename.horizon))
+    {
+        pihm_printf(VL_ERROR, "Error: Horizon file name of project %s is too long.\n", proj);
+        pihm_exit(EXIT_FAILURE);
+    }
 #endif
 #if defined(_CYCLES_)
     sprintf(pihm->filename.cycles, "input/%s/%s.cycles", proj, proj);
@@ -72,8 +84,15 @@ void ReadAlloc(pihm_struct pihm)
     // Read land cover input file
     ReadLc(pihm->filename.lc, &pihm->lctbl);
 
-    // Read meteorological forcing input file
-    ReadMeteo(pihm->filename.meteo, &pihm->forc);
+    // Read meteorological forcing input file. Binary forcing file is used if it is up to date
+    if (UseMeteoBin(pihm->filename.meteo, pihm->filename.meteo_bin))
+    {
+        MapMeteo(pihm->filename.meteo_bin, &pihm->forc);
+    }
+    else
+    {
+        ReadMeteo(pihm->filename.meteo, &pihm->forc);
+    }
 
     // Read LAI input file
     ReadLai(pihm->filename.lai, &pihm->atttbl, &pihm->forc);
@@ -102,6 +121,7 @@ void ReadAlloc(pihm_struct pihm)
     // Read LSM input file
     ReadLsm(pihm->filename.lsm, &pihm->ctrl, &pihm->siteinfo, &pihm->noahtbl);
 
+    pihm->forc.nrad = 0;
     if (pihm->ctrl.rad_mode == TOPO_SOL)
     {
         // Read radiation input file
@@ -63,7 +63,7 @@ void ReadBc(const char fn[], const atttbl_struct *atttbl, forc_struct *forc)
         FindLine(fp, "BOF", &lno, fn);
         if (forc->nbc > 0)
         {
-            forc->bc = (tsdata_struct *)malloc(forc->nbc * sizeof(tsdata_struct));
+            forc->bc = (tsdata_struct *)calloc(forc->nbc, sizeof(tsdata_struct));
 
             NextLine(fp, cmdstr, &lno);
             for (i = 0; i < forc->nbc; i++)
@@ -13,6 +13,9 @@ void ReadMeteo(const char fn[], forc_struct *forc)
     fp = pihm_fopen(fn, "r");
     pihm_printf(VL_VERBOSE, " Reading %s\n", fn);
 
+    forc->meteo_map = NULL;
+    forc->meteo_map_size = 0;
+
     FindLine(fp, "BOF", &lno, fn);
 
     forc->nmeteo = CountOccurr(fp, "METEO_TS");
@@ -20,7 +23,7 @@ void ReadMeteo(const char fn[], forc_struct *forc)
     FindLine(fp, "BOF", &lno, fn);
     if (forc->nmeteo > 0)
     {
-        forc->meteo = (tsdata_struct *)malloc(forc->nmeteo * sizeof(tsdata_struct));
+        forc->meteo = (tsdata_struct *)calloc(forc->nmeteo, sizeof(tsdata_struct));
 
         NextLine(fp, cmdstr, &lno);
         for (i = 0; i < forc->nmeteo; i++)
@@ -50,9 +53,12 @@ void ReadMeteo(const char fn[], forc_struct *forc)
 
             forc->meteo[i].ftime = (int *)malloc(forc->meteo[i].length * sizeof(int));
             forc->meteo[i].data = (double **)malloc(forc->meteo[i].length * sizeof(double *));
+            // Forcing values of each series are stored in one contiguous block
+            forc->meteo[i].data[0] = (double *)malloc(forc->meteo[i].length * NUM_METEO_VAR * sizeof(double));
+            forc->meteo[i].cursor = 0;
             for (j = 0; j < forc->meteo[i].length; j++)
             {
-                forc->meteo[i].data[j] = (double *)malloc(NUM_METEO_VAR * sizeof(double));
+                forc->meteo[i].data[j] = forc->meteo[i].data[0] + j * NUM_METEO_VAR;
                 NextLine(fp, cmdstr, &lno);
                 if (!ReadTs(cmdstr, NUM_METEO_VAR, &forc->meteo[i].ftime[j], &forc->meteo[i].data[j][0]))
                 {
@@ -64,3 +70,163 @@ void ReadMeteo(const char fn[], forc_struct *forc)
 
     fclose(fp);
 }
+
+int UseMeteoBin(const char fn[], const char bin_fn[])
+{
+    struct stat     st, bin_st;
+
+    if (stat(bin_fn, &bin_st) != 0)
+    {
+        return 0;
+    }
+
+    if (stat(fn, &st) == 0 && st.st_mtime > bin_st.st_mtime)
+    {
+        pihm_printf(VL_NORMAL, "Warning: %s is older than %s and will not be used.\n", bin_fn, fn);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Binary meteorological forcing files (.meteo.bin) are written by the meteo-convert utility, and contain:
+//   file header:   magic "PIHMMET1", int32 number of series, int32 number of variables
+//   series table:  double wind level, int64 length, int64 offset of forcing times, int64 offset of forcing values
+//                  for each series
+//   series data:   int forcing times (padded to 8 bytes), and a contiguous length by NUM_METEO_VAR matrix of forcing
+//                  values for each series
+// All values are in native byte order. The file is memory mapped so that no parsing is needed at startup.
+void MapMeteo(const char fn[], forc_struct *forc)
+{
+    FILE           *fp;
+    char           *map;
+    struct stat     st;
+    int32_t         header[2];
+    int             i, j;
+
+    fp = pihm_fopen(fn, "rb");
+    pihm_printf(VL_VERBOSE, " Reading %s\n", fn);
+
+    if (fstat(fileno(fp), &st) != 0 || st.st_size < (off_t)(sizeof(METEO_MAGIC) - 1 + sizeof(header)))
+    {
+        pihm_printf(VL_ERROR, "Error reading %s.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    map = (char *)malloc(st.st_size);
+    if (fread(map, 1, st.st_size, fp) != (size_t)st.st_size)
+    {
+        pihm_printf(VL_ERROR, "Error reading %s.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+#else
+    // Forcing values are modified in place by climate scenarios thus a private writable mapping is used
+    map = (char *)mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(fp), 0);
+    if (map == MAP_FAILED)
+    {
+        pihm_printf(VL_ERROR, "Error mapping %s: %s.\n", fn, strerror(errno));
+        pihm_exit(EXIT_FAILURE);
+    }
+#endif
+    fclose(fp);
+
+    forc->meteo_map = map;
+    forc->meteo_map_size = (size_t)st.st_size;
+
+    memcpy(header, map + sizeof(METEO_MAGIC) - 1, sizeof(header));
+    if (memcmp(map, METEO_MAGIC, sizeof(METEO_MAGIC) - 1) != 0 || header[1] != NUM_METEO_VAR ||
+        header[0] < 0 || (size_t)st.st_size < METEO_HEADER_SIZE + (size_t)header[0] * METEO_SERIES_SIZE)
+    {
+        pihm_printf(VL_ERROR, "Error: %s is not a valid binary forcing file.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    forc->nmeteo = header[0];
+    if (forc->nmeteo > 0)
+    {
+        forc->meteo = (tsdata_struct *)calloc(forc->nmeteo, sizeof(tsdata_struct));
+
+        for (i = 0; i < forc->nmeteo; i++)
+        {
+            const char     *entry = map + METEO_HEADER_SIZE + (size_t)i * METEO_SERIES_SIZE;
+            int64_t         length;
+            int64_t         offset[2];
+
+            memcpy(&forc->meteo[i].zlvl_wind, entry, sizeof(double));
+            memcpy(&length, entry + sizeof(double), sizeof(int64_t));
+            memcpy(offset, entry + sizeof(double) + sizeof(int64_t), 2 * sizeof(int64_t));
+
+            if (length <= 0 || length > INT_MAX || offset[0] < 0 || offset[1] < 0 ||
+                (size_t)offset[0] + (size_t)length * sizeof(int) > (size_t)st.st_size ||
+                (size_t)offset[1] + (size_t)length * NUM_METEO_VAR * sizeof(double) > (size_t)st.st_size ||
+                offset[0] % sizeof(int) != 0 || offset[1] % sizeof(double) != 0)
+            {
+                pihm_printf(VL_ERROR, "Error: %s is not a valid binary forcing file.\n", fn);
+                pihm_exit(EXIT_FAILURE);
+            }
+
+            forc->meteo[i].length = (int)length;
+            forc->meteo[i].cursor = 0;
+            forc->meteo[i].ftime = (int *)(map + offset[0]);
+            forc->meteo[i].data = (double **)malloc(forc->meteo[i].length * sizeof(double *));
+            for (j = 0; j < forc->meteo[i].length; j++)
+            {
+                forc->meteo[i].data[j] = (double *)(map + offset[1]) + (size_t)j * NUM_METEO_VAR;
+            }
+        }
+    }
+}
+
+void WriteMeteoBin(const char fn[], const forc_struct *forc)
+{
+    FILE           *fp;
+    int32_t         header[2];
+    int64_t         offset;
+    const char      pad[sizeof(double)] = { 0 };
+    int             i;
+
+    fp = pihm_fopen(fn, "wb");
+
+    header[0] = forc->nmeteo;
+    header[1] = NUM_METEO_VAR;
+    fwrite(METEO_MAGIC, 1, sizeof(METEO_MAGIC) - 1, fp);
+    fwrite(header, sizeof(int32_t), 2, fp);
+
+    // Series table
+    offset = METEO_HEADER_SIZE + (int64_t)forc->nmeteo * METEO_SERIES_SIZE;
+    for (i = 0; i < forc->nmeteo; i++)
+    {
+        int64_t         entry[3];
+
+        entry[0] = forc->meteo[i].length;
+        entry[1] = offset;
+        offset += ((int64_t)forc->meteo[i].length * sizeof(int) + sizeof(double) - 1) / sizeof(double) *
+            sizeof(double);
+        entry[2] = offset;
+        offset += (int64_t)forc->meteo[i].length * NUM_METEO_VAR * sizeof(double);
+
+        fwrite(&forc->meteo[i].zlvl_wind, sizeof(double), 1, fp);
+        fwrite(entry, sizeof(int64_t), 3, fp);
+    }
+
+    // Series data
+    for (i = 0; i < forc->nmeteo; i++)
+    {
+        size_t          nbytes = (size_t)forc->meteo[i].length * sizeof(int);
+        int             j;
+
+        fwrite(forc->meteo[i].ftime, sizeof(int), forc->meteo[i].length, fp);
+        fwrite(pad, 1, (sizeof(double) - nbytes % sizeof(double)) % sizeof(double), fp);
+        for (j = 0; j < forc->meteo[i].length; j++)
+        {
+            fwrite(forc->meteo[i].data[j], sizeof(double), NUM_METEO_VAR, fp);
+        }
+    }
+
+    if (ferror(fp) || fclose(fp) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error writing %s.\n", fn);
+        pihm_exit(EXIT_FAILURE);
+    }
+}
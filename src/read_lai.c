@@ -33,7 +33,7 @@ void ReadLai(const char fn[], const atttbl_struct *atttbl, forc_struct *forc)
         FindLine(fp, "BOF", &lno, fn);
         if (forc->nlai > 0)
         {
-            forc->lai = (tsdata_struct *)malloc(forc->nlai * sizeof(tsdata_struct));
+            forc->lai = (tsdata_struct *)calloc(forc->nlai, sizeof(tsdata_struct));
 
             NextLine(fp, cmdstr, &lno);
             for (i = 0; i < forc->nlai; i++)
@@ -97,6 +97,45 @@ void ReadPara(const char fn[], ctrl_struct *ctrl)
     NextLine(fp, cmdstr, &lno);
     ReadKeyword(cmdstr, "MIN_MAXSTEP", 'd', fn, lno, &ctrl->stmin);
 
+    // Keywords of preconditioner, renumbering, soil tables, and output format are optional
+    ctrl->precond = NO_PRECOND;
+    if (NextOptLine(fp, "PRECONDITIONER", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "PRECONDITIONER", 'i', fn, lno, &ctrl->precond);
+    }
+    ctrl->precond = (ctrl->precond > NO_PRECOND) ? BLOCK_PRECOND : NO_PRECOND;
+
+    ctrl->renumber = NO_RENUMBER;
+    if (NextOptLine(fp, "RENUMBER", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "RENUMBER", 'i', fn, lno, &ctrl->renumber);
+    }
+    ctrl->renumber = (ctrl->renumber > NO_RENUMBER) ? RCM_RENUMBER : NO_RENUMBER;
+
+    ctrl->soil_table = 0;
+    if (NextOptLine(fp, "SOIL_TABLE", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "SOIL_TABLE", 'i', fn, lno, &ctrl->soil_table);
+    }
+    if (ctrl->soil_table < 0)
+    {
+        pihm_printf(VL_ERROR, "Error: Number of soil table intervals should be non-negative.\n");
+        pihm_printf(VL_ERROR, "Error in %s near Line %d.\n", fn, lno);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    ctrl->out_format = DAT_OUTPUT;
+    if (NextOptLine(fp, "OUTPUT_FORMAT", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "OUTPUT_FORMAT", 'i', fn, lno, &ctrl->out_format);
+    }
+    if (ctrl->out_format != DAT_OUTPUT && ctrl->out_format != CHUNK_OUTPUT)
+    {
+        pihm_printf(VL_ERROR, "Error: Output format %d is not defined.\n", ctrl->out_format);
+        pihm_printf(VL_ERROR, "Error in %s near Line %d.\n", fn, lno);
+        pihm_exit(EXIT_FAILURE);
+    }
+
     NextLine(fp, cmdstr, &lno);
     ctrl->prtvrbl[SURF_CTRL] = ReadPrintCtrl(cmdstr, "SURF", fn, lno);
 
@@ -157,6 +196,19 @@ void ReadPara(const char fn[], ctrl_struct *ctrl)
     NextLine(fp, cmdstr, &lno);
     ctrl->prtvrbl[IC_CTRL] = ReadPrintCtrl(cmdstr, "IC", fn, lno);
 
+    // Checkpoint and timing intervals are optional, and are turned off by default
+    ctrl->checkpoint = 0;
+    if (NextOptLine(fp, "CHECKPOINT", cmdstr, &lno))
+    {
+        ctrl->checkpoint = ReadPrintCtrl(cmdstr, "CHECKPOINT", fn, lno);
+    }
+
+    ctrl->timing = 0;
+    if (NextOptLine(fp, "TIMING", cmdstr, &lno))
+    {
+        ctrl->timing = ReadPrintCtrl(cmdstr, "TIMING", fn, lno);
+    }
+
     fclose(fp);
 
 #if defined(_CYCLES_)
@@ -109,7 +109,7 @@ void ReadRiver(const char fn[], rivtbl_struct *rivtbl, shptbl_struct *shptbl, ma
 
     if (forc->nriverbc > 0)
     {
-        forc->riverbc = (tsdata_struct *)malloc(forc->nriverbc * sizeof(tsdata_struct));
+        forc->riverbc = (tsdata_struct *)calloc(forc->nriverbc, sizeof(tsdata_struct));
 
         NextLine(fp, cmdstr, &lno);
         for (i = 0; i < forc->nriverbc; i++)
@@ -0,0 +1,372 @@
+#include "pihm.h"
+
+// Renumber elements and river segments for memory locality. Element indices from mesh generators are often in no
+// particular spatial order, so that neighbor accesses in lateral flux kernels jump through element arrays. When
+// renumbering is turned on, elements are ordered using the reverse Cuthill-McKee (RCM) algorithm on the element
+// adjacency graph, and river segments are ordered following their bank elements. Element and river arrays and CVODE
+// state variables are permuted after initialization, i.e., after all input and initial condition files have been read
+// in the original order. Output and restart files are written in the original order using the order structure.
+void Renumber(int renumber, order_struct *order, elem_struct elem[], river_struct river[], N_Vector CV_Y)
+{
+    int            *elem_perm;
+    int            *river_perm;
+    int             bandwidth;
+    int             i;
+
+    order->elem = (int *)malloc(nelem * sizeof(int));
+    order->river = (int *)malloc(nriver * sizeof(int));
+
+    if (renumber == NO_RENUMBER)
+    {
+        for (i = 0; i < nelem; i++)
+        {
+            order->elem[i] = i;
+        }
+        for (i = 0; i < nriver; i++)
+        {
+            order->river[i] = i;
+        }
+
+        return;
+    }
+
+    pihm_printf(VL_VERBOSE, " Renumber elements and river segments using reverse Cuthill-McKee ordering.\n");
+
+    // Permutations store the original index of each renumbered element and river segment, and the order structure
+    // stores the inverse permutations
+    elem_perm = (int *)malloc(nelem * sizeof(int));
+    river_perm = (int *)malloc(nriver * sizeof(int));
+
+    RcmOrder(elem, elem_perm);
+    for (i = 0; i < nelem; i++)
+    {
+        order->elem[elem_perm[i]] = i;
+    }
+
+    RiverOrder(order->elem, river, river_perm);
+    for (i = 0; i < nriver; i++)
+    {
+        order->river[river_perm[i]] = i;
+    }
+
+    bandwidth = Bandwidth(elem);
+
+    PermuteStateVar(elem_perm, river_perm, CV_Y);
+    PermuteDomain(elem_perm, river_perm, order, elem, river);
+
+    pihm_printf(VL_VERBOSE, " Element bandwidth reduced from %d to %d.\n", bandwidth, Bandwidth(elem));
+
+    free(elem_perm);
+    free(river_perm);
+}
+
+// Reverse Cuthill-McKee ordering of the element adjacency graph. Each connected component is traversed breadth first
+// starting from a pseudo-peripheral element, visiting neighbors in ascending order of degree
+void RcmOrder(const elem_struct elem[], int perm[])
+{
+    int            *degree;
+    int            *mark;
+    int             head, tail = 0;
+    int             start;
+    int             comp = 0;
+    int             i, j, k;
+
+    degree = (int *)calloc(nelem, sizeof(int));
+    mark = (int *)calloc(nelem, sizeof(int));
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            degree[i] += (elem[i].nabr[j] > 0) ? 1 : 0;
+        }
+    }
+
+    while (tail < nelem)
+    {
+        comp++;
+
+        // Start from the unvisited element with the minimum degree
+        start = -1;
+        for (i = 0; i < nelem; i++)
+        {
+            if (mark[i] == 0 && (start < 0 || degree[i] < degree[start]))
+            {
+                start = i;
+            }
+        }
+
+        // The element visited last in a breadth first search is in the farthest level, and is used as the
+        // pseudo-peripheral starting element. The search uses the unused part of the permutation as the queue
+        head = tail;
+        perm[tail] = start;
+        mark[start] = -comp;
+        for (k = tail; k <= head; k++)
+        {
+            for (j = 0; j < NUM_EDGE; j++)
+            {
+                int             nabr = elem[perm[k]].nabr[j] - 1;
+
+                if (nabr >= 0 && mark[nabr] == 0)
+                {
+                    mark[nabr] = -comp;
+                    perm[++head] = nabr;
+                }
+            }
+        }
+        start = perm[head];
+
+        // Cuthill-McKee ordering of the component
+        for (k = tail; k <= head; k++)
+        {
+            mark[perm[k]] = 0;
+        }
+
+        head = tail;
+        perm[tail++] = start;
+        mark[start] = comp;
+        while (head < tail)
+        {
+            int             nabr[NUM_EDGE];
+            int             nnabr = 0;
+
+            for (j = 0; j < NUM_EDGE; j++)
+            {
+                int             ind = elem[perm[head]].nabr[j] - 1;
+
+                if (ind >= 0 && mark[ind] == 0)
+                {
+                    // Insertion sort by degree
+                    for (k = nnabr; k > 0 && degree[nabr[k - 1]] > degree[ind]; k--)
+                    {
+                        nabr[k] = nabr[k - 1];
+                    }
+                    nabr[k] = ind;
+                    nnabr++;
+                    mark[ind] = comp;
+                }
+            }
+
+            for (k = 0; k < nnabr; k++)
+            {
+                perm[tail++] = nabr[k];
+            }
+
+            head++;
+        }
+    }
+
+    // Reverse
+    for (i = 0; i < nelem / 2; i++)
+    {
+        k = perm[i];
+        perm[i] = perm[nelem - 1 - i];
+        perm[nelem - 1 - i] = k;
+    }
+
+    free(degree);
+    free(mark);
+}
+
+// Order river segments by the new indices of their bank elements, so that river-bank exchanges access nearby elements
+void RiverOrder(const int elem_ind[], const river_struct river[], int perm[])
+{
+    int           (*key)[2];
+    int             i;
+
+    key = (int (*)[2])malloc(nriver * sizeof(int [2]));
+
+    for (i = 0; i < nriver; i++)
+    {
+        key[i][0] = (river[i].left > 0) ? elem_ind[river[i].left - 1] :
+            ((river[i].right > 0) ? elem_ind[river[i].right - 1] : nelem);
+        key[i][1] = i;
+    }
+
+    qsort(key, nriver, sizeof(int [2]), CompareIndexPair);
+
+    for (i = 0; i < nriver; i++)
+    {
+        perm[i] = key[i][1];
+    }
+
+    free(key);
+}
+
+int CompareIndexPair(const void *a, const void *b)
+{
+    const int      *pair1 = (const int *)a;
+    const int      *pair2 = (const int *)b;
+
+    return (pair1[0] != pair2[0]) ? pair1[0] - pair2[0] : pair1[1] - pair2[1];
+}
+
+// Permute element and river segment arrays, and update element and river segment indices stored in the structures
+void PermuteDomain(const int elem_perm[], const int river_perm[], const order_struct *order, elem_struct elem[],
+    river_struct river[])
+{
+    elem_struct    *elem_copy;
+    river_struct   *river_copy;
+    int             i;
+
+    elem_copy = (elem_struct *)malloc(nelem * sizeof(elem_struct));
+    river_copy = (river_struct *)malloc(nriver * sizeof(river_struct));
+
+    memcpy(elem_copy, elem, nelem * sizeof(elem_struct));
+    memcpy(river_copy, river, nriver * sizeof(river_struct));
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        int             j;
+
+        elem[i] = elem_copy[elem_perm[i]];
+        elem[i].ind = i + 1;
+
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            elem[i].nabr[j] = (elem[i].nabr[j] > 0) ? order->elem[elem[i].nabr[j] - 1] + 1 : elem[i].nabr[j];
+            elem[i].nabr_river[j] = (elem[i].nabr_river[j] > 0) ?
+                order->river[elem[i].nabr_river[j] - 1] + 1 : elem[i].nabr_river[j];
+        }
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        river[i] = river_copy[river_perm[i]];
+        river[i].ind = i + 1;
+
+        river[i].left = (river[i].left > 0) ? order->elem[river[i].left - 1] + 1 : river[i].left;
+        river[i].right = (river[i].right > 0) ? order->elem[river[i].right - 1] + 1 : river[i].right;
+        // Negative downstream indices indicate outlet boundary condition types
+        river[i].down = (river[i].down > 0) ? order->river[river[i].down - 1] + 1 : river[i].down;
+    }
+
+    free(elem_copy);
+    free(river_copy);
+}
+
+void PermuteStateVar(const int elem_perm[], const int river_perm[], N_Vector CV_Y)
+{
+    double         *y_copy;
+    int             i;
+
+    y_copy = (double *)malloc(NumStateVar() * sizeof(double));
+    memcpy(y_copy, NV_DATA(CV_Y), NumStateVar() * sizeof(double));
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nelem; i++)
+    {
+        NV_Ith(CV_Y, SURF(i)) = y_copy[SURF(elem_perm[i])];
+        NV_Ith(CV_Y, UNSAT(i)) = y_copy[UNSAT(elem_perm[i])];
+        NV_Ith(CV_Y, GW(i)) = y_copy[GW(elem_perm[i])];
+#if defined(_DGW_)
+        NV_Ith(CV_Y, UNSAT_GEOL(i)) = y_copy[UNSAT_GEOL(elem_perm[i])];
+        NV_Ith(CV_Y, GW_GEOL(i)) = y_copy[GW_GEOL(elem_perm[i])];
+#endif
+
+#if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
+        int             k;
+
+        for (k = 0; k < nsolute; k++)
+        {
+            NV_Ith(CV_Y, SOLUTE_SOIL(i, k)) = y_copy[SOLUTE_SOIL(elem_perm[i], k)];
+# if defined(_DGW_)
+            NV_Ith(CV_Y, SOLUTE_GEOL(i, k)) = y_copy[SOLUTE_GEOL(elem_perm[i], k)];
+# endif
+        }
+#endif
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (i = 0; i < nriver; i++)
+    {
+        NV_Ith(CV_Y, RIVER(i)) = y_copy[RIVER(river_perm[i])];
+
+#if defined(_BGC_) || defined(_CYCLES_) || defined(_RT_)
+        int             k;
+
+        for (k = 0; k < nsolute; k++)
+        {
+            NV_Ith(CV_Y, SOLUTE_RIVER(i, k)) = y_copy[SOLUTE_RIVER(river_perm[i], k)];
+        }
+#endif
+    }
+
+    free(y_copy);
+}
+
+// Maximum index distance between neighboring elements
+int Bandwidth(const elem_struct elem[])
+{
+    int             bandwidth = 0;
+    int             i, j;
+
+    for (i = 0; i < nelem; i++)
+    {
+        for (j = 0; j < NUM_EDGE; j++)
+        {
+            if (elem[i].nabr[j] > 0)
+            {
+                bandwidth = MAX(bandwidth, abs(elem[i].nabr[j] - 1 - i));
+            }
+        }
+    }
+
+    return bandwidth;
+}
+
+// Map output variables to the original order of elements and river segments. Output variables of elements and river
+// segments are identified by the addresses they point to
+void RenumberOutput(const order_struct *order, const elem_struct elem[], const river_struct river[],
+    print_struct *print)
+{
+    const double  **var;
+    int             i, k;
+
+    var = (const double **)malloc(MAX(nelem, nriver) * sizeof(double *));
+
+    for (i = 0; i < print->nprint; i++)
+    {
+        const char     *ptr = (const char *)print->varctrl[i].var[0];
+
+        if (print->varctrl[i].nvar == nelem && ptr >= (const char *)elem && ptr < (const char *)(elem + nelem))
+        {
+            for (k = 0; k < nelem; k++)
+            {
+                var[k] = print->varctrl[i].var[order->elem[k]];
+            }
+        }
+        else if (print->varctrl[i].nvar == nriver && ptr >= (const char *)river &&
+            ptr < (const char *)(river + nriver))
+        {
+            for (k = 0; k < nriver; k++)
+            {
+                var[k] = print->varctrl[i].var[order->river[k]];
+            }
+        }
+        else
+        {
+            continue;
+        }
+
+        memcpy(print->varctrl[i].var, var, print->varctrl[i].nvar * sizeof(double *));
+    }
+
+    free(var);
+}
+
+void FreeOrder(order_struct *order)
+{
+    free(order->elem);
+    free(order->river);
+}
@@ -1,17 +1,21 @@
 #include "pihm.h"
 
-void RiverFlow(elem_struct elem[], river_struct river[])
+void RiverFlow(hydro_struct *hydro, elem_struct elem[], river_struct river[])
 {
     int             i;
 
+#if defined(_VEC_)
+    RiverFlowVec(hydro);
+#endif
+
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
     for (i = 0; i < nriver; i++)
     {
+#if !defined(_VEC_)
         river_struct   *down;
-        elem_struct    *left;
-        elem_struct    *right;
+#endif
 
         InitRiverWFlux(&river[i].wf);
 
@@ -26,9 +30,13 @@ void RiverFlow(elem_struct elem[], river_struct river[])
             }
 
             // Channel flow between river-river segments
+#if defined(_VEC_)
+            river[i].wf.rivflow[DOWNSTREAM] = hydro->river_flux[i];
+#else
             down = &river[river[i].down - 1];
 
             river[i].wf.rivflow[DOWNSTREAM] = ChannelFlowRiverToRiver(&river[i], down);
+#endif
         }
         else
         {
@@ -38,63 +46,81 @@ void RiverFlow(elem_struct elem[], river_struct river[])
         }
 
         // Flux between river segments and triangular elements
-        left = &elem[river[i].left - 1];
-        right = &elem[river[i].right - 1];
-
-        RiverToElem(&river[i], left, right);
+        RiverToElem(i, hydro, elem, &river[i]);
     }
 
-    // Accumulate to get in-flow for down segments
-    // NOTE: Upstream flux summation must be calculated outside OMP to avoid different threads accessing the same
-    // variable at the same time
+    // Accumulate to get in-flow for down segments. Each segment gathers out-flows from its upstream segments so that
+    // no two threads update the same segment
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nriver; i++)
     {
-        river_struct   *down;
+        int             k;
 
-        if (river[i].down > 0)
+        for (k = hydro->up_ptr[i]; k < hydro->up_ptr[i + 1]; k++)
         {
-            down = &river[river[i].down - 1];
-
-            down->wf.rivflow[UPSTREAM] -= river[i].wf.rivflow[DOWNSTREAM];
+            river[i].wf.rivflow[UPSTREAM] -= river[hydro->up_ind[k]].wf.rivflow[DOWNSTREAM];
         }
     }
 }
 
-void RiverToElem(river_struct *river_ptr, elem_struct *left, elem_struct *right)
+void RiverToElem(int i, const hydro_struct *hydro, elem_struct elem[], river_struct *river_ptr)
 {
+    int             bank;
+    int             j;
+
     if (river_ptr->left > 0)
     {
-        double          effk_left;
+        bank = river_ptr->left - 1;
+        j = hydro->bank_edge[2 * i];
 
-        river_ptr->wf.rivflow[SURF_LEFT] = OvlFlowElemToRiver(river_ptr, left);
+#if defined(_VEC_)
+        river_ptr->wf.rivflow[SURF_LEFT] = hydro->bank_flux[2 * i];
+#else
+        river_ptr->wf.rivflow[SURF_LEFT] = OvlFlowElemToRiver(bank, hydro, river_ptr);
+#endif
+        river_ptr->wf.rivflow[AQUIFER_LEFT] = ChannelFlowElemToRiver(bank, river_ptr->topo.dist_left, hydro,
+            river_ptr);
 
-        effk_left = EffKh(left->ws.gw, &left->soil);
-        river_ptr->wf.rivflow[AQUIFER_LEFT] = ChannelFlowElemToRiver(effk_left, river_ptr->topo.dist_left, river_ptr, left);
+        if (j >= 0)
+        {
+            elem[bank].wf.overland[j] = -river_ptr->wf.rivflow[SURF_LEFT];
+            elem[bank].wf.subsurf[j] -= river_ptr->wf.rivflow[AQUIFER_LEFT];
+        }
     }
 
     if (river_ptr->right > 0)
     {
-        double          effk_right;
+        bank = river_ptr->right - 1;
+        j = hydro->bank_edge[2 * i + 1];
 
-        river_ptr->wf.rivflow[SURF_RIGHT] = OvlFlowElemToRiver(river_ptr, right);
+#if defined(_VEC_)
+        river_ptr->wf.rivflow[SURF_RIGHT] = hydro->bank_flux[2 * i + 1];
+#else
+        river_ptr->wf.rivflow[SURF_RIGHT] = OvlFlowElemToRiver(bank, hydro, river_ptr);
+#endif
+        river_ptr->wf.rivflow[AQUIFER_RIGHT] = ChannelFlowElemToRiver(bank, river_ptr->topo.dist_right, hydro,
+            river_ptr);
 
-        effk_right = EffKh(right->ws.gw, &right->soil);
-        river_ptr->wf.rivflow[AQUIFER_RIGHT] =
-            ChannelFlowElemToRiver(effk_right, river_ptr->topo.dist_right, river_ptr, right);
+        if (j >= 0)
+        {
+            elem[bank].wf.overland[j] = -river_ptr->wf.rivflow[SURF_RIGHT];
+            elem[bank].wf.subsurf[j] -= river_ptr->wf.rivflow[AQUIFER_RIGHT];
+        }
     }
 }
 
-double OvlFlowElemToRiver(const river_struct *river_ptr, elem_struct *bank)
+double OvlFlowElemToRiver(int bank, const hydro_struct *hydro, const river_struct *river_ptr)
 {
-    int             j;
     double          z_bank;
     double          flux;
     double          bank_h;
     double          river_h;
 
-    z_bank = (river_ptr->topo.zmax > bank->topo.zmax) ? river_ptr->topo.zmax : bank->topo.zmax;
+    z_bank = (river_ptr->topo.zmax > hydro->zmax[bank]) ? river_ptr->topo.zmax : hydro->zmax[bank];
 
-    bank_h = bank->topo.zmax + bank->ws.surfh;
+    bank_h = hydro->zmax[bank] + hydro->surfh[bank];
     river_h = river_ptr->topo.zbed + river_ptr->ws.stage;
 
     // Panday and Hyakorn 2004 AWR Eqs. (23) and (24)
@@ -113,7 +139,7 @@ double OvlFlowElemToRiver(const river_struct *river_ptr, elem_struct *bank)
                 river_ptr->shp.length * sqrt(river_h - z_bank) * (river_h - z_bank) / 3.0 : 0.0;
         }
     }
-    else if (bank->ws.surfh > DEPRSTG)
+    else if (hydro->surfh[bank] > DEPRSTG)
     {
         if (river_h > z_bank)
         {
@@ -133,15 +159,6 @@ double OvlFlowElemToRiver(const river_struct *river_ptr, elem_struct *bank)
         flux = 0.0;
     }
 
-    for (j = 0; j < NUM_EDGE; j++)
-    {
-        if (bank->nabr_river[j] == river_ptr->ind)
-        {
-            bank->wf.overland[j] = -flux;
-            break;
-        }
-    }
-
     return flux;
 }
 
@@ -269,25 +286,23 @@ double BoundFluxRiver(int riverbc_type, const river_topo_struct *topo, const shp
     return flux;
 }
 
-double ChannelFlowElemToRiver(double effk, double distance, const river_struct *river_ptr, elem_struct *bank)
+double ChannelFlowElemToRiver(int bank, double distance, const hydro_struct *hydro, const river_struct *river_ptr)
 {
-    int             j;
     double          diff_h;
     double          avg_h;
     double          grad_h;
     double          avg_ksat;
-    double          flux;
 
-    diff_h = (river_ptr->ws.stage + river_ptr->topo.zbed) - (bank->ws.gw + bank->topo.zmin);
+    diff_h = (river_ptr->ws.stage + river_ptr->topo.zbed) - (hydro->gw[bank] + hydro->zmin[bank]);
 
     // This is head in neighboring cell representation
-    if (bank->topo.zmin > river_ptr->topo.zbed)
+    if (hydro->zmin[bank] > river_ptr->topo.zbed)
     {
-        avg_h = bank->ws.gw;
+        avg_h = hydro->gw[bank];
     }
-    else if (bank->topo.zmin + bank->ws.gw > river_ptr->topo.zbed)
+    else if (hydro->zmin[bank] + hydro->gw[bank] > river_ptr->topo.zbed)
     {
-        avg_h = bank->topo.zmin + bank->ws.gw - river_ptr->topo.zbed;
+        avg_h = hydro->zmin[bank] + hydro->gw[bank] - river_ptr->topo.zbed;
     }
     else
     {
@@ -297,20 +312,9 @@ double ChannelFlowElemToRiver(double effk, double distance, const river_struct *
 
     grad_h = diff_h / distance;
 
-    avg_ksat = 0.5 * (effk + river_ptr->matl.ksath);
-
-    flux = river_ptr->shp.length * avg_ksat * grad_h * avg_h;
+    avg_ksat = 0.5 * (hydro->effk[bank] + river_ptr->matl.ksath);
 
-    for (j = 0; j < NUM_EDGE; j++)
-    {
-        if (bank->nabr_river[j] == river_ptr->ind)
-        {
-            bank->wf.subsurf[j] -= flux;
-            break;
-        }
-    }
-
-    return flux;
+    return river_ptr->shp.length * avg_ksat * grad_h * avg_h;
 }
 
 double RiverCrossSectArea(int order, double depth, double coeff)
@@ -45,8 +45,8 @@ void InitChem(const char fn[], const calib_struct *calib, forc_struct *forc, che
     }
 }
 
-void InitRTVar(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, elem_struct elem[], river_struct river[],
-    N_Vector CV_Y)
+void InitRTVar(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, rtwork_struct *rtwork, elem_struct elem[],
+    river_struct river[], N_Vector CV_Y)
 {
     int             i;
 
@@ -59,13 +59,14 @@ void InitRTVar(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, elem_s
 
         storage = (elem[i].ws.unsat + elem[i].ws.gw) * elem[i].soil.porosity + elem[i].soil.depth * elem[i].soil.smcmin;
 
-        InitChemS(chemtbl, rttbl, &elem[i].restart_input[SOIL_CHMVOL], elem[i].soil.smcmax, storage, &elem[i].chms);
+        InitChemS(chemtbl, rttbl, &elem[i].restart_input[SOIL_CHMVOL], elem[i].soil.smcmax, storage, rtwork,
+            &elem[i].chms);
 
 #if defined(_DGW_)
         storage = (elem[i].ws.unsat_geol + elem[i].ws.gw_geol) * elem[i].geol.porosity +
             elem[i].geol.depth * elem[i].geol.smcmin;
 
-        InitChemS(chemtbl, rttbl, &elem[i].restart_input[GEOL_CHMVOL], elem[i].geol.smcmax, storage,
+        InitChemS(chemtbl, rttbl, &elem[i].restart_input[GEOL_CHMVOL], elem[i].geol.smcmax, storage, rtwork,
             &elem[i].chms_geol);
 #endif
     }
@@ -139,7 +140,7 @@ void InitRTVar(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, elem_s
 }
 
 void InitChemS(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, const rtic_struct *restart_input,
-    double smcmax, double vol, chmstate_struct *chms)
+    double smcmax, double vol, rtwork_struct *rtwork, chmstate_struct *chms)
 {
     int             k;
 
@@ -190,7 +191,7 @@ void InitChemS(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, const
     // Speciation
     if (rttbl->transpt_flag == KIN_REACTION)
     {
-        Speciation(chemtbl, rttbl, 1, chms);
+        Speciation(chemtbl, rttbl, 1, rtwork, chms);
     }
 
     // Total moles should be calculated after speciation
@@ -2,9 +2,68 @@
 
 #define TOL                     1E-7
 #define SKIP_JACOB              1
+#define LN10                    2.302585092994046
+
+rtwork_struct *InitRTWork(const rttbl_struct *rttbl)
+{
+    int             tid;
+    int             nwork;
+    rtwork_struct  *rtwork;
+
+#if defined(_OPENMP)
+    nwork = nthreads;
+#else
+    nwork = 1;
+#endif
+
+    // Newton solver workspaces are allocated once for each thread, so that reaction and speciation solvers called
+    // inside OpenMP loops do not allocate memory
+    rtwork = (rtwork_struct *)malloc(nwork * sizeof(rtwork_struct));
+    if (rtwork == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for reaction solver workspace.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    for (tid = 0; tid < nwork; tid++)
+    {
+        rtwork[tid].jcb = newDenseMat(rttbl->num_stc, rttbl->num_stc);
+        rtwork[tid].pivot = newIndexArray(rttbl->num_stc);
+        rtwork[tid].x = newRealArray(rttbl->num_stc);
+
+        if (rtwork[tid].jcb == NULL || rtwork[tid].pivot == NULL || rtwork[tid].x == NULL)
+        {
+            pihm_printf(VL_ERROR, "Error allocating memory for reaction solver workspace.\n");
+            pihm_exit(EXIT_FAILURE);
+        }
+    }
+
+    return rtwork;
+}
+
+void FreeRTWork(rtwork_struct rtwork[])
+{
+    int             tid;
+    int             nwork;
+
+#if defined(_OPENMP)
+    nwork = nthreads;
+#else
+    nwork = 1;
+#endif
+
+    for (tid = 0; tid < nwork; tid++)
+    {
+        destroyMat(rtwork[tid].jcb);
+        destroyArray(rtwork[tid].pivot);
+        destroyArray(rtwork[tid].x);
+    }
+
+    free(rtwork);
+}
 
 void Reaction(double stepsize, const chemtbl_struct chemtbl[], const kintbl_struct kintbl[], const rttbl_struct *rttbl,
-    elem_struct elem[])
+    rtwork_struct rtwork[], elem_struct elem[])
 {
     int             i;
 
@@ -17,6 +76,11 @@ void Reaction(double stepsize, const chemtbl_struct chemtbl[], const kintbl_stru
         double          satn;
         double          ftemp;
         int             k;
+#if defined(_OPENMP)
+        rtwork_struct  *work = &rtwork[omp_get_thread_num()];
+#else
+        rtwork_struct  *work = &rtwork[0];
+#endif
 
         storage = (elem[i].ws.unsat + elem[i].ws.gw) * elem[i].soil.porosity + elem[i].soil.depth * elem[i].soil.smcmin;
 
@@ -42,7 +106,7 @@ void Reaction(double stepsize, const chemtbl_struct chemtbl[], const kintbl_stru
 
             ftemp = SoilTempFactor(rttbl->q10, avg_stc);
 
-            ReactControl(chemtbl, kintbl, rttbl, stepsize, satn, ftemp, &elem[i].chms, elem[i].chmf.react);
+            ReactControl(chemtbl, kintbl, rttbl, stepsize, satn, ftemp, work, &elem[i].chms, elem[i].chmf.react);
         }
 
         for (k = 0; k < nsolute; k++)
@@ -67,7 +131,8 @@ void Reaction(double stepsize, const chemtbl_struct chemtbl[], const kintbl_stru
         if (satn > 1.0E-2)
         {
             ftemp = SoilTempFactor(rttbl->q10, elem[i].ps.tbot);
-            ReactControl(chemtbl, kintbl, rttbl, stepsize, satn, ftemp, &elem[i].chms_geol, elem[i].chmf.react_geol);
+            ReactControl(chemtbl, kintbl, rttbl, stepsize, satn, ftemp, work, &elem[i].chms_geol,
+                elem[i].chmf.react_geol);
         }
 
         for (k = 0; k < nsolute; k++)
@@ -79,7 +144,7 @@ void Reaction(double stepsize, const chemtbl_struct chemtbl[], const kintbl_stru
 }
 
 int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_struct kintbl[], const rttbl_struct *rttbl,
-    double satn, double ftemp, chmstate_struct *chms)
+    double satn, double ftemp, rtwork_struct *rtwork, chmstate_struct *chms)
 {
     int             i, j, k;
     int             kmonod, kinhib;
@@ -111,8 +176,8 @@ int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_str
     double          surf_ratio;
     double          tot_cec;
     realtype      **jcb;
-    sunindextype    p[MAXSPS];
-    realtype        x[MAXSPS];
+    sunindextype   *p;
+    realtype       *x;
     const int       SUFEFF = 1;
     const double    TMPPRB = 1.0E-2;
     const double    TMPPRB_INV = 1.0 / TMPPRB;
@@ -219,7 +284,9 @@ int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_str
         rate_spe[i] *= (chemtbl[i].itype == AQUEOUS) ? inv_sat : 1.0;
     }
 
-    jcb = newDenseMat(rttbl->num_stc - rttbl->num_min, rttbl->num_stc - rttbl->num_min);
+    jcb = rtwork->jcb;
+    p = rtwork->pivot;
+    x = rtwork->x;
 
     if (rttbl->tmp_coup == 0)
     {
@@ -377,7 +444,11 @@ int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_str
             residue[i] = tmpval - (chms->tot_conc[i] + (rate_spe[i] + rate_spet[i]) * stepsize * 0.5);
         }
 
-        if (control % SKIP_JACOB == 0)
+        if (control % SKIP_JACOB == 0 && rttbl->jac_type == ANALYTIC_JAC)
+        {
+            ReactJac(stepsize, satn, chemtbl, kintbl, rttbl, area, iap, dependency, rate_pre, tmpconc, jcb);
+        }
+        else if (control % SKIP_JACOB == 0)
         {
             for (k = 0; k < rttbl->num_stc - rttbl->num_min; k++)
             {
@@ -440,8 +511,6 @@ int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_str
         }
     } while (max_error > TOL);
 
-    destroyMat(jcb);
-
     for (i = 0; i < rttbl->num_ssc; i++)
     {
         tmpval = 0.0;
@@ -493,8 +562,100 @@ int SolveReact(double stepsize, const chemtbl_struct chemtbl[], const kintbl_str
     return 0;
 }
 
+// Analytic Jacobian of the reaction residuals with respect to log10 concentrations of non-mineral primary species.
+// Residual i is the total concentration sum_j conc_contrib[i][j] * 10^c[j] minus the time-centered kinetic source, in
+// which secondary species depend on primary species through dep_mtx, and TST rates depend on primary species through
+// the dependency and ion activity product terms (dep_kin). Activity coefficients and Monod terms are held constant
+// during Newton iterations.
+void ReactJac(double stepsize, double satn, const chemtbl_struct chemtbl[], const kintbl_struct kintbl[],
+    const rttbl_struct *rttbl, const double area[], const double iap[], const double dependency[],
+    const double rate_pre[], const double tmpconc[], realtype **jcb)
+{
+    int             i, j, k;
+    int             nrow;
+    double          conc[MAXSPS];
+    double          rate_scale[MAXSPS];
+
+    nrow = rttbl->num_stc - rttbl->num_min;
+
+    for (j = 0; j < rttbl->num_stc + rttbl->num_ssc; j++)
+    {
+        conc[j] = pow(10, tmpconc[j]);
+    }
+
+    for (i = 0; i < nrow; i++)
+    {
+        // Unit conversion of rates and the 0.5 * stepsize factor of the residuals
+        rate_scale[i] = (i < rttbl->num_spc && chemtbl[i].itype == AQUEOUS) ?
+            0.5 * stepsize / satn : 0.5 * stepsize;
+    }
+
+    for (k = 0; k < nrow; k++)
+    {
+        for (i = 0; i < nrow; i++)
+        {
+            double          dconc;
+
+            dconc = rttbl->conc_contrib[i][k] * conc[k];
+            if (k < rttbl->num_sdc)
+            {
+                for (j = 0; j < rttbl->num_ssc; j++)
+                {
+                    dconc += rttbl->conc_contrib[i][j + rttbl->num_stc] * conc[j + rttbl->num_stc] *
+                        rttbl->dep_mtx[j][k];
+                }
+            }
+
+            jcb[k][i] = LN10 * dconc;
+        }
+    }
+
+    for (j = 0; j < rttbl->num_mkr + rttbl->num_akr; j++)
+    {
+        int             min_pos;
+        double          fwd;    // forward rate, i.e., rate without the affinity term
+        double          temp_keq;
+
+        if (kintbl[j].type != TST)
+        {
+            continue;
+        }
+
+        min_pos = kintbl[j].position - rttbl->num_stc + rttbl->num_min;
+        fwd = area[min_pos] * pow(10, kintbl[j].rate) * dependency[j];
+        temp_keq = pow(10, rttbl->keq_kin[j]);
+
+        for (k = 0; k < nrow; k++)
+        {
+            double          dlog_dep = 0.0;
+            double          dlog_iap;
+            double          drate;
+            int             kdep;
+
+            for (kdep = 0; kdep < kintbl[j].ndep; kdep++)
+            {
+                dlog_dep += (kintbl[j].dep_index[kdep] == k) ? kintbl[j].dep_power[kdep] : 0.0;
+            }
+
+            dlog_iap = (chemtbl[k].itype != MINERAL) ? rttbl->dep_kin[j][k] : 0.0;
+
+            drate = LN10 * (rate_pre[j] * dlog_dep - fwd * iap[j] / temp_keq * dlog_iap);
+
+            if (drate == 0.0)
+            {
+                continue;
+            }
+
+            for (i = 0; i < nrow; i++)
+            {
+                jcb[k][i] -= rate_scale[i] * rttbl->dep_kin[j][i] * drate;
+            }
+        }
+    }
+}
+
 void ReactControl(const chemtbl_struct chemtbl[], const kintbl_struct kintbl[], const rttbl_struct *rttbl,
-    double stepsize, double satn, double ftemp, chmstate_struct *chms, double react_flux[])
+    double stepsize, double satn, double ftemp, rtwork_struct *rtwork, chmstate_struct *chms, double react_flux[])
 {
     double          t_conc0[MAXSPS];
     double          substep;
@@ -511,7 +672,7 @@ void ReactControl(const chemtbl_struct chemtbl[], const kintbl_struct kintbl[],
 
     while (1.0 - step_counter / stepsize > 1.0E-10 && substep > 30.0)
     {
-        flag = SolveReact(substep, chemtbl, kintbl, rttbl, satn, ftemp, chms);
+        flag = SolveReact(substep, chemtbl, kintbl, rttbl, satn, ftemp, rtwork, chms);
 
         if (flag == 0)
         {
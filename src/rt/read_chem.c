@@ -118,6 +118,26 @@ void ReadChem(const char chem_fn[], const char cdbs_fn[], chemtbl_struct chemtbl
         pihm_printf(VL_VERBOSE, "  Averaging window for asynchronous reaction %d seconds.\n", ctrl->AvgScl);
     }
 
+    // Reaction Jacobian type is optional, and finite difference Jacobian is used by default
+    rttbl->jac_type = FD_JAC;
+    if (NextOptLine(chem_fp, "JACOBIAN", cmdstr, &lno))
+    {
+        ReadKeyword(cmdstr, "JACOBIAN", 'i', chem_fn, lno, &rttbl->jac_type);
+    }
+    switch (rttbl->jac_type)
+    {
+        case FD_JAC:
+            pihm_printf(VL_VERBOSE, "  Reaction Jacobian is calculated using finite difference.\n");
+            break;
+        case ANALYTIC_JAC:
+            pihm_printf(VL_VERBOSE, "  Reaction Jacobian is calculated analytically.\n");
+            break;
+        default:
+            pihm_printf(VL_ERROR, "Error: Reaction Jacobian type %d is not defined.\n", rttbl->jac_type);
+            pihm_printf(VL_ERROR, "Error in %s near Line %d.\n", chem_fn, lno);
+            pihm_exit(EXIT_FAILURE);
+    }
+
     NextLine(chem_fp, cmdstr, &lno);
     ctrl->prtvrbl[CHEM_CTRL] = ReadPrintCtrl(cmdstr, "OUTINTVL", chem_fn, lno);
     if (ctrl->prtvrbl[CHEM_CTRL] > 0)
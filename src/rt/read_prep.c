@@ -87,6 +87,7 @@ void ReadPrep(const char fn[], const chemtbl_struct chemtbl[], const rttbl_struc
             forc->prcpc[i].ftime = (int *)malloc((forc->prcpc[i].length) * sizeof(int));
             forc->prcpc[i].data = (double **)malloc((forc->prcpc[i].length) * sizeof(double *));
             forc->prcpc[i].value = (double *)malloc(rttbl->num_spc * sizeof(double));
+            forc->prcpc[i].cursor = 0;
 
             for (j = 0; j < forc->prcpc[i].length; j++)
             {
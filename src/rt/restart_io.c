@@ -1,8 +1,9 @@
 #include "pihm.h"
 
-void WriteRtIc(const char *outputdir, const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, elem_struct elem[])
+void WriteRtIc(const char *outputdir, const chemtbl_struct chemtbl[], const rttbl_struct *rttbl,
+    const order_struct *order, elem_struct elem[])
 {
-    int             i;
+    int             i, n;
     FILE           *fp;
     char            fn[MAXSTRING];
 
@@ -11,10 +12,12 @@ void WriteRtIc(const char *outputdir, const chemtbl_struct chemtbl[], const rttb
     fp = pihm_fopen(fn, "wb");
     pihm_printf(VL_VERBOSE, "Writing RT initial conditions.\n");
 
-    for (i = 0; i < nelem; i++)
+    for (n = 0; n < nelem; n++)
     {
         int             j, k;
 
+        i = order->elem[n];
+
         for (k = 0; k < MAXSPS; k++)
         {
             if (k < rttbl->num_stc && chemtbl[k].itype == MINERAL)
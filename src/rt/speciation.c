@@ -2,7 +2,8 @@
 
 #define TOL        1E-7
 
-void RiverSpeciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, river_struct river[])
+void RiverSpeciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, rtwork_struct rtwork[],
+    river_struct river[])
 {
     int             i;
 
@@ -12,6 +13,11 @@ void RiverSpeciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl,
     for (i = 0; i < nriver; i++)
     {
         int             k;
+#if defined(_OPENMP)
+        rtwork_struct  *work = &rtwork[omp_get_thread_num()];
+#else
+        rtwork_struct  *work = &rtwork[0];
+#endif
 
         for (k = 0; k < rttbl->num_spc; k++)
         {
@@ -20,12 +26,13 @@ void RiverSpeciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl,
 
         if (river[i].ws.stage > DEPTHR)
         {
-            Speciation(chemtbl, rttbl, 0, &river[i].chms);
+            Speciation(chemtbl, rttbl, 0, work, &river[i].chms);
         }
     }
 }
 
-void Speciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, int speciation_flg, chmstate_struct *chms)
+void Speciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, int speciation_flg, rtwork_struct *rtwork,
+    chmstate_struct *chms)
 {
     int             i, j, k;
     int             jcb_dim;
@@ -36,6 +43,8 @@ void Speciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, int s
     double          keq[MAXSPS];
     double          maxerror;
     realtype      **jcb;
+    sunindextype   *p;
+    realtype       *x;
     const double    TMPPRB = 1E-2;
 
     // If speciation flg = 1, pH is defined. Total concentration is calculated from the activity of H+. Dependency is
@@ -73,12 +82,12 @@ void Speciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, int s
 
     jcb_dim = (speciation_flg == 1) ? rttbl->num_stc - 1: rttbl->num_stc;
 
-    jcb = newDenseMat(jcb_dim, jcb_dim);
+    jcb = rtwork->jcb;
+    p = rtwork->pivot;
+    x = rtwork->x;
 
     do
     {
-        sunindextype    p[MAXSPS];
-        realtype        x[MAXSPS];
         int             row, col;
 
         if (rttbl->actv_mode == 1)
@@ -258,6 +267,4 @@ void Speciation(const chemtbl_struct chemtbl[], const rttbl_struct *rttbl, int s
 #endif
         }
     }
-
-    destroyMat(jcb);
 }
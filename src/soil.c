@@ -7,6 +7,18 @@ double KrFunc(double beta, double satn)
         (1.0 - pow(1.0 - pow(satn, beta / (beta - 1.0)), (beta - 1.0) / beta));
 }
 
+// Relative hydraulic conductivity as a function of saturation deficit (1 - satn), which does not lose precision when
+// saturation is close to 1
+double KrFuncDeficit(double beta, double deficit)
+{
+    double          se_deficit;             // 1 - satn ^ (beta / (beta - 1))
+
+    se_deficit = -expm1(beta / (beta - 1.0) * log1p(-deficit));
+
+    return sqrt(1.0 - deficit) *
+        (1.0 - pow(se_deficit, (beta - 1.0) / beta)) * (1.0 - pow(se_deficit, (beta - 1.0) / beta));
+}
+
 // Solve field capacity using Newton's method
 // Field capacity is defined as (Chen and Dudhia 2001 MWR)
 // Theta_ref = Theta_s * (1 / 3 + 2 / 3 * satn_ref)
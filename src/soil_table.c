@@ -0,0 +1,276 @@
+#include "pihm.h"
+
+// Tabulate van Genuchten soil hydraulic functions for every beta value of soil (and geology) types. Elements of the
+// same soil type share the same table
+vgtbl_struct *InitVgTbl(int nintv, int *nvgtbl, elem_struct elem[])
+{
+    vgtbl_struct   *vgtbl = NULL;
+    double         *beta = NULL;
+    int             ntbl = 0;
+    int             i, k;
+
+    if (nintv == 0)
+    {
+        LinkVgTbl(0, NULL, elem);
+
+        *nvgtbl = 0;
+
+        return NULL;
+    }
+
+    // Find distinct beta values
+    for (i = 0; i < nelem; i++)
+    {
+        double          elem_beta[2];
+        int             nbeta = 1;
+        int             j;
+
+        elem_beta[0] = elem[i].soil.beta;
+#if defined(_DGW_)
+        elem_beta[nbeta++] = elem[i].geol.beta;
+#endif
+
+        for (j = 0; j < nbeta; j++)
+        {
+            for (k = 0; k < ntbl; k++)
+            {
+                if (beta[k] == elem_beta[j])
+                {
+                    break;
+                }
+            }
+
+            if (k == ntbl)
+            {
+                beta = (double *)realloc(beta, (ntbl + 1) * sizeof(double));
+                beta[ntbl++] = elem_beta[j];
+            }
+        }
+    }
+
+    pihm_printf(VL_VERBOSE, " Tabulating soil hydraulic functions of %d soil type(s) with %d intervals per binade\n",
+        ntbl, nintv);
+
+    vgtbl = (vgtbl_struct *)malloc(ntbl * sizeof(vgtbl_struct));
+
+    for (k = 0; k < ntbl; k++)
+    {
+        BuildVgTbl(nintv, beta[k], &vgtbl[k]);
+
+        if (verbose_mode >= VL_VERBOSE)
+        {
+            CheckVgTbl(&vgtbl[k]);
+        }
+    }
+
+    LinkVgTbl(ntbl, vgtbl, elem);
+
+    free(beta);
+
+    *nvgtbl = ntbl;
+
+    return vgtbl;
+}
+
+// Point element soil (and geology) properties to the tables of their beta values, or to NULL (closed-form functions)
+// without tables. Also used to restore the pointers after element structures are read from a checkpoint file
+void LinkVgTbl(int nvgtbl, const vgtbl_struct vgtbl[], elem_struct elem[])
+{
+    int             i, k;
+
+    for (i = 0; i < nelem; i++)
+    {
+        elem[i].soil.vgtbl = NULL;
+#if defined(_DGW_)
+        elem[i].geol.vgtbl = NULL;
+#endif
+
+        for (k = 0; k < nvgtbl; k++)
+        {
+            if (vgtbl[k].beta == elem[i].soil.beta)
+            {
+                elem[i].soil.vgtbl = &vgtbl[k];
+            }
+#if defined(_DGW_)
+            if (vgtbl[k].beta == elem[i].geol.beta)
+            {
+                elem[i].geol.vgtbl = &vgtbl[k];
+            }
+#endif
+        }
+    }
+}
+
+void BuildVgTbl(int nintv, double beta, vgtbl_struct *vgtbl)
+{
+    int             nnode_lo;
+    int             nnode_up;
+    int             k;
+
+    vgtbl->beta = beta;
+    vgtbl->nintv = nintv;
+    vgtbl->exp_lo = ilogb(SATMIN) + 1;      // exponent of SATMIN as returned by frexp
+
+    // Binades of saturation are from SATMIN to 0.5, and binades of saturation deficit are from the smallest deficit
+    // below 1 (2 ^ -DBL_MANT_DIG) to 0.5. One extra node is added so that the upper bounds of the tables can be
+    // interpolated
+    nnode_lo = -vgtbl->exp_lo * nintv + 2;
+    nnode_up = (DBL_MANT_DIG - 1) * nintv + 2;
+
+    vgtbl->kr_lo = (double *)malloc(nnode_lo * sizeof(double));
+    vgtbl->psi_lo = (double *)malloc(nnode_lo * sizeof(double));
+    vgtbl->kr_up = (double *)malloc(nnode_up * sizeof(double));
+    vgtbl->psi_up = (double *)malloc(nnode_up * sizeof(double));
+
+    for (k = 0; k < nnode_lo; k++)
+    {
+        double          satn;
+
+        satn = ldexp(0.5 + 0.5 * (double)(k % nintv) / (double)nintv, vgtbl->exp_lo + k / nintv);
+
+        // Psi limits saturation to SATMIN, thus suction head at nodes below SATMIN is calculated using saturation
+        // deficit, so that the interval that contains SATMIN can be interpolated
+        vgtbl->kr_lo[k] = KrFunc(beta, satn);
+        vgtbl->psi_lo[k] = PsiDeficit(1.0 - satn, 1.0, beta);
+    }
+
+    for (k = 0; k < nnode_up; k++)
+    {
+        double          deficit;
+
+        deficit = ldexp(0.5 + 0.5 * (double)(k % nintv) / (double)nintv, 1 - DBL_MANT_DIG + k / nintv);
+
+        vgtbl->kr_up[k] = KrFuncDeficit(beta, deficit);
+        vgtbl->psi_up[k] = PsiDeficit(deficit, 1.0, beta);
+    }
+}
+
+// Validate tables by reporting maximum relative errors against the closed-form functions at the midpoints of table
+// intervals, where errors of linear interpolation are the largest. Above 0.5 saturation, the closed-form functions are
+// evaluated using saturation deficit to avoid cancellation errors
+void CheckVgTbl(const vgtbl_struct *vgtbl)
+{
+    double          err_kr = 0.0;
+    double          err_psi = 0.0;
+    double          satn_kr = 0.0;
+    double          satn_psi = 0.0;
+    double          satn;
+    double          kr, psi;
+    double          kr_tbl, psi_tbl;
+    int             nintv_lo;
+    int             nintv_up;
+    int             k;
+
+    nintv_lo = -vgtbl->exp_lo * vgtbl->nintv;
+    nintv_up = (DBL_MANT_DIG - 1) * vgtbl->nintv;
+
+    for (k = 0; k < nintv_lo + nintv_up; k++)
+    {
+        if (k < nintv_lo)
+        {
+            satn = ldexp(0.5 + 0.5 * ((double)(k % vgtbl->nintv) + 0.5) / (double)vgtbl->nintv,
+                vgtbl->exp_lo + k / vgtbl->nintv);
+            satn = MAX(satn, SATMIN);
+
+            kr = KrFunc(vgtbl->beta, satn);
+            psi = Psi(satn, 1.0, vgtbl->beta);
+        }
+        else
+        {
+            satn = 1.0 - ldexp(0.5 + 0.5 * ((double)((k - nintv_lo) % vgtbl->nintv) + 0.5) / (double)vgtbl->nintv,
+                1 - DBL_MANT_DIG + (k - nintv_lo) / vgtbl->nintv);
+
+            kr = KrFuncDeficit(vgtbl->beta, 1.0 - satn);
+            psi = PsiDeficit(1.0 - satn, 1.0, vgtbl->beta);
+        }
+
+        VgTblLookup(satn, vgtbl, &kr_tbl, &psi_tbl);
+
+        if (fabs(kr_tbl - kr) > err_kr * fabs(kr))
+        {
+            err_kr = fabs(kr_tbl - kr) / fabs(kr);
+            satn_kr = satn;
+        }
+
+        if (fabs(psi_tbl - psi) > err_psi * fabs(psi))
+        {
+            err_psi = fabs(psi_tbl - psi) / fabs(psi);
+            satn_psi = satn;
+        }
+    }
+
+    pihm_printf(VL_VERBOSE, "  beta = %.4lf: maximum relative error of Kr is %.3le (satn = %.6lf), "
+        "maximum relative error of psi is %.3le (satn = %.6lf)\n", vgtbl->beta, err_kr, satn_kr, err_psi, satn_psi);
+}
+
+void FreeVgTbl(int nvgtbl, vgtbl_struct vgtbl[])
+{
+    int             k;
+
+    for (k = 0; k < nvgtbl; k++)
+    {
+        free(vgtbl[k].kr_lo);
+        free(vgtbl[k].psi_lo);
+        free(vgtbl[k].kr_up);
+        free(vgtbl[k].psi_up);
+    }
+
+    free(vgtbl);
+}
+
+// Relative hydraulic conductivity and suction head (with alpha = 1 m-1) from tables. Saturation below SATMIN is
+// treated as SATMIN
+void VgTblLookup(double satn, const vgtbl_struct *vgtbl, double *kr, double *psi)
+{
+    const double   *kr_tbl;
+    const double   *psi_tbl;
+    double          frac;
+    double          x;
+    int             exponent;
+    int             k;
+
+    if (satn >= 1.0)
+    {
+        *kr = 1.0;
+        *psi = 0.0;
+        return;
+    }
+    else if (satn < 0.5)
+    {
+        frac = frexp(MAX(satn, SATMIN), &exponent);
+        exponent -= vgtbl->exp_lo;
+        kr_tbl = vgtbl->kr_lo;
+        psi_tbl = vgtbl->psi_lo;
+    }
+    else
+    {
+        frac = frexp(1.0 - satn, &exponent);
+        exponent -= 1 - DBL_MANT_DIG;
+        kr_tbl = vgtbl->kr_up;
+        psi_tbl = vgtbl->psi_up;
+    }
+
+    // frexp returns fractions in [0.5, 1)
+    x = (frac - 0.5) * 2.0 * (double)vgtbl->nintv;
+    k = (int)x;
+    x -= (double)k;
+    k += exponent * vgtbl->nintv;
+
+    *kr = kr_tbl[k] + x * (kr_tbl[k + 1] - kr_tbl[k]);
+    *psi = psi_tbl[k] + x * (psi_tbl[k + 1] - psi_tbl[k]);
+}
+
+// Relative hydraulic conductivity and suction head of a soil, using tables if soil hydraulic functions are tabulated
+void VgFunc(double satn, const soil_struct *soil, double *kr, double *psi)
+{
+    if (soil->vgtbl != NULL)
+    {
+        VgTblLookup(satn, soil->vgtbl, kr, psi);
+        *psi /= soil->alpha;
+    }
+    else
+    {
+        *kr = KrFunc(soil->beta, satn);
+        *psi = Psi(satn, soil->alpha, soil->beta);
+    }
+}
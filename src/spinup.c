@@ -1,6 +1,6 @@
 #include "pihm.h"
 
-void Spinup(pihm_struct pihm, N_Vector CV_Y, void *cvode_mem, SUNLinearSolver *sun_ls)
+void Spinup(pihm_struct pihm)
 {
     int             spinyears = 0;
     int             first_spin_cycle = 1;
@@ -20,9 +20,12 @@ void Spinup(pihm_struct pihm, N_Vector CV_Y, void *cvode_mem, SUNLinearSolver *s
         ResetSpinupStat(pihm->elem);
 #endif
 
+        // Forcing is rewound to the beginning of the forcing window
+        ResetForcing(&pihm->forc);
+
         for (ctrl->cstep = 0; ctrl->cstep < ctrl->nstep; ctrl->cstep++)
         {
-            PIHM(0.0, pihm, cvode_mem, CV_Y);
+            PIHM(0.0, pihm, pihm->ctx.cvode_mem, pihm->ctx.CV_Y);
         }
 
 #if defined(_CYCLES_)
@@ -30,15 +33,15 @@ void Spinup(pihm_struct pihm, N_Vector CV_Y, void *cvode_mem, SUNLinearSolver *s
 #endif
 
         // Reset solver parameters
-        SetCVodeParam(pihm, cvode_mem, sun_ls, CV_Y);
+        SetCVodeParam(pihm, pihm->ctx.cvode_mem, &pihm->ctx.sun_ls, pihm->ctx.CV_Y);
 
         spinyears += metyears;
 
 #if defined(_BGC_)
         steady = CheckSteadyState(first_spin_cycle, ctrl->endtime - ctrl->starttime, spinyears, pihm->siteinfo.area,
-            pihm->elem);
+            pihm->elem, &pihm->ctx);
 #else
-        steady = CheckSteadyState(first_spin_cycle, spinyears, pihm->siteinfo.area, pihm->elem);
+        steady = CheckSteadyState(first_spin_cycle, spinyears, pihm->siteinfo.area, pihm->elem, &pihm->ctx);
 #endif
 
         first_spin_cycle = 0;
@@ -62,29 +65,26 @@ void ResetSpinupStat(elem_struct elem[])
 #endif
 
 #if defined(_BGC_)
-int CheckSteadyState(int first_cycle, int totalt, int spinyears, double total_area, const elem_struct elem[])
+int CheckSteadyState(int first_cycle, int totalt, int spinyears, double total_area, const elem_struct elem[],
+    ctx_struct *ctx)
 #else
-int CheckSteadyState(int first_cycle, int spinyears, double total_area, const elem_struct elem[])
+int CheckSteadyState(int first_cycle, int spinyears, double total_area, const elem_struct elem[], ctx_struct *ctx)
 #endif
 {
     int             i;
     double          totalw = 0.0;
-    static double   totalw_prev = 0.0;
     int             steady;
 #if defined(_BGC_)
     double          t1 = 0.0;
     double          soilc = 0.0;
     double          totalc = 0.0;
-    static double   soilc_prev = 0.0;
 #endif
 #if defined(_CYCLES_)
-    static double   soc_prev = 0.0;
     double          soc = 0.0;
     double          cdiff;
 #endif
 #if defined(_DGW_)
     double          gwgeol = 0.0;
-    static double   gwgeol_prev = 0.0;
 #endif
 
     for (i = 0; i < nelem; i++)
@@ -101,21 +101,21 @@ int CheckSteadyState(int first_cycle, int spinyears, double total_area, const el
         // Convert soilc and totalc to average daily soilc
         soilc += elem[i].spinup.soilc * elem[i].topo.area / (double)(totalt / DAYINSEC) / total_area;
         totalc += elem[i].spinup.totalc * elem[i].topo.area / (double)(totalt / DAYINSEC) / total_area;
-        t1 = (soilc - soilc_prev) / (double)(totalt / DAYINSEC / 365);
+        t1 = (soilc - ctx->soilc_prev) / (double)(totalt / DAYINSEC / 365);
 #endif
 
 #if defined(_CYCLES_)
         soc += Profile(elem[i].ps.nlayers, elem[i].cs.soc) * elem[i].topo.area / total_area;
-        cdiff = (soc_prev > 0.0) ? (soc - soc_prev) / soc_prev : BADVAL;
+        cdiff = (ctx->soc_prev > 0.0) ? (soc - ctx->soc_prev) / ctx->soc_prev : BADVAL;
 #endif
     }
 
     if (!first_cycle)
     {
         // Check if domain reaches steady state
-        steady = (fabs(totalw - totalw_prev) < SPINUP_W_TOLERANCE);
+        steady = (fabs(totalw - ctx->totalw_prev) < SPINUP_W_TOLERANCE);
 #if defined(_DGW_)
-        steady = (steady && (fabs(gwgeol - gwgeol_prev) < SPINUP_W_TOLERANCE));
+        steady = (steady && (fabs(gwgeol - ctx->gwgeol_prev) < SPINUP_W_TOLERANCE));
 #endif
 #if defined(_BGC_)
         steady = (steady && (fabs(t1) < SPINUP_C_TOLERANCE));
@@ -125,15 +125,17 @@ int CheckSteadyState(int first_cycle, int spinyears, double total_area, const el
 #endif
 
         pihm_printf(VL_BRIEF, "spinyears = %d ", spinyears);
-        pihm_printf(VL_BRIEF, "totalw_prev = %lg totalw = %lg wdif = %lg\n", totalw_prev, totalw, totalw - totalw_prev);
+        pihm_printf(VL_BRIEF, "totalw_prev = %lg totalw = %lg wdif = %lg\n", ctx->totalw_prev, totalw,
+            totalw - ctx->totalw_prev);
 #if defined(_DGW_)
-        pihm_printf(VL_BRIEF, "dgw_prev = %lg dgw = %lg wdif = %lg\n", gwgeol_prev, gwgeol, gwgeol - gwgeol_prev);
+        pihm_printf(VL_BRIEF, "dgw_prev = %lg dgw = %lg wdif = %lg\n", ctx->gwgeol_prev, gwgeol,
+            gwgeol - ctx->gwgeol_prev);
 #endif
 #if defined(_BGC_)
-        pihm_printf(VL_BRIEF, "soilc_prev = %lg soilc = %lg pdif = %lg\n", soilc_prev, soilc, t1);
+        pihm_printf(VL_BRIEF, "soilc_prev = %lg soilc = %lg pdif = %lg\n", ctx->soilc_prev, soilc, t1);
 #endif
 #if defined(_CYCLES_)
-        pihm_printf(VL_BRIEF, "soc_prev = %lg soc = %lg cdiff = %lg\n", soc_prev, soc, cdiff);
+        pihm_printf(VL_BRIEF, "soc_prev = %lg soc = %lg cdiff = %lg\n", ctx->soc_prev, soc, cdiff);
 #endif
     }
     else
@@ -141,15 +143,15 @@ int CheckSteadyState(int first_cycle, int spinyears, double total_area, const el
         steady = 0;
     }
 
-    totalw_prev = totalw;
+    ctx->totalw_prev = totalw;
 #if defined(_DGW_)
-    gwgeol_prev = gwgeol;
+    ctx->gwgeol_prev = gwgeol;
 #endif
 #if defined(_BGC_)
-    soilc_prev = soilc;
+    ctx->soilc_prev = soilc;
 #endif
 #if defined(_CYCLES_)
-    soc_prev = soc;
+    ctx->soc_prev = soc;
 #endif
 
     if (steady)
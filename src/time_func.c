@@ -3,11 +3,17 @@
 pihm_t_struct PIHMTime(int t)
 {
     pihm_t_struct   pihm_time;
-    struct tm      *timestamp;
+    struct tm       tm_buf;
+    struct tm      *timestamp = &tm_buf;
     time_t          rawtime;
 
     rawtime = (time_t)t;
-    timestamp = gmtime(&rawtime);
+    // Reentrant conversion so that model instances can be run concurrently
+#if defined(_MSC_VER)
+    gmtime_s(timestamp, &rawtime);
+#else
+    gmtime_r(&rawtime, timestamp);
+#endif
 
     pihm_time.t = t;
     pihm_time.year = timestamp->tm_year + 1900;
@@ -76,27 +82,35 @@ int StrTime(const char timestr[])
 }
 
 #if defined(_OPENMP)
-void RunTime(double start_omp, double *cputime, double *cputime_dt)
+void RunTime(double start_omp, double *ptime_omp, double *cputime, double *cputime_dt)
 {
-    static double   ptime_omp;
     double          ct_omp;
 
-    ptime_omp = (ptime_omp == 0.0) ? start_omp : ptime_omp;
+    *ptime_omp = (*ptime_omp == 0.0) ? start_omp : *ptime_omp;
     ct_omp = omp_get_wtime();
-    *cputime_dt = (double)(ct_omp - ptime_omp);
+    *cputime_dt = (double)(ct_omp - *ptime_omp);
     *cputime = (double)(ct_omp - start_omp);
-    ptime_omp = ct_omp;
+    *ptime_omp = ct_omp;
 }
 #else
-void RunTime (clock_t start, double *cputime, double *cputime_dt)
+void RunTime (clock_t start, clock_t *ptime, double *cputime, double *cputime_dt)
 {
-    static clock_t  ptime;
     clock_t         ct;
 
-    ptime = (ptime == 0.0) ? start : ptime;
+    *ptime = (*ptime == 0.0) ? start : *ptime;
     ct = clock();
-    *cputime_dt = ((double)(ct - ptime)) / CLOCKS_PER_SEC;
+    *cputime_dt = ((double)(ct - *ptime)) / CLOCKS_PER_SEC;
     *cputime = ((double)(ct - start)) / CLOCKS_PER_SEC;
-    ptime = ct;
+    *ptime = ct;
 }
 #endif
+
+// Wall clock time (s) used by phase timers. Without OpenMP, cpu time is used as in RunTime
+double WallTime(void)
+{
+#if defined(_OPENMP)
+    return omp_get_wtime();
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
@@ -0,0 +1,129 @@
+#include "pihm.h"
+
+// Names and parent phases of timers, in the order of timer indices. The time of a parent phase includes the time of
+// its child phases
+const char     *TIMER_INFO[NUM_TIMER][2] = {
+    {"step", ""},
+    {"apply_bc", "step"},
+    {"apply_forcing", "step"},
+    {"land_surface", "step"},
+    {"reaction", "step"},
+    {"daily", "step"},
+    {"cvode", "step"},
+    {"rhs", "cvode"},
+    {"prec_setup", "cvode"},
+    {"prec_solve", "cvode"},
+    {"halo_exchange", "rhs"},
+    {"hydrol_state", "rhs"},
+    {"et_uptake", "rhs"},
+    {"lateral_flow", "rhs"},
+    {"vertical_flow", "rhs"},
+    {"river_flow", "rhs"},
+    {"solute_transport", "rhs"},
+    {"gather", "step"},
+    {"update_var", "step"},
+    {"print", "step"},
+    {"startup", ""}
+};
+
+void TimerStart(int timer, timing_struct *timing)
+{
+    timing->start[timer] = WallTime();
+}
+
+void TimerStop(int timer, timing_struct *timing)
+{
+    timing->time[timer] += WallTime() - timing->start[timer];
+    timing->calls[timer]++;
+}
+
+void InitTimingFile(FILE *fp)
+{
+    int             k;
+
+    // Header is only written to new files, so that rows can be appended in append and resume modes
+    fseek(fp, 0, SEEK_END);
+    if (ftell(fp) == 0)
+    {
+        fprintf(fp, "time");
+        for (k = 0; k < NUM_TIMER; k++)
+        {
+            fprintf(fp, ",%s", TIMER_INFO[k][0]);
+        }
+        fprintf(fp, "\n");
+        fflush(fp);
+    }
+}
+
+// Print wall clock time of each phase since previous timing output
+void PrintTiming(int t, int lapse, int intvl, timing_struct *timing, FILE *fp)
+{
+    pihm_t_struct   pihm_time;
+    int             k;
+
+    pihm_time = PIHMTime(t);
+
+    if (PrintNow(intvl, lapse, pihm_time))
+    {
+        fprintf(fp, "%s", pihm_time.str);
+        for (k = 0; k < NUM_TIMER; k++)
+        {
+            fprintf(fp, ",%.6lf", timing->time[k] - timing->time_prev[k]);
+            timing->time_prev[k] = timing->time[k];
+        }
+        fprintf(fp, "\n");
+        fflush(fp);
+    }
+}
+
+// Write accumulated wall clock time and number of calls of each phase to a csv file at the end of simulation. Solver
+// time that is not spent in right-hand side or preconditioner functions (i.e., linear and nonlinear iterations and
+// integrator overhead) is reported as cvode_other. In MPI mode, the maximum values among processes are written by the
+// root process
+void WriteTiming(const char outputdir[], const timing_struct *timing)
+{
+    FILE           *fp;
+    char            fn[MAXSTRING];
+    double          time[NUM_TIMER];
+    long int        calls[NUM_TIMER];
+    double          other;
+    int             k;
+
+    memcpy(time, timing->time, sizeof(time));
+    memcpy(calls, timing->calls, sizeof(calls));
+
+#if defined(_MPI_)
+    int             rank;
+
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Reduce((rank == 0) ? MPI_IN_PLACE : time, time, NUM_TIMER, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    MPI_Reduce((rank == 0) ? MPI_IN_PLACE : calls, calls, NUM_TIMER, MPI_LONG, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    if (rank > 0)
+    {
+        return;
+    }
+#endif
+
+    if (snprintf(fn, sizeof(fn), "%s%s.timing.csv", outputdir, project) >= (int)sizeof(fn))
+    {
+        pihm_printf(VL_ERROR, "Error: Timing summary file name in %s is too long.\n", outputdir);
+        pihm_exit(EXIT_FAILURE);
+    }
+    fp = pihm_fopen(fn, "w");
+
+    fprintf(fp, "phase,parent,calls,seconds,percent\n");
+    for (k = 0; k < NUM_TIMER; k++)
+    {
+        fprintf(fp, "%s,%s,%ld,%.6lf,%.2lf\n", TIMER_INFO[k][0], TIMER_INFO[k][1], calls[k], time[k],
+            (time[TM_STEP] > 0.0) ? 100.0 * time[k] / time[TM_STEP] : 0.0);
+    }
+
+    other = time[TM_CVODE] - time[TM_RHS] - time[TM_PREC_SETUP] - time[TM_PREC_SOLVE];
+    fprintf(fp, "%s,%s,%ld,%.6lf,%.2lf\n", "cvode_other", "cvode", calls[TM_CVODE], other,
+        (time[TM_STEP] > 0.0) ? 100.0 * other / time[TM_STEP] : 0.0);
+
+    fclose(fp);
+
+    pihm_printf(VL_VERBOSE, " Timing summary written to %s.\n", fn);
+}
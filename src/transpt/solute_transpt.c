@@ -1,6 +1,7 @@
 #include "pihm.h"
 
-void SoluteTranspt(double diff_coef, double disp_coef, double cementation, elem_struct elem[], river_struct river[])
+void SoluteTranspt(double diff_coef, double disp_coef, double cementation, const hydro_struct *hydro,
+    elem_struct elem[], river_struct river[])
 {
     int             i;
 
@@ -13,9 +14,10 @@ void SoluteTranspt(double diff_coef, double disp_coef, double cementation, elem_
 
         for (k = 0; k < nsolute; k++)
         {
-            // Initialize chemical fluxes
-            elem[i].solute[k].infil = 0.0;
+            // Infiltration
+            elem[i].solute[k].infil = elem[i].wf.infil * ((elem[i].wf.infil > 0.0) ? elem[i].solute[k].conc_surf : 0.0);
 
+            // Fluxes through shared edges are calculated below, and fluxes through boundary edges are zero
             for (j = 0; j < NUM_EDGE; j++)
             {
                 elem[i].solute[k].subflux[j] = 0.0;
@@ -25,110 +27,87 @@ void SoluteTranspt(double diff_coef, double disp_coef, double cementation, elem_
 #if defined(_DGW_)
         for (k = 0; k < nsolute; k++)
         {
-            // Initialize chemical fluxes
-            elem[i].solute[k].infil_geol = 0.0;
+            // Bedrock infiltration
+            elem[i].solute[k].infil_geol = elem[i].wf.infil_geol * ((elem[i].wf.infil_geol > 0.0) ?
+                elem[i].solute[k].conc : elem[i].solute[k].conc_geol);
 
             for (j = 0; j < NUM_EDGE; j++)
             {
-                elem[i].solute[k].dgwflux[j] = 0.0;
+                // Diffusion and dispersion are ignored for boundary fluxes
+                elem[i].solute[k].dgwflux[j] = (elem[i].nabr[j] > 0 || elem[i].attrib.bc_geol[j] == 0) ?
+                    0.0 : elem[i].wf.dgw[j] * ((elem[i].wf.dgw[j] > 0.0) ?
+                    elem[i].solute[k].conc_geol : elem[i].bc_geol.conc[j][k]);
             }
         }
 #endif
     }
 
+    // Advection, diffusion, and dispersion between triangular elements. Terms that only depend on the shared edge are
+    // calculated once for all species and both directions, and fluxes of all species are calculated in one loop. Each
+    // edge of an element belongs to only one shared edge, so the loop is free of write conflicts
 #if defined(_OPENMP)
 # pragma omp parallel for
 #endif
-    for (i = 0; i < nriver; i++)
+    for (i = 0; i < hydro->nedge; i++)
     {
-        int             j, k;
+        int             ind0 = hydro->edge_ind[2 * i];
+        int             ind1 = hydro->edge_ind[2 * i + 1];
+        int             j0 = ind0 % NUM_EDGE;
+        int             j1 = ind1 % NUM_EDGE;
+        elem_struct    *elem0 = &elem[ind0 / NUM_EDGE];
+        elem_struct    *elem1 = &elem[ind1 / NUM_EDGE];
+        double          wflux[2];
+        double          inv_dist;
+        double          diff;
+        double          disp[2];
+        int             k;
 
-        for (k = 0; k < nsolute; k++)
+        wflux[0] = elem0->wf.subsurf[j0];
+        wflux[1] = elem1->wf.subsurf[j1];
+
+        // Aquifer to river flow of the river segment between the two elements
+        if (i >= hydro->nedge_ovl)
         {
-            // Initialize chemical fluxes
-            for (j = 0; j < NUM_RIVFLX; j++)
-            {
-                river[i].solute[k].flux[j] = 0.0;
-            }
+            const river_struct *river_ptr = &river[hydro->nabr_river[ind0]];
+
+            wflux[0] += (elem0->ind == river_ptr->left) ?
+                river_ptr->wf.rivflow[AQUIFER_LEFT] : river_ptr->wf.rivflow[AQUIFER_RIGHT];
+            wflux[1] += (elem1->ind == river_ptr->left) ?
+                river_ptr->wf.rivflow[AQUIFER_LEFT] : river_ptr->wf.rivflow[AQUIFER_RIGHT];
         }
-    }
 
-    // Calculate chemical fluxes
-#if defined(_OPENMP)
-# pragma omp parallel for
-#endif
-    for (i = 0; i < nelem; i++)
-    {
-        int             j, k;
-        elem_struct    *nabr;
+        inv_dist = 1.0 / hydro->dist_nabr[ind0];
+        diff = DiffCoef(diff_coef, cementation, 0.5 * (elem0->soil.smcmax + elem1->soil.smcmax),
+            0.5 * (elem0->soil.depth + elem1->soil.depth), inv_dist);
+        disp[0] = fabs(wflux[0]) * disp_coef * inv_dist;
+        disp[1] = fabs(wflux[1]) * disp_coef * inv_dist;
 
         for (k = 0; k < nsolute; k++)
         {
-            // Infiltration
-            elem[i].solute[k].infil = elem[i].wf.infil * ((elem[i].wf.infil > 0.0) ? elem[i].solute[k].conc_surf : 0.0);
-
-            // Element to element
-            for (j = 0; j < NUM_EDGE; j++)
-            {
-                if (elem[i].nabr[j] == 0)
-                {
-                    elem[i].solute[k].subflux[j] = 0.0;
-                }
-                else
-                {
-                    double          wflux;
-
-                    nabr = &elem[elem[i].nabr[j] - 1];
-
-                    if (elem[i].nabr_river[j] == 0)
-                    {
-                        wflux = elem[i].wf.subsurf[j];
-                    }
-                    else
-                    {
-                        river_struct           *river_ptr;
-
-                        river_ptr = &river[elem[i].nabr_river[j] - 1];
-
-                        wflux = elem[i].wf.subsurf[j] + ((elem[i].ind == river_ptr->left) ?
-                            river_ptr->wf.rivflow[AQUIFER_LEFT] : river_ptr->wf.rivflow[AQUIFER_RIGHT]);
-                    }
-
-                    // Advection, diffusion, and dispersion between triangular elements
-                    elem[i].solute[k].subflux[j] = AdvDiffDisp(diff_coef, disp_coef, cementation,
-                        elem[i].solute[k].conc, nabr->solute[k].conc, 0.5 * (elem[i].soil.smcmax + nabr->soil.smcmax),
-                        elem[i].topo.dist_nabr[j], 0.5 * (elem[i].soil.depth + nabr->soil.depth), wflux);
-                }
-            }   // End of element to element
+            elem0->solute[k].subflux[j0] =
+                AdvDiffDisp(elem0->solute[k].conc, elem1->solute[k].conc, diff, disp[0], wflux[0]);
+            elem1->solute[k].subflux[j1] =
+                AdvDiffDisp(elem1->solute[k].conc, elem0->solute[k].conc, diff, disp[1], wflux[1]);
+        }
 
 #if defined(_DGW_)
-            // Bedrock infiltration
-            elem[i].solute[k].infil_geol = elem[i].wf.infil_geol * ((elem[i].wf.infil_geol > 0.0) ?
-                elem[i].solute[k].conc : elem[i].solute[k].conc_geol);
+        // Groundwater advection, diffusion, and dispersion
+        wflux[0] = elem0->wf.dgw[j0];
+        wflux[1] = elem1->wf.dgw[j1];
 
-            // Element to element
-            for (j = 0; j < NUM_EDGE; j++)
-            {
-                if (elem[i].nabr[j] == 0)
-                {
-                    // Diffusion and dispersion are ignored for boundary fluxes
-                    elem[i].solute[k].dgwflux[j] = (elem[i].attrib.bc_geol[j] == 0) ?
-                        0.0 : elem[i].wf.dgw[j] * ((elem[i].wf.dgw[j] > 0.0) ?
-                        elem[i].solute[k].conc_geol : elem[i].bc_geol.conc[j][k]);
-                }
-                else
-                {
-                    nabr = &elem[elem[i].nabr[j] - 1];
-
-                    // Groundwater advection, diffusion, and dispersion
-                    elem[i].solute[k].dgwflux[j] = AdvDiffDisp(diff_coef, disp_coef, cementation,
-                        elem[i].solute[k].conc_geol, nabr->solute[k].conc_geol,
-                        0.5 * (elem[i].geol.smcmax + nabr->geol.smcmax), elem[i].topo.dist_nabr[j],
-                        0.5 * (elem[i].geol.depth + nabr->geol.depth), elem[i].wf.dgw[j]);
-                }
-            }   // End of element to element
+        diff = DiffCoef(diff_coef, cementation, 0.5 * (elem0->geol.smcmax + elem1->geol.smcmax),
+            0.5 * (elem0->geol.depth + elem1->geol.depth), inv_dist);
+        disp[0] = fabs(wflux[0]) * disp_coef * inv_dist;
+        disp[1] = fabs(wflux[1]) * disp_coef * inv_dist;
+
+        for (k = 0; k < nsolute; k++)
+        {
+            elem0->solute[k].dgwflux[j0] =
+                AdvDiffDisp(elem0->solute[k].conc_geol, elem1->solute[k].conc_geol, diff, disp[0], wflux[0]);
+            elem1->solute[k].dgwflux[j1] =
+                AdvDiffDisp(elem1->solute[k].conc_geol, elem0->solute[k].conc_geol, diff, disp[1], wflux[1]);
+        }
 #endif
-        }   // End of species loop
     }
 
 #if defined(_OPENMP)
@@ -137,11 +116,17 @@ void SoluteTranspt(double diff_coef, double disp_coef, double cementation, elem_
     for (i = 0; i < nriver; i++)
     {
         river_struct   *down;
-        int             k;
+        int             j, k;
 
         for (k = 0; k < nsolute; k++)
         {
-            // Downstream and upstream
+            // Initialize chemical fluxes. Upstream fluxes are accumulated below
+            for (j = 0; j < NUM_RIVFLX; j++)
+            {
+                river[i].solute[k].flux[j] = 0.0;
+            }
+
+            // Downstream
             if (river[i].down > 0)
             {
                 down = &river[river[i].down - 1];
@@ -156,36 +141,45 @@ void SoluteTranspt(double diff_coef, double disp_coef, double cementation, elem_
             }
         }
 
-            // Left and right banks
+        // Left and right banks. Each bank element edge belongs to only one river segment, so the loop is free of write
+        // conflicts
         if (river[i].left > 0)
         {
-            RiverElemSoluteFlow(SURF_LEFT, AQUIFER_LEFT, &elem[river[i].left - 1], &river[i]);
+            RiverElemSoluteFlow(SURF_LEFT, AQUIFER_LEFT, hydro->bank_edge[2 * i], &elem[river[i].left - 1],
+                &river[i]);
         }
 
         if (river[i].right > 0)
         {
-            RiverElemSoluteFlow(SURF_RIGHT, AQUIFER_RIGHT, &elem[river[i].right - 1], &river[i]);
+            RiverElemSoluteFlow(SURF_RIGHT, AQUIFER_RIGHT, hydro->bank_edge[2 * i + 1], &elem[river[i].right - 1],
+                &river[i]);
         }
     }
 
-    // Accumulate to get in-flow for down segments
+    // Accumulate to get in-flow for down segments. Each segment gathers out-flows from its upstream segments so that
+    // no two threads update the same segment
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
     for (i = 0; i < nriver; i++)
     {
-        int             k;
+        int             j, k;
 
-        for (k = 0; k < nsolute; k++)
+        for (j = hydro->up_ptr[i]; j < hydro->up_ptr[i + 1]; j++)
         {
-            if (river[i].down > 0)
+            const river_struct *up = &river[hydro->up_ind[j]];
+
+            for (k = 0; k < nsolute; k++)
             {
-                river[river[i].down - 1].solute[k].flux[UPSTREAM] -= river[i].solute[k].flux[DOWNSTREAM];
+                river[i].solute[k].flux[UPSTREAM] -= up->solute[k].flux[DOWNSTREAM];
             }
         }
     }
 }
 
-void RiverElemSoluteFlow(int surf_to_chanl, int aquif_to_chanl, elem_struct *bank, river_struct *river)
+void RiverElemSoluteFlow(int surf_to_chanl, int aquif_to_chanl, int edge, elem_struct *bank, river_struct *river)
 {
-    int             j, k;
+    int             k;
 
     for (k = 0; k < nsolute; k++)
     {
@@ -195,35 +189,28 @@ void RiverElemSoluteFlow(int surf_to_chanl, int aquif_to_chanl, elem_struct *ban
         river->solute[k].flux[aquif_to_chanl] = river->wf.rivflow[aquif_to_chanl] *
             ((river->wf.rivflow[aquif_to_chanl] > 0.0) ? river->solute[k].conc : bank->solute[k].conc);
 
-        for (j = 0; j < NUM_EDGE; j++)
+        if (edge >= 0)
         {
-            if (bank->nabr_river[j] == river->ind)
-            {
-                bank->solute[k].subflux[j] -= river->solute[k].flux[aquif_to_chanl];
-                break;
-            }
+            bank->solute[k].subflux[edge] -= river->solute[k].flux[aquif_to_chanl];
         }
     }
 }
 
-double AdvDiffDisp(double diff_coef, double disp_coef, double cementation, double conc_up, double conc_down,
-    double porosity, double distance, double area, double wflux)
+// Effective diffusion coefficient times cross-sectional area per unit edge length, divided by distance between
+// element centroids
+double DiffCoef(double diff_coef, double cementation, double porosity, double area, double inv_dist)
 {
-    // Calculate the total of advection, diffusion and dispersion
-    double          inv_dist;
-    double          diff_conc;
-    double          diff_flux, disp_flux;
+    return diff_coef * area * pow(porosity, cementation) * inv_dist;
+}
 
-    inv_dist = 1.0 / distance;
+// Total of advection, diffusion, and dispersion from an element to its neighbor. diff is the diffusion coefficient
+// from DiffCoef, and disp is the dispersion coefficient
+double AdvDiffDisp(double conc_up, double conc_down, double diff, double disp, double wflux)
+{
+    double          diff_conc;
 
     // Difference in concentration (mol kg-1 water)
     diff_conc = conc_up - conc_down;
 
-    // Diffusion flux, effective diffusion coefficient
-    diff_flux = diff_coef * area * pow(porosity, cementation) * inv_dist * diff_conc;
-
-    // Longitudinal dispersion
-    disp_flux = fabs(wflux) * disp_coef * inv_dist * diff_conc;
-
-    return wflux * ((wflux > 0.0) ? conc_up : conc_down) + diff_flux + disp_flux;
+    return wflux * ((wflux > 0.0) ? conc_up : conc_down) + diff * diff_conc + disp * diff_conc;
 }
@@ -0,0 +1,243 @@
+#include "pihm.h"
+#include "optparse.h"
+
+// Reader of chunked output files (.chk). Only the blocks needed are decompressed, i.e., one block per frame for the
+// time series of a single column, and one frame for a time slice. The frame of a time slice is located using the frame
+// index file (.idx) next to the chunked output file. Frames are scanned from the beginning if the index is not
+// available.
+//
+// Usage: chunk-dump [-c column] [-t "YYYY-MM-DD hh:mm"] [-o dat_file] chk_file
+//   No option:    print a summary of the file
+//   -c column:    print the time series of a column (element or river segment, 1-based)
+//   -t time:      print all columns at a model time
+//   -o dat_file:  convert to .dat format
+//   e.g., ./chunk-dump -c 12 output/ShaleHills/ShaleHills.gw.chk
+
+// Global variables
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             resume_mode;
+int             corr_mode;
+int             spinup_mode;
+int             fixed_length;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;               // Default value
+#endif
+
+int main(int argc, char *argv[])
+{
+    int             column = 0;
+    int             tslice = BADVAL;
+    char            dat_fn[MAXSTRING] = "";
+    int             nvar;
+    int             ncol_blk;
+    int             nrec;
+    int             nblk;
+    int             nframe = 0;
+    int             ntotal = 0;
+    double         *time = NULL;
+    int64_t        *size = NULL;
+    double         *col;
+    FILE           *fp;
+    FILE           *dat_fp = NULL;
+    FILE           *idx_fp = NULL;
+    char            idx_fn[MAXSTRING];
+    int64_t         offset;
+    int             indexed = 0;
+    int             option;
+    struct optparse options;
+    struct optparse_long longopts[] = {
+        {"column",  'c', OPTPARSE_REQUIRED},
+        {"time",    't', OPTPARSE_REQUIRED},
+        {"output",  'o', OPTPARSE_REQUIRED},
+        {0, 0, 0}
+    };
+    int             i, j, k;
+
+    optparse_init(&options, argv);
+
+    while ((option = optparse_long(&options, longopts, NULL)) != -1)
+    {
+        switch (option)
+        {
+            case 'c':
+                column = atoi(options.optarg);
+                break;
+            case 't':
+                tslice = StrTime(options.optarg);
+                break;
+            case 'o':
+                strcpy(dat_fn, options.optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-c column] [-t \"YYYY-MM-DD hh:mm\"] [-o dat_file] chk_file\n", argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+
+    if (options.optind >= argc)
+    {
+        fprintf(stderr, "Usage: %s [-c column] [-t \"YYYY-MM-DD hh:mm\"] [-o dat_file] chk_file\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    verbose_mode = VL_NORMAL;
+
+    fp = pihm_fopen(argv[options.optind], "rb");
+    if (ReadChunkHeader(fp, &nvar, &ncol_blk) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error: %s is not a chunked output file.\n", argv[options.optind]);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    if (column < 0 || column > nvar)
+    {
+        pihm_printf(VL_ERROR, "Error: Column %d is out of range (1 to %d).\n", column, nvar);
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    if (dat_fn[0] != '\0')
+    {
+        dat_fp = pihm_fopen(dat_fn, "wb");
+    }
+
+    if (column == 0 && tslice != BADVAL && dat_fp == NULL)
+    {
+        size_t          len = strlen(argv[options.optind]);
+
+        // Frame index file name is the chunked output file name with .chk replaced by .idx
+        if (len > 4 && len < MAXSTRING && strcmp(argv[options.optind] + len - 4, ".chk") == 0)
+        {
+            strcpy(idx_fn, argv[options.optind]);
+            strcpy(idx_fn + len - 4, ".idx");
+            idx_fp = fopen(idx_fn, "rb");
+        }
+
+        if (idx_fp != NULL && ReadChunkIndexHeader(idx_fp) == 0 && FindChunkFrame(idx_fp, tslice, &offset) == 0 &&
+            fseek(fp, (long)offset, SEEK_SET) == 0)
+        {
+            indexed = 1;
+        }
+    }
+
+    col = (double *)malloc(ncol_blk * sizeof(double));
+
+    while (ReadChunk(fp, &nrec, &nblk, &time, &size) == 0)
+    {
+        nframe++;
+        ntotal += nrec;
+
+        col = (double *)realloc(col, (size_t)ncol_blk * nrec * sizeof(double));
+
+        if (column > 0)
+        {
+            // Decompress the block that contains the column
+            k = (column - 1) / ncol_blk;
+            if (ReadChunkBlock(fp, nrec, MIN(ncol_blk, nvar - k * ncol_blk), k, size, col) != 0)
+            {
+                pihm_printf(VL_ERROR, "Error reading frame %d.\n", nframe);
+                pihm_exit(EXIT_FAILURE);
+            }
+
+            for (i = 0; i < nrec; i++)
+            {
+                printf("%.0lf\t%.15lg\n", time[i], col[(size_t)((column - 1) % ncol_blk) * nrec + i]);
+            }
+        }
+        else if (tslice != BADVAL && tslice >= time[0] && tslice <= time[nrec - 1])
+        {
+            for (i = 0; i < nrec; i++)
+            {
+                if (roundi(time[i]) != tslice)
+                {
+                    continue;
+                }
+
+                printf("%.0lf", time[i]);
+                for (k = 0; k < nblk; k++)
+                {
+                    int             ncol = MIN(ncol_blk, nvar - k * ncol_blk);
+
+                    if (ReadChunkBlock(fp, nrec, ncol, k, size, col) != 0)
+                    {
+                        pihm_printf(VL_ERROR, "Error reading frame %d.\n", nframe);
+                        pihm_exit(EXIT_FAILURE);
+                    }
+
+                    for (j = 0; j < ncol; j++)
+                    {
+                        printf("\t%.15lg", col[(size_t)j * nrec + i]);
+                    }
+                }
+                printf("\n");
+            }
+        }
+        else if (dat_fp != NULL)
+        {
+            double         *frame;
+
+            // Decompress the whole frame and write records in .dat layout
+            frame = (double *)malloc((size_t)nrec * (nvar + 1) * sizeof(double));
+            for (k = 0; k < nblk; k++)
+            {
+                int             ncol = MIN(ncol_blk, nvar - k * ncol_blk);
+
+                if (ReadChunkBlock(fp, nrec, ncol, k, size, col) != 0)
+                {
+                    pihm_printf(VL_ERROR, "Error reading frame %d.\n", nframe);
+                    pihm_exit(EXIT_FAILURE);
+                }
+
+                for (j = 0; j < ncol; j++)
+                {
+                    for (i = 0; i < nrec; i++)
+                    {
+                        frame[(size_t)i * (nvar + 1) + k * ncol_blk + j + 1] = col[(size_t)j * nrec + i];
+                    }
+                }
+            }
+
+            for (i = 0; i < nrec; i++)
+            {
+                frame[(size_t)i * (nvar + 1)] = time[i];
+            }
+
+            fwrite(frame, sizeof(double), (size_t)nrec * (nvar + 1), dat_fp);
+            free(frame);
+        }
+
+        SkipChunk(fp, nblk, size);
+
+        if (indexed)
+        {
+            // Only the indexed frame is needed
+            break;
+        }
+    }
+
+    if (column == 0 && tslice == BADVAL)
+    {
+        printf("%s: %d variables, %d records in %d frames, %ld bytes (%.1f%% of .dat size)\n", argv[options.optind],
+            nvar, ntotal, nframe, ftell(fp),
+            100.0 * (double)ftell(fp) / ((double)ntotal * (nvar + 1) * sizeof(double)));
+    }
+
+    if (dat_fp != NULL)
+    {
+        fclose(dat_fp);
+    }
+    if (idx_fp != NULL)
+    {
+        fclose(idx_fp);
+    }
+    fclose(fp);
+    free(col);
+    free(time);
+    free(size);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+#include "pihm.h"
+
+// Converter of text meteorological forcing files (.meteo) to binary forcing files (.meteo.bin), which are memory
+// mapped by the model at startup. The binary file is used by the model when it is newer than the text file.
+//
+// Usage: meteo-convert meteo_file [bin_file]
+//   e.g., ./meteo-convert input/ShaleHills/ShaleHills.meteo
+//   writes input/ShaleHills/ShaleHills.meteo.bin
+
+// Global variables
+int             verbose_mode;
+int             debug_mode;
+int             append_mode;
+int             resume_mode;
+int             corr_mode;
+int             spinup_mode;
+int             fixed_length;
+char            project[MAXSTRING];
+int             nelem;
+int             nriver;
+#if defined(_OPENMP)
+int             nthreads = 1;               // Default value
+#endif
+
+int main(int argc, char *argv[])
+{
+    char            bin_fn[MAXSTRING];
+    forc_struct     forc;
+    int             nrec = 0;
+    int             i;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s meteo_file [bin_file]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    verbose_mode = VL_VERBOSE;
+
+    if (argc == 3)
+    {
+        strcpy(bin_fn, argv[2]);
+    }
+    else
+    {
+        sprintf(bin_fn, "%s.bin", argv[1]);
+    }
+
+    ReadMeteo(argv[1], &forc);
+
+    WriteMeteoBin(bin_fn, &forc);
+
+    for (i = 0; i < forc.nmeteo; i++)
+    {
+        nrec += forc.meteo[i].length;
+
+        free(forc.meteo[i].data[0]);
+        free(forc.meteo[i].ftime);
+        free(forc.meteo[i].data);
+    }
+    if (forc.nmeteo > 0)
+    {
+        free(forc.meteo);
+    }
+
+    pihm_printf(VL_NORMAL, "%s: %d series, %d records written to %s\n", argv[1], forc.nmeteo, nrec, bin_fn);
+
+    return EXIT_SUCCESS;
+}
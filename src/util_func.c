@@ -1,7 +1,7 @@
 #include "pihm.h"
 #include "optparse.h"
 
-void ParseCmdLineParam(int argc, char *argv[], char outputdir[])
+void ParseCmdLineParam(int argc, char *argv[], char outputdir[], char ensemble[])
 {
     int             option;
     struct optparse options;
@@ -10,8 +10,10 @@ void ParseCmdLineParam(int argc, char *argv[], char outputdir[])
         {"brief",      'b', OPTPARSE_NONE},
         {"correction", 'c', OPTPARSE_NONE},
         {"debug",      'd', OPTPARSE_NONE},
+        {"ensemble",   'e', OPTPARSE_REQUIRED},
         {"fixed",      'f', OPTPARSE_NONE},
         {"output",     'o', OPTPARSE_REQUIRED},
+        {"resume",     'r', OPTPARSE_NONE},
         {"silent",     's', OPTPARSE_NONE},
         {"version",    'V', OPTPARSE_NONE},
         {"verbose",    'v', OPTPARSE_NONE},
@@ -36,6 +38,10 @@ void ParseCmdLineParam(int argc, char *argv[], char outputdir[])
                 // Debug mode
                 debug_mode = 1;
                 break;
+            case 'e':
+                // Ensemble mode
+                strcpy(ensemble, options.optarg);
+                break;
             case 'f':
                 // Fixed length spin-up
                 fixed_length = 1;
@@ -56,6 +62,10 @@ void ParseCmdLineParam(int argc, char *argv[], char outputdir[])
                 // Append mode
                 append_mode = 1;
                 break;
+            case 'r':
+                // Resume from checkpoint
+                resume_mode = 1;
+                break;
             case 'V':
                 // Print version number
                 printf("MM-PIHM Version %s\n", VERSION);
@@ -84,9 +94,11 @@ void ParseCmdLineParam(int argc, char *argv[], char outputdir[])
     if (options.optind >= argc)
     {
         pihm_printf(VL_ERROR, "Error:You must specify the name of project!\n"
-            "Usage: ./pihm [-o output_dir] [-c] [-d] [-t] [-v] [-V]"
+            "Usage: ./pihm [-o output_dir] [-e ensemble_file] [-c] [-d] [-r] [-t] [-v] [-V]"
             " <project name>\n"
             "    -o Specify output directory\n"
+            "    -e Run ensemble members listed in ensemble file\n"
+            "    -r Resume from checkpoint in output directory\n"
             "    -b Brief mode\n"
             "    -c Correct surface elevation\n"
             "    -d Debug mode\n"
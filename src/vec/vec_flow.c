@@ -0,0 +1,296 @@
+#include "pihm.h"
+
+#define MANNING_HMIN    1.0E-30     // minimum depth in Manning's equation (m)
+
+// Batched overland and channel flow kernels, compiled with the VEC=on make option. The kernels operate on packed arrays
+// of elements, shared edges, and river segments, and are written without function calls and branches, so that they are
+// vectorized by the compiler. The cube root and logarithm used by Manning's equation and channel geometry are those
+// of vec_math.h instead of libm, thus results differ from the scalar functions in the last few digits, and can be
+// checked using rhs-bench -c
+
+// Flow depth term of Manning's equation, pow(h, 0.6666667), as used by OverLandFlow. The exponent is 2/3 + d with
+// d = 3.3e-8, thus h ^ (2/3) is corrected by exp(d * log(h)) ~ 1 + t + t ^ 2 / 2. Depth is limited to MANNING_HMIN,
+// because Newton iterations of the cube root of zero would produce subnormal numbers, which are very slow. Callers
+// multiply the result by depth or cross-sectional area, which are zero for dry elements and river segments
+static inline double VecManning(double h)
+{
+    const double    D = 0.6666667 - 2.0 / 3.0;
+    double          c;
+    double          t;
+
+    // Equivalent to MAX(h, MANNING_HMIN), and exact for depths above 1e-14 m
+    h = 0.5 * ((h + MANNING_HMIN) + fabs(h - MANNING_HMIN));
+
+    c = VecCbrt(h);
+    t = D * VecLog(h);
+
+    return c * c * (1.0 + t * (1.0 + 0.5 * t));
+}
+
+// Cross-sectional area and wetted perimeter of river channels, as in RiverCrossSectArea and RiverPerim. All channel
+// shapes are evaluated so that the shape of each river segment is selected without branching. Shape is assumed to be
+// valid, which is checked at initialization
+static inline void VecRiverGeom(int order, double depth, double coeff, double *area, double *perim)
+{
+    double          sqrt_c, c3;
+    double          sqrt_d, c3_d;
+    double          a2, a4;
+    double          area_rect, area_tri, area_quad, area_cubic;
+    double          perim_rect, perim_tri, perim_quad, perim_cubic;
+    double          w_rect, w_tri, w_quad, w_cubic;
+
+    depth = 0.5 * (depth + fabs(depth));         // MAX(depth, 0.0) without branching
+    sqrt_d = sqrt(depth);
+    sqrt_c = sqrt(coeff);
+    c3 = VecCbrt(coeff);
+    c3_d = VecCbrt(depth);
+
+    area_rect = depth * coeff;
+    perim_rect = 2.0 * depth + coeff;
+
+    area_tri = depth * depth / coeff;
+    perim_tri = 2.0 * depth * sqrt(1.0 + coeff * coeff) / coeff;
+
+    a2 = 1.0 + 4.0 * coeff * depth;
+    area_quad = 4.0 * depth * sqrt_d / (3.0 * sqrt_c);
+    perim_quad = sqrt(depth * a2 / coeff) + VecLog(2.0 * sqrt_c * sqrt_d + sqrt(a2)) / (2.0 * coeff);
+
+    a4 = 1.0 + 9.0 * c3 * c3 * depth;
+    area_cubic = 3.0 * depth * c3_d / (2.0 * c3);
+    perim_cubic = 2.0 * (sqrt(depth * a4) / 3.0 + VecLog(3.0 * c3 * sqrt_d + sqrt(a4)) / (9.0 * c3));
+
+    // Shapes are selected using weights of zero and one. Conditional expressions would allow the compiler to move the
+    // evaluation of each shape into a branch
+    w_rect = (double)(order == RECTANGLE);
+    w_tri = (double)(order == TRIANGLE);
+    w_quad = (double)(order == QUADRATIC);
+    w_cubic = (double)(order == CUBIC);
+
+    *area = w_rect * area_rect + w_tri * area_tri + w_quad * area_quad + w_cubic * area_cubic;
+    *perim = w_rect * perim_rect + w_tri * perim_tri + w_quad * perim_quad + w_cubic * perim_cubic;
+}
+
+void InitHydroVec(const river_struct river[], hydro_struct *hydro)
+{
+    int             i;
+
+    hydro->ovl_conv = (double *)calloc(nelem, sizeof(double));
+    hydro->ovl_flux = (double *)calloc(2 * hydro->nedge_ovl, sizeof(double));
+    hydro->river_down = (int *)malloc(nriver * sizeof(int));
+    hydro->bank_elem = (int *)malloc(2 * nriver * sizeof(int));
+    hydro->river_order = (int *)malloc(nriver * sizeof(int));
+    hydro->river_coeff = (double *)malloc(nriver * sizeof(double));
+    hydro->river_length = (double *)malloc(nriver * sizeof(double));
+    hydro->river_zbed = (double *)malloc(nriver * sizeof(double));
+    hydro->river_zmax = (double *)malloc(nriver * sizeof(double));
+    hydro->river_rough = (double *)malloc(nriver * sizeof(double));
+    hydro->river_cwr = (double *)malloc(nriver * sizeof(double));
+    hydro->river_stage = (double *)calloc(nriver, sizeof(double));
+    hydro->river_area = (double *)calloc(nriver, sizeof(double));
+    hydro->river_perim = (double *)calloc(nriver, sizeof(double));
+    hydro->river_flux = (double *)calloc(nriver, sizeof(double));
+    hydro->bank_flux = (double *)calloc(2 * nriver, sizeof(double));
+
+    for (i = 0; i < nriver; i++)
+    {
+        // Outlet segments point to themselves so that the channel flow kernel does not need to branch. Their channel
+        // flows are not used
+        hydro->river_down[i] = (river[i].down > 0) ? river[i].down - 1 : i;
+        hydro->bank_elem[2 * i] = river[i].left - 1;
+        hydro->bank_elem[2 * i + 1] = river[i].right - 1;
+        hydro->river_order[i] = river[i].shp.intrpl_ord;
+        hydro->river_coeff[i] = river[i].shp.coeff;
+        hydro->river_length[i] = river[i].shp.length;
+        hydro->river_zbed[i] = river[i].topo.zbed;
+        hydro->river_zmax[i] = river[i].topo.zmax;
+        hydro->river_rough[i] = river[i].matl.rough;
+        hydro->river_cwr[i] = river[i].matl.cwr;
+    }
+}
+
+void FreeHydroVec(hydro_struct *hydro)
+{
+    free(hydro->ovl_conv);
+    free(hydro->ovl_flux);
+    free(hydro->river_down);
+    free(hydro->bank_elem);
+    free(hydro->river_order);
+    free(hydro->river_coeff);
+    free(hydro->river_length);
+    free(hydro->river_zbed);
+    free(hydro->river_zmax);
+    free(hydro->river_rough);
+    free(hydro->river_cwr);
+    free(hydro->river_stage);
+    free(hydro->river_area);
+    free(hydro->river_perim);
+    free(hydro->river_flux);
+    free(hydro->bank_flux);
+}
+
+// Overland fluxes through shared edges, as in OvlFlowEdge. Cross-sectional area times the flow depth term of Manning's
+// equation only depends on the upstream element, and is evaluated once for each element. Arrays are accessed through
+// local pointers so that they are not reloaded from the hydro structure after each store
+void OvlFlowVec(hydro_struct *hydro)
+{
+    const int      *edge_ind = hydro->edge_ind;
+    const int      *nabr = hydro->nabr;
+    const double   *dist_nabr = hydro->dist_nabr;
+    const double   *edge = hydro->edge;
+    const double   *zmax = hydro->zmax;
+    const double   *rough = hydro->rough;
+    const double   *surfh = hydro->surfh;
+    const double   *sf = hydro->sf;
+    double         *ovl_conv = hydro->ovl_conv;
+    double         *ovl_flux = hydro->ovl_flux;
+    int             nedge_ovl = hydro->nedge_ovl;
+    int             n = nelem;
+    int             i, k;
+
+#if defined(_OPENMP)
+# pragma omp parallel for simd
+#else
+# pragma omp simd
+#endif
+    for (i = 0; i < n; i++)
+    {
+        double          h;
+
+        // Equivalent to MAX(surfh - DEPRSTG, 0.0). The conditional expression would cause the compiler to branch
+        h = 0.5 * ((surfh[i] - DEPRSTG) + fabs(surfh[i] - DEPRSTG));
+        ovl_conv[i] = h * VecManning(h);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for simd
+#else
+# pragma omp simd
+#endif
+    for (k = 0; k < nedge_ovl; k++)
+    {
+        int             ind = edge_ind[2 * k];
+        int             i = ind / NUM_EDGE;
+        int             j = nabr[ind];
+        double          diff_h;
+        double          grad_h;
+        double          avg_sf;
+        double          denom;
+        double          conv_i, conv_j;
+
+        diff_h = (surfh[i] + zmax[i]) - (surfh[j] + zmax[j]);
+        grad_h = diff_h / dist_nabr[ind];
+        avg_sf = MAX(0.5 * (sf[i] + sf[j]), GRADMIN);
+        denom = sqrt(avg_sf) * 0.5 * (rough[i] + rough[j]);
+
+        conv_i = ovl_conv[i];
+        conv_j = ovl_conv[j];
+
+        // Both directions use the water depth of the upstream element. For zero head difference, each element sees the
+        // water depth of the other one
+        ovl_flux[2 * k] = edge[ind] * ((diff_h > 0.0) ? conv_i : conv_j) * MAX(grad_h, GRADMIN) / denom;
+        ovl_flux[2 * k + 1] = edge[ind] * ((diff_h < 0.0) ? conv_j : conv_i) * MAX(-grad_h, GRADMIN) / denom;
+    }
+}
+
+// Channel geometry, channel flows between river segments (ChannelFlowRiverToRiver), and overland flows between river
+// segments and bank elements (OvlFlowElemToRiver)
+void RiverFlowVec(hydro_struct *hydro)
+{
+    const int      *river_down = hydro->river_down;
+    const int      *bank_elem = hydro->bank_elem;
+    const int      *river_order = hydro->river_order;
+    const double   *river_coeff = hydro->river_coeff;
+    const double   *river_length = hydro->river_length;
+    const double   *river_zbed = hydro->river_zbed;
+    const double   *river_zmax = hydro->river_zmax;
+    const double   *river_rough = hydro->river_rough;
+    const double   *river_cwr = hydro->river_cwr;
+    const double   *river_stage = hydro->river_stage;
+    const double   *zmax = hydro->zmax;
+    const double   *surfh = hydro->surfh;
+    double         *river_area = hydro->river_area;
+    double         *river_perim = hydro->river_perim;
+    double         *river_flux = hydro->river_flux;
+    double         *bank_flux = hydro->bank_flux;
+    int             n = nriver;
+    int             i, j;
+
+#if defined(_OPENMP)
+# pragma omp parallel for simd
+#else
+# pragma omp simd
+#endif
+    for (i = 0; i < n; i++)
+    {
+        VecRiverGeom(river_order[i], river_stage[i], river_coeff[i], &river_area[i], &river_perim[i]);
+    }
+
+#if defined(_OPENMP)
+# pragma omp parallel for simd
+#else
+# pragma omp simd
+#endif
+    for (i = 0; i < n; i++)
+    {
+        int             down = river_down[i];
+        double          avg_perim;
+        double          avg_rough;
+        double          avg_crossa;
+        double          distance;
+        double          grad_h;
+        double          avg_sf;
+        double          avg_h;
+
+        avg_perim = 0.5 * (river_perim[i] + river_perim[down]);
+        avg_rough = 0.5 * (river_rough[i] + river_rough[down]);
+        distance = 0.5 * (river_length[i] + river_length[down]);
+
+        grad_h = ((river_stage[i] + river_zbed[i]) - (river_stage[down] + river_zbed[down])) / distance;
+        avg_sf = (grad_h > 0.0) ? grad_h : RIVGRADMIN;
+        avg_crossa = 0.5 * (river_area[i] + river_area[down]);
+        // Cross-sectional area is zero when wetted perimeter is zero
+        avg_h = avg_crossa / MAX(avg_perim, DBL_MIN);
+
+        river_flux[i] = river_area[i] * VecManning(avg_h) * grad_h / (sqrt(avg_sf) * avg_rough);
+    }
+
+    // Weir equations of the two directions (Panday and Hyakorn 2004 AWR Eqs. (23) and (24)) only differ in sign, using
+    // the higher and lower water levels of the two sides
+#if defined(_OPENMP)
+# pragma omp parallel for simd
+#else
+# pragma omp simd
+#endif
+    for (j = 0; j < 2 * n; j++)
+    {
+        int             i = j / 2;
+        int             bank = MAX(bank_elem[j], 0);
+        double          z_bank;
+        double          bank_h;
+        double          river_h;
+        double          high_h, low_h;
+        double          head, diff_h;
+        double          coeff;
+        double          flux;
+
+        z_bank = MAX(river_zmax[i], zmax[bank]);
+        bank_h = zmax[bank] + surfh[bank];
+        river_h = river_zbed[i] + river_stage[i];
+        high_h = MAX(river_h, bank_h);
+        low_h = MIN(river_h, bank_h);
+
+        coeff = river_cwr[i] * 2.0 * sqrt(2.0 * GRAV) * river_length[i] / 3.0;
+
+        // Submerged weir if the lower side is above bank, otherwise free-flowing weir. Heads are clamped using fabs
+        // because GCC evaluates square roots of both branches of conditional expressions
+        head = high_h - z_bank;
+        head = 0.5 * (head + fabs(head));
+        diff_h = high_h - MAX(low_h, z_bank);
+        diff_h = 0.5 * (diff_h + fabs(diff_h));
+
+        flux = coeff * sqrt(diff_h) * head;
+
+        bank_flux[j] = (bank_elem[j] < 0) ? 0.0 :
+            ((river_h > bank_h) ? flux : ((surfh[bank] > DEPRSTG) ? -flux : 0.0));
+    }
+}
@@ -0,0 +1,316 @@
+#include "pihm.h"
+
+#define NOAH_BLK        8           // number of elements in a block of the batched soil moisture solver
+
+// Batched Noah soil moisture solver, compiled with the VEC=on make option. Elements are processed in blocks of NOAH_BLK
+// elements, and soil layer variables of each block are packed into arrays of [MAXLYR][NOAH_BLK], so that soil water
+// diffusivity and hydraulic conductivity (WDfCnd), the tridiagonal systems (SRT and SStep), and their solutions
+// (Rosr12) are computed for all elements of a block together, and are vectorized over elements. Layers below the bottom
+// layer of an element are padded with identity equations, thus all systems have MAXLYR equations. Power functions are
+// those of vec_math.h, thus results differ from SmFlx in the last few digits
+
+// Soil water diffusivity and hydraulic conductivity, as in WDfCnd without the frozen soil correction. van Genuchten
+// functions of the same saturation share one logarithm
+static inline void VecWDfCnd(double smc, double smcmax, double smcmin, double alpha, double beta, double ksatv,
+    double *wdf, double *wcnd)
+{
+    double          expon;
+    double          factr2;
+    double          log_satn;
+    double          satkfunc;
+    double          dpsidsm;
+
+    // Factr2 should avoid to be 0 or 1
+    factr2 = VecClamp((smc - smcmin) / (smcmax - smcmin), 0.0 + 5.0E-4, 1.0 - 5.0E-4);
+
+    expon = 1.0 - 1.0 / beta;
+    log_satn = VecLog(factr2);
+
+    satkfunc = 1.0 - VecPow(1.0 - VecExp(log_satn / expon), expon);
+    satkfunc = sqrt(factr2) * satkfunc * satkfunc;
+
+    dpsidsm = (1.0 - expon) / alpha / expon / (smcmax - smcmin) *
+        VecPow(VecExp(-log_satn / expon) - 1.0, -expon) * VecExp(-(1.0 / expon + 1.0) * log_satn);
+
+    *wcnd = ksatv * satkfunc;
+    *wdf = *wcnd * dpsidsm;
+}
+
+// Frozen soil correction of soil water diffusivity, as in WDfCnd, which uses the diffusivity of the minimum of factr1
+// and factr2 weighted by the maximum ice content of the soil column
+static inline double VecWDfFrz(double smc, double sicemax, double smcmax, double smcmin, double alpha, double beta,
+    double ksatv, double wdf)
+{
+    double          factr1;
+    double          vkwgt;
+    double          wdf1, wcnd1;
+
+    // Equivalent to MIN(0.05 / (smcmax - smcmin), factr2)
+    factr1 = VecClamp((smc - smcmin) / (smcmax - smcmin), 0.0 + 5.0E-4,
+        VecClamp(0.05 / (smcmax - smcmin), 0.0, 1.0 - 5.0E-4));
+
+    VecWDfCnd(smcmin + factr1 * (smcmax - smcmin), smcmax, smcmin, alpha, beta, ksatv, &wdf1, &wcnd1);
+
+    vkwgt = 1.0 / (1.0 + 500.0 * sicemax * 500.0 * sicemax * 500.0 * sicemax);
+
+    return vkwgt * wdf + (1.0 - vkwgt) * wdf1;
+}
+
+// Solve soil moisture of a block of nblk (<= NOAH_BLK) elements. Lanes of the block beyond nblk repeat the first
+// element so that all lanes are valid, and their results are discarded
+static void SmFlxBlk(double dt, int nblk, elem_struct elem[])
+{
+    int             active[NOAH_BLK];
+    int             frozen = 0;
+    double          smcmax[NOAH_BLK], smcmin[NOAH_BLK];
+    double          alpha[NOAH_BLK], beta[NOAH_BLK];
+    double          ksatv[NOAH_BLK];
+    double          sicemax[NOAH_BLK];
+    double          top_flux[NOAH_BLK];                 // infiltration minus direct evaporation (m s-1)
+    double          nbottom[NOAH_BLK];                  // index of bottom layer, stored as double so that
+                                                        // comparisons have the width of other variables
+    double          ztop[NOAH_BLK];                     // depth of the top of the current layer (m)
+    double          zsoil[MAXLYR][NOAH_BLK];
+    double          swc[MAXLYR][NOAH_BLK];
+    double          sice[MAXLYR][NOAH_BLK];
+    double          sink[MAXLYR][NOAH_BLK];             // transpiration and lateral runoff from layers (m s-1)
+    double          wdf[MAXLYR][NOAH_BLK];              // diffusivity at the bottom of layers
+    double          wcnd[MAXLYR][NOAH_BLK];             // conductivity at the bottom of layers
+    double          dsmdz[MAXLYR][NOAH_BLK];            // moisture gradient at the bottom of layers
+    double          ddz[MAXLYR][NOAH_BLK];
+    double          ai[MAXLYR][NOAH_BLK], bi[MAXLYR][NOAH_BLK], ci[MAXLYR][NOAH_BLK];
+    double          rhstt[MAXLYR][NOAH_BLK];
+    double          p[MAXLYR][NOAH_BLK], delta[MAXLYR][NOAH_BLK];
+    int             b, kz;
+
+    // Pack soil layer variables
+    for (b = 0; b < NOAH_BLK; b++)
+    {
+        const elem_struct *elem_b = &elem[(b < nblk) ? b : 0];
+        const int       nlayers = elem_b->ps.nlayers;
+
+        active[b] = (b < nblk && elem_b->ps.nwtbl != 0);
+
+        smcmax[b] = elem_b->soil.smcmax;
+        smcmin[b] = elem_b->soil.smcmin;
+        alpha[b] = elem_b->soil.alpha;
+        beta[b] = elem_b->soil.beta;
+        ksatv[b] = elem_b->soil.ksatv;
+        top_flux[b] = elem_b->wf.eqv_infil - elem_b->wf.edir;
+        nbottom[b] = (double)(nlayers - 1);
+        sicemax[b] = 0.0;
+
+        for (kz = 0; kz < nlayers; kz++)
+        {
+            zsoil[kz][b] = elem_b->ps.zsoil[kz];
+            swc[kz][b] = elem_b->ws.swc[kz];
+            sice[kz][b] = elem_b->ws.smc[kz] - elem_b->ws.swc[kz];
+            sink[kz][b] = elem_b->wf.et[kz] + elem_b->wf.runoff2_lyr[kz];
+
+            sicemax[b] = MAX(sice[kz][b], sicemax[b]);
+        }
+
+        // Pad layers below the bottom layer, which always exists
+        for (kz = MAX(nlayers, 1); kz < MAXLYR; kz++)
+        {
+            zsoil[kz][b] = zsoil[kz - 1][b] - 1.0;
+            swc[kz][b] = swc[kz - 1][b];
+            sice[kz][b] = 0.0;
+            sink[kz][b] = 0.0;
+        }
+
+        frozen = (active[b] && sicemax[b] > 0.0) ? 1 : frozen;
+    }
+
+    // Soil water diffusivity, conductivity, and moisture gradient at the bottom of each layer, which are zero at the
+    // bottom of the bottom layer
+    for (b = 0; b < NOAH_BLK; b++)
+    {
+        ztop[b] = 0.0;
+    }
+
+    for (kz = 0; kz < MAXLYR - 1; kz++)
+    {
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+        for (b = 0; b < NOAH_BLK; b++)
+        {
+            double          denom;
+            double          wdf_b, wcnd_b;
+            double          above_bottom;
+
+            // Weights of zero and one are used instead of conditional expressions, which would allow the compiler to
+            // move the evaluation of WDfCnd into a branch
+            above_bottom = (double)((double)kz < nbottom[b]);
+            denom = ztop[b] - zsoil[kz + 1][b];
+
+            VecWDfCnd(swc[kz][b], smcmax[b], smcmin[b], alpha[b], beta[b], ksatv[b], &wdf_b, &wcnd_b);
+
+            wdf[kz][b] = above_bottom * wdf_b;
+            wcnd[kz][b] = above_bottom * wcnd_b;
+            dsmdz[kz][b] = above_bottom * (swc[kz][b] - swc[kz + 1][b]) / (denom * 0.5);
+            ddz[kz][b] = 2.0 / denom;
+
+            ztop[b] = zsoil[kz][b];
+        }
+
+        // Frozen soil correction is only computed for blocks with ice
+        if (frozen)
+        {
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+            for (b = 0; b < NOAH_BLK; b++)
+            {
+                wdf[kz][b] = (double)((double)kz < nbottom[b]) *
+                    VecWDfFrz(swc[kz][b], sicemax[b], smcmax[b], smcmin[b], alpha[b], beta[b], ksatv[b], wdf[kz][b]);
+            }
+        }
+    }
+
+    // Matrix coefficients of the soil moisture tendency equations, as in SRT. Padded layers have zero coefficients and
+    // right-hand sides, i.e., identity equations
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+    for (b = 0; b < NOAH_BLK; b++)
+    {
+        ai[0][b] = 0.0;
+        bi[0][b] = wdf[0][b] * ddz[0][b] / (-zsoil[0][b]);
+        ci[0][b] = -bi[0][b];
+        rhstt[0][b] = (wdf[0][b] * dsmdz[0][b] + wcnd[0][b] - top_flux[b] + sink[0][b]) / zsoil[0][b];
+
+        wdf[MAXLYR - 1][b] = 0.0;
+        wcnd[MAXLYR - 1][b] = 0.0;
+        dsmdz[MAXLYR - 1][b] = 0.0;
+        ddz[MAXLYR - 1][b] = 0.0;
+    }
+
+    for (kz = 1; kz < MAXLYR; kz++)
+    {
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+        for (b = 0; b < NOAH_BLK; b++)
+        {
+            double          denom2;
+
+            denom2 = zsoil[kz - 1][b] - zsoil[kz][b];
+
+            ci[kz][b] = -wdf[kz][b] * ddz[kz][b] / denom2;
+            rhstt[kz][b] = (wdf[kz][b] * dsmdz[kz][b] + wcnd[kz][b] - wdf[kz - 1][b] * dsmdz[kz - 1][b] -
+                wcnd[kz - 1][b] + sink[kz][b]) / (-denom2);
+            ai[kz][b] = -wdf[kz - 1][b] * ddz[kz - 1][b] / denom2;
+            bi[kz][b] = -(ai[kz][b] + ci[kz][b]);
+        }
+    }
+
+    // Solve the tridiagonal systems in the "amount" form of SStep (Rosr12)
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+    for (b = 0; b < NOAH_BLK; b++)
+    {
+        p[0][b] = -ci[0][b] * dt / (1.0 + bi[0][b] * dt);
+        delta[0][b] = rhstt[0][b] * dt / (1.0 + bi[0][b] * dt);
+    }
+
+    for (kz = 1; kz < MAXLYR; kz++)
+    {
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+        for (b = 0; b < NOAH_BLK; b++)
+        {
+            double          denom;
+
+            denom = 1.0 + bi[kz][b] * dt + ai[kz][b] * dt * p[kz - 1][b];
+
+            p[kz][b] = -ci[kz][b] * dt / denom;
+            delta[kz][b] = (rhstt[kz][b] * dt - ai[kz][b] * dt * delta[kz - 1][b]) / denom;
+        }
+    }
+
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+    for (b = 0; b < NOAH_BLK; b++)
+    {
+        p[MAXLYR - 1][b] = delta[MAXLYR - 1][b];
+    }
+
+    for (kz = MAXLYR - 2; kz >= 0; kz--)
+    {
+#if defined(_OPENMP)
+# pragma omp simd
+#endif
+        for (b = 0; b < NOAH_BLK; b++)
+        {
+            p[kz][b] = p[kz][b] * p[kz + 1][b] + delta[kz][b];
+        }
+    }
+
+    // Unpack and update soil moisture of each element
+    for (b = 0; b < nblk; b++)
+    {
+        soil_struct    *soil = &elem[b].soil;
+        phystate_struct *ps = &elem[b].ps;
+        wstate_struct  *ws = &elem[b].ws;
+        wflux_struct   *wf = &elem[b].wf;
+        double          sice_b[MAXLYR];
+        double          sh2o0[MAXLYR];
+
+        for (kz = 0; kz < ps->nlayers; kz++)
+        {
+            sice_b[kz] = sice[kz][b];
+        }
+
+        if (!active[b])
+        {
+            // Special case: all soil layers are saturated
+            for (kz = 0; kz < ps->nlayers; kz++)
+            {
+                ws->smc[kz] = soil->smcmax;
+                ws->swc[kz] = ws->smc[kz] - sice_b[kz];
+            }
+
+            continue;
+        }
+
+        ps->fcr = FrzFcr(sice_b, ps);
+
+        for (kz = 0; kz < ps->nlayers; kz++)
+        {
+            sh2o0[kz] = ws->swc[kz];
+            ws->swc[kz] += p[kz][b];
+            wf->smflx[kz] = 0.0;
+        }
+
+        AdjustSmcProfile(dt, sice_b, soil, ps, ws, wf);
+
+        // Calculate soil moisture flux within soil layers
+        for (kz = ps->nlayers - 1; kz > 0; kz--)
+        {
+            // Positive smflx[k] is flux out of soil layer k
+            wf->smflx[kz - 1] = (ws->swc[kz] - sh2o0[kz]) * ps->soil_depth[kz] / dt + wf->runoff2_lyr[kz] +
+                wf->et[kz] + wf->smflx[kz];
+        }
+    }
+}
+
+void SmFlxVec(double dt, elem_struct elem[])
+{
+    int             nblk;
+    int             k;
+
+    nblk = (nelem + NOAH_BLK - 1) / NOAH_BLK;
+
+#if defined(_OPENMP)
+# pragma omp parallel for
+#endif
+    for (k = 0; k < nblk; k++)
+    {
+        SmFlxBlk(dt, MIN(NOAH_BLK, nelem - k * NOAH_BLK), &elem[k * NOAH_BLK]);
+    }
+}
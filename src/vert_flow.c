@@ -97,7 +97,7 @@ double Infil(double dt, const topo_struct *topo, const soil_struct *soil, const
             satn = MIN(satn, 1.0);
             satn = MAX(satn, SATMIN);
 
-            psi_u = Psi(satn, soil->alpha, soil->beta);
+            VgFunc(satn, soil, &satkfunc, &psi_u);
             // Note: for psi calculation using van Genuchten relation, cutting the psi-sat tail at small saturation can
             // be performed for computational advantage. If you do not want to perform this, comment the statement that
             // follows
@@ -107,8 +107,6 @@ double Infil(double dt, const topo_struct *topo, const soil_struct *soil, const
             dh_dz = (ws->surfh + topo->zmax - h_u) / (0.5 * (ws->surfh + soil->dinf));
             dh_dz = (ws->surfh <= 0.0 && dh_dz > 0.0) ?  0.0 : dh_dz;
 
-            satkfunc = KrFunc(soil->beta, satn);
-
             kinf = EffKinf(dh_dz, satkfunc, satn, appl_rate, ws->surfh, soil);
 
             infil = kinf * dh_dz;
@@ -150,9 +148,7 @@ double Recharge(const soil_struct *soil, const wstate_struct *ws, const wflux_st
         satn = MIN(satn, 1.0);
         satn = MAX(satn, SATMIN);
 
-        satkfunc = KrFunc(soil->beta, satn);
-
-        psi_u = Psi(satn, soil->alpha, soil->beta);
+        VgFunc(satn, soil, &satkfunc, &psi_u);
 
         dh_dz = (0.5 * deficit + psi_u) / (0.5 * (deficit + ws->gw));
 
@@ -265,12 +261,20 @@ double Psi(double satn, double alpha, double beta)
     return -pow(pow(1.0 / satn, beta / (beta - 1.0)) - 1.0, 1.0 / beta) / alpha;
 }
 
+// Suction head as a function of saturation deficit (1 - satn), which does not lose precision when saturation is close
+// to 1
+double PsiDeficit(double deficit, double alpha, double beta)
+{
+    return -pow(expm1(-beta / (beta - 1.0) * log1p(-deficit)), 1.0 / beta) / alpha;
+}
+
 #if defined(_DGW_)
 // Hydrology for deep zone
 double GeolInfil(const topo_struct *topo, const soil_struct *soil, const soil_struct *geol, const wstate_struct *ws)
 {
     double          deficit;
     double          satn;
+    double          satkfunc;
     double          psi_u;
     double          h_u;
     double          dh_dz;
@@ -297,7 +301,7 @@ double GeolInfil(const topo_struct *topo, const soil_struct *soil, const soil_st
             satn = MIN(satn, 1.0);
             satn = MAX(satn, SATMIN);
 
-            psi_u = Psi(satn, geol->alpha, geol->beta);
+            VgFunc(satn, geol, &satkfunc, &psi_u);
             psi_u = MAX(psi_u, PSIMIN);
 
             h_u = psi_u + topo->zmin - 0.5 * deficit;
@@ -307,8 +311,8 @@ double GeolInfil(const topo_struct *topo, const soil_struct *soil, const soil_st
             ksoil = (soil->dmac >= soil->depth) ?
                 soil->kmacv * soil->areafh + soil->ksatv * (1.0 - soil->areafh) : soil->ksatv;
             kgeol = (geol->dmac > 0.0) ?
-                geol->ksatv * (1.0 - geol->areafh) * KrFunc(geol->beta, satn) + geol->kmacv * geol->areafh *
-                KrFunc(geol->beta, satn) : geol->ksatv * KrFunc(geol->beta, satn);
+                geol->ksatv * (1.0 - geol->areafh) * satkfunc + geol->kmacv * geol->areafh * satkfunc :
+                geol->ksatv * satkfunc;
 
             kavg = (ws->gw + deficit) / (ws->gw / ksoil + deficit / kgeol);
             infil = kavg * dh_dz;
@@ -322,6 +326,7 @@ double GeolRecharge(const soil_struct *geol, const wstate_struct *ws, const wflu
 {
     double          deficit;
     double          satn;
+    double          satkfunc;
     double          psi_u;
     double          dh_dz;
     double          kavg;
@@ -339,12 +344,12 @@ double GeolRecharge(const soil_struct *geol, const wstate_struct *ws, const wflu
         satn = MIN(satn, 1.0);
         satn = MAX(satn, SATMIN);
 
-        psi_u = Psi(satn, geol->alpha, geol->beta);
+        VgFunc(satn, geol, &satkfunc, &psi_u);
         psi_u = MAX(psi_u, PSIMIN);
 
         dh_dz = (0.5 * deficit + psi_u) / (0.5 * (deficit + ws->gw_geol));
 
-        kavg = AvgKv(ws->gw_geol, KrFunc(geol->beta, satn), geol);
+        kavg = AvgKv(ws->gw_geol, satkfunc, geol);
 
         recharge = kavg * dh_dz;
 
@@ -0,0 +1,265 @@
+#include "pihm.h"
+
+// Writers of all model instances, whose pending records are written if the model exits with an error
+static writer_struct *active_writers = NULL;
+#if !defined(_WIN32) && !defined(_WIN64)
+static pthread_mutex_t active_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void InitWriter(int nprint, int format, varctrl_struct varctrl[], writer_struct *writer)
+{
+    int             i;
+
+    for (i = 0; i < nprint; i++)
+    {
+        // Each record contains model time followed by all variables, the same layout as in .dat files
+        varctrl[i].maxrec = WRITER_BATCH_SIZE / ((varctrl[i].nvar + 1) * (int)sizeof(double));
+        varctrl[i].maxrec = MAX(varctrl[i].maxrec, 1);
+        varctrl[i].nrec = 0;
+        varctrl[i].recbuf = (double *)malloc((size_t)varctrl[i].maxrec * (varctrl[i].nvar + 1) * sizeof(double));
+        if (varctrl[i].recbuf == NULL)
+        {
+            pihm_printf(VL_ERROR, "Error allocating memory for output buffers.\n");
+            pihm_exit(EXIT_FAILURE);
+        }
+    }
+
+    writer->head = 0;
+    writer->count = 0;
+    writer->done = 0;
+    writer->busy = 0;
+    writer->format = format;
+    writer->nprint = nprint;
+    writer->varctrl = varctrl;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_init(&writer->mutex, NULL);
+    pthread_cond_init(&writer->not_empty, NULL);
+    pthread_cond_init(&writer->not_full, NULL);
+
+    if (pthread_create(&writer->thread, NULL, WriterThread, writer) != 0)
+    {
+        pihm_printf(VL_ERROR, "Error creating output writer thread.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+    pthread_mutex_lock(&active_mutex);
+    writer->owner = pthread_self();
+#endif
+    writer->next = active_writers;
+    active_writers = writer;
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&active_mutex);
+#endif
+
+    SetExitHook(SyncOwnedWriters);
+}
+
+// Make the calling thread the owner of a writer, i.e., the thread that advances its model instance and fills its record
+// batches. Ensemble members are advanced by different threads
+void ClaimWriter(writer_struct *writer)
+{
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (!pthread_equal(writer->owner, pthread_self()))
+    {
+        pthread_mutex_lock(&active_mutex);
+        writer->owner = pthread_self();
+        pthread_mutex_unlock(&active_mutex);
+    }
+#endif
+}
+
+// Hand the batch of records of an output variable to the writer thread, and start a new batch
+void SubmitRecords(writer_struct *writer, varctrl_struct *varctrl)
+{
+    wrreq_struct    req;
+
+    req.fp = varctrl->datfile;
+    req.idx_fp = varctrl->idxfile;
+    req.data = varctrl->recbuf;
+    req.size = (size_t)varctrl->nrec * (varctrl->nvar + 1);
+    req.nvar = varctrl->nvar;
+
+    varctrl->nrec = 0;
+    varctrl->recbuf = (double *)malloc((size_t)varctrl->maxrec * (varctrl->nvar + 1) * sizeof(double));
+    if (varctrl->recbuf == NULL)
+    {
+        pihm_printf(VL_ERROR, "Error allocating memory for output buffers.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    WriteRecords(writer->format, &req);
+#else
+    pthread_mutex_lock(&writer->mutex);
+    while (writer->count == WRITER_QUEUE_LEN)
+    {
+        pthread_cond_wait(&writer->not_full, &writer->mutex);
+    }
+
+    writer->queue[(writer->head + writer->count) % WRITER_QUEUE_LEN] = req;
+    writer->count++;
+
+    pthread_cond_signal(&writer->not_empty);
+    pthread_mutex_unlock(&writer->mutex);
+#endif
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void *WriterThread(void *arg)
+{
+    writer_struct  *writer = (writer_struct *)arg;
+
+    while (1)
+    {
+        wrreq_struct    req;
+
+        pthread_mutex_lock(&writer->mutex);
+        while (writer->count == 0 && !writer->done)
+        {
+            pthread_cond_wait(&writer->not_empty, &writer->mutex);
+        }
+
+        if (writer->count == 0)
+        {
+            // Queue is drained and no more requests will be submitted
+            pthread_mutex_unlock(&writer->mutex);
+            break;
+        }
+
+        req = writer->queue[writer->head];
+        writer->head = (writer->head + 1) % WRITER_QUEUE_LEN;
+        writer->count--;
+        writer->busy = 1;
+
+        pthread_cond_signal(&writer->not_full);
+        pthread_mutex_unlock(&writer->mutex);
+
+        WriteRecords(writer->format, &req);
+
+        pthread_mutex_lock(&writer->mutex);
+        writer->busy = 0;
+        pthread_cond_broadcast(&writer->not_full);
+        pthread_mutex_unlock(&writer->mutex);
+    }
+
+    return NULL;
+}
+#endif
+
+void WriteRecords(int format, wrreq_struct *req)
+{
+    if (format == CHUNK_OUTPUT)
+    {
+        // Compression is performed by the writer thread
+        WriteChunk(req->nvar, (int)(req->size / (req->nvar + 1)), req->data, req->fp, req->idx_fp);
+    }
+    else if (fwrite(req->data, sizeof(double), req->size, req->fp) != req->size)
+    {
+        pihm_printf(VL_ERROR, "Error writing binary output files.\n");
+        pihm_exit(EXIT_FAILURE);
+    }
+    fflush(req->fp);
+
+    free(req->data);
+}
+
+// Submit all pending records and wait until the writer thread has written them, so that binary output files are
+// complete up to the current model step. The writer thread keeps running
+void SyncWriter(int nprint, varctrl_struct varctrl[], writer_struct *writer)
+{
+    int             i;
+
+    for (i = 0; i < nprint; i++)
+    {
+        if (varctrl[i].nrec > 0)
+        {
+            SubmitRecords(writer, &varctrl[i]);
+        }
+    }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&writer->mutex);
+    while (writer->count > 0 || writer->busy)
+    {
+        pthread_cond_wait(&writer->not_full, &writer->mutex);
+    }
+    pthread_mutex_unlock(&writer->mutex);
+#endif
+}
+
+// Submit all pending records, wait for the writer thread to write them, and stop the writer thread. Must be called
+// before binary output files are closed
+void FlushWriter(int nprint, varctrl_struct varctrl[], writer_struct *writer)
+{
+    int             i;
+    writer_struct **ptr;
+
+    // Remove writer from the active writers
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&active_mutex);
+#endif
+    for (ptr = &active_writers; *ptr != NULL; ptr = &(*ptr)->next)
+    {
+        if (*ptr == writer)
+        {
+            *ptr = writer->next;
+            break;
+        }
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&active_mutex);
+#endif
+
+    for (i = 0; i < nprint; i++)
+    {
+        if (varctrl[i].nrec > 0)
+        {
+            SubmitRecords(writer, &varctrl[i]);
+        }
+    }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&writer->mutex);
+    writer->done = 1;
+    pthread_cond_signal(&writer->not_empty);
+    pthread_mutex_unlock(&writer->mutex);
+
+    pthread_join(writer->thread, NULL);
+
+    pthread_mutex_destroy(&writer->mutex);
+    pthread_cond_destroy(&writer->not_empty);
+    pthread_cond_destroy(&writer->not_full);
+#endif
+
+    for (i = 0; i < nprint; i++)
+    {
+        free(varctrl[i].recbuf);
+    }
+}
+
+// Write pending records of the active writers owned by the calling thread. Called when the model exits with an error,
+// so that binary output files end at the same time as text output files. Writers of model instances advanced by other
+// threads (e.g., other ensemble members) are skipped, because their record batches are being filled concurrently. A
+// writer thread that exits with an error owns no writers
+void SyncOwnedWriters(void)
+{
+    writer_struct  *writer;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_lock(&active_mutex);
+#endif
+    for (writer = active_writers; writer != NULL; writer = writer->next)
+    {
+#if !defined(_WIN32) && !defined(_WIN64)
+        if (!pthread_equal(writer->owner, pthread_self()))
+        {
+            continue;
+        }
+#endif
+        SyncWriter(writer->nprint, writer->varctrl, writer);
+    }
+#if !defined(_WIN32) && !defined(_WIN64)
+    pthread_mutex_unlock(&active_mutex);
+#endif
+}